@@ -0,0 +1,188 @@
+#include "AutoBatch.h"
+#include "BatchUtil.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+    struct FetchItem {
+        std::wstring imagePath;
+        PdbIdentity identity;
+    };
+
+    struct ParseItem {
+        std::wstring imagePath;
+        PdbIdentity identity;
+        std::wstring pdbPath;
+    };
+}
+
+AutoBatchStats AutoBatchProcessor::ProcessDirectory(const std::wstring& directory, const AutoBatchOptions& options) {
+    std::filesystem::create_directories(options.outputDir);
+
+    AutoBatchStats stats;
+    stats.fetchThreads = (std::max<size_t>)(1, options.fetchThreads);
+    stats.parseThreads = options.parseThreads ? options.parseThreads : std::thread::hardware_concurrency();
+    stats.parseThreads = (std::max<size_t>)(1, stats.parseThreads);
+
+    BoundedQueue<FetchItem> fetchQueue(options.queueDepth);
+    BoundedQueue<ParseItem> parseQueue(options.queueDepth);
+
+    std::atomic<size_t> imagesScanned{ 0 }, withoutIdentity{ 0 }, duplicates{ 0 };
+    std::atomic<size_t> storeHits{ 0 }, downloaded{ 0 }, fetchFailed{ 0 };
+    std::atomic<size_t> exported{ 0 }, parseFailed{ 0 };
+    std::atomic<uint64_t> scanUs{ 0 }, fetchUs{ 0 }, parseUs{ 0 };
+    std::atomic<size_t> activeFetchers{ stats.fetchThreads };
+    std::mutex outputLock;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Busy time is measured around the work only, so time spent blocked on a full or empty queue
+    // does not count against a stage.
+    std::thread scanner([&]() {
+        std::unordered_set<std::string> seen;
+        std::error_code error;
+
+        for (std::filesystem::recursive_directory_iterator it(directory,
+            std::filesystem::directory_options::skip_permission_denied, error), end;
+            !error && it != end; it.increment(error)) {
+            if (!it->is_regular_file(error) || !IsImageFile(it->path())) continue;
+
+            auto scanStart = std::chrono::steady_clock::now();
+            auto identity = PdbDownloader::ReadPdbIdentity(it->path().wstring());
+            scanUs += ElapsedUs(scanStart);
+            imagesScanned++;
+
+            if (!identity) {
+                withoutIdentity++;
+                continue;
+            }
+
+            if (!seen.insert(identity->pdbName + "/" + identity->guidAge).second) {
+                duplicates++;
+                continue;
+            }
+
+            if (!fetchQueue.Push({ it->path().wstring(), std::move(*identity) })) break;
+        }
+
+        fetchQueue.Close();
+        });
+
+    std::vector<std::thread> fetchers;
+    for (size_t t = 0; t < stats.fetchThreads; ++t) {
+        fetchers.emplace_back([&]() {
+            while (auto item = fetchQueue.Pop()) {
+                auto fetchStart = std::chrono::steady_clock::now();
+                std::error_code error;
+                bool cached = std::filesystem::exists(PdbDownloader::GetStorePath(item->identity, options.server), error);
+                auto pdbPath = PdbDownloader::FetchPdb(item->identity, options.server);
+                fetchUs += ElapsedUs(fetchStart);
+
+                if (!pdbPath) {
+                    fetchFailed++;
+                    std::lock_guard<std::mutex> lock(outputLock);
+                    std::wcout << L"Fetch failed: " << item->imagePath << L" ("
+                        << std::wstring(item->identity.pdbName.begin(), item->identity.pdbName.end()) << L")\n";
+                    continue;
+                }
+
+                (cached ? storeHits : downloaded)++;
+                parseQueue.Push({ std::move(item->imagePath), std::move(item->identity), std::move(*pdbPath) });
+            }
+
+            if (--activeFetchers == 0) {
+                parseQueue.Close();
+            }
+            });
+    }
+
+    std::vector<std::thread> parsers;
+    for (size_t t = 0; t < stats.parseThreads; ++t) {
+        parsers.emplace_back([&]() {
+            while (auto item = parseQueue.Pop()) {
+                auto parseStart = std::chrono::steady_clock::now();
+
+                std::wstring stem = std::filesystem::path(item->pdbPath).stem().wstring();
+                std::wstring guidAge(item->identity.guidAge.begin(), item->identity.guidAge.end());
+                std::wstring outputFile = (std::filesystem::path(options.outputDir) /
+                    (stem + L"_" + guidAge + L".ndjson")).wstring();
+
+                bool success = false;
+                try {
+                    PdbParser parser(item->pdbPath);
+                    success = parser.IsInitialized() && parser.ExportNdjson(outputFile);
+                }
+                catch (...) {
+                }
+
+                parseUs += ElapsedUs(parseStart);
+                (success ? exported : parseFailed)++;
+
+                std::lock_guard<std::mutex> lock(outputLock);
+                std::wcout << (success ? L"Exported: " : L"Failed to parse: ")
+                    << (success ? outputFile : item->pdbPath) << L"\n";
+            }
+            });
+    }
+
+    scanner.join();
+    for (auto& fetcher : fetchers) fetcher.join();
+    for (auto& parser : parsers) parser.join();
+
+    stats.wallUs = ElapsedUs(start);
+    stats.imagesScanned = imagesScanned;
+    stats.withoutIdentity = withoutIdentity;
+    stats.duplicates = duplicates;
+    stats.storeHits = storeHits;
+    stats.downloaded = downloaded;
+    stats.fetchFailed = fetchFailed;
+    stats.exported = exported;
+    stats.parseFailed = parseFailed;
+    stats.scanUs = scanUs;
+    stats.fetchUs = fetchUs;
+    stats.parseUs = parseUs;
+
+    return stats;
+}
+
+void AutoBatchProcessor::PrintStats(const AutoBatchStats& stats) {
+    struct StageTime {
+        const char* name;
+        uint64_t busyUs;
+        size_t threads;
+    };
+
+    const StageTime stages[] = {
+        { "scan", stats.scanUs, 1 },
+        { "fetch", stats.fetchUs, stats.fetchThreads },
+        { "parse", stats.parseUs, stats.parseThreads }
+    };
+
+    std::cout << "\nImages scanned:   " << stats.imagesScanned << " (" << stats.withoutIdentity
+        << " without CodeView record, " << stats.duplicates << " sharing a PDB)\n";
+    std::cout << "PDBs from store:  " << stats.storeHits << "\n";
+    std::cout << "PDBs downloaded:  " << stats.downloaded << "\n";
+    std::cout << "Fetch failures:   " << stats.fetchFailed << "\n";
+    std::cout << "PDBs exported:    " << stats.exported << "\n";
+    std::cout << "Parse failures:   " << stats.parseFailed << "\n\n";
+
+    // Busy time divided by the stage's thread count approximates how long that stage alone would
+    // have taken; with the stages overlapped, the wall time should track the largest of these.
+    const StageTime* slowest = &stages[0];
+    for (const auto& stage : stages) {
+        std::cout << "Stage " << stage.name << ": " << stage.busyUs / 1000 << "ms busy across "
+            << stage.threads << " thread(s), ~" << stage.busyUs / stage.threads / 1000 << "ms per thread\n";
+        if (stage.busyUs / stage.threads > slowest->busyUs / slowest->threads) {
+            slowest = &stage;
+        }
+    }
+
+    std::cout << "Wall time: " << stats.wallUs / 1000 << "ms (bottleneck: " << slowest->name << ")\n";
+}
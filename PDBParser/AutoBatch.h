@@ -0,0 +1,37 @@
+#pragma once
+#include "PdbParser.h"
+#include <string>
+
+struct AutoBatchOptions {
+    SymbolServerConfig server;
+    std::wstring outputDir = L"auto_batch_output";
+    size_t fetchThreads = 8;
+    size_t parseThreads = 0;
+    size_t queueDepth = 64;
+};
+
+struct AutoBatchStats {
+    size_t imagesScanned = 0;
+    size_t withoutIdentity = 0;
+    size_t duplicates = 0;
+    size_t storeHits = 0;
+    size_t downloaded = 0;
+    size_t fetchFailed = 0;
+    size_t exported = 0;
+    size_t parseFailed = 0;
+    size_t fetchThreads = 0;
+    size_t parseThreads = 0;
+    uint64_t scanUs = 0;
+    uint64_t fetchUs = 0;
+    uint64_t parseUs = 0;
+    uint64_t wallUs = 0;
+};
+
+// Symbol refresh for a whole directory of images. PE identity scanning, symbol server fetches and
+// parse/export run as separate stages joined by bounded queues, so downloads overlap with parsing
+// and the run takes about as long as its slowest stage rather than the sum of all three.
+class AutoBatchProcessor {
+public:
+    static AutoBatchStats ProcessDirectory(const std::wstring& directory, const AutoBatchOptions& options);
+    static void PrintStats(const AutoBatchStats& stats);
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cwctype>
+#include <filesystem>
+#include <string>
+
+// Helpers shared by the modes that sweep a directory of PDBs or images.
+inline std::wstring GetLowerExtension(const std::filesystem::path& path) {
+    std::wstring extension = path.extension().wstring();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+    return extension;
+}
+
+inline bool IsPdbFile(const std::filesystem::path& path) {
+    return GetLowerExtension(path) == L".pdb";
+}
+
+inline bool IsImageFile(const std::filesystem::path& path) {
+    std::wstring extension = GetLowerExtension(path);
+    return extension == L".exe" || extension == L".dll" || extension == L".sys";
+}
+
+inline uint64_t ElapsedUs(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
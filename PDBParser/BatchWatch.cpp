@@ -0,0 +1,264 @@
+#include "BatchWatch.h"
+#include "BatchUtil.h"
+#include "MsfReader.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+    const char ManifestHeader[] = "# PDBParser watch manifest 1";
+}
+
+BatchWatcher::BatchWatcher(const std::wstring& directory, const BatchWatchOptions& options)
+    : m_directory(directory), m_options(options),
+    m_manifestPath((std::filesystem::path(options.outputDir) / L"watch.manifest").wstring()) {
+}
+
+// One entry per line: size, write time, GUID+age (- if unreadable), 1 if processed, then the path.
+// Later lines replace earlier ones for the same path; a torn last line is ignored.
+void BatchWatcher::LoadManifest() {
+    std::ifstream file(m_manifestPath);
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line) || line != ManifestHeader) return;
+
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        ManifestEntry entry;
+        std::string signature;
+        int processed = 0;
+        if (!(fields >> entry.fileSize >> entry.lastWriteTime >> signature >> processed) || fields.get() != '\t') continue;
+
+        std::string path;
+        if (!std::getline(fields, path) || path.empty()) continue;
+
+        entry.signature = signature == "-" ? std::string() : signature;
+        entry.processed = processed != 0;
+        m_manifest[path] = std::move(entry);
+    }
+
+    for (const auto& [path, entry] : m_manifest) {
+        if (entry.processed && !entry.signature.empty()) m_pathBySignature.emplace(entry.signature, path);
+    }
+}
+
+bool BatchWatcher::CompactManifest() const {
+    std::wstring tempPath = m_manifestPath + L".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file << ManifestHeader << "\n";
+        for (const auto& [path, entry] : m_manifest) {
+            file << entry.fileSize << '\t' << entry.lastWriteTime << '\t'
+                << (entry.signature.empty() ? "-" : entry.signature) << '\t' << (entry.processed ? 1 : 0) << '\t' << path << "\n";
+        }
+        if (file.fail()) return false;
+    }
+
+    if (!MoveFileExW(tempPath.c_str(), m_manifestPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileW(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void BatchWatcher::Record(const std::string& key, const ManifestEntry& entry) {
+    m_manifest[key] = entry;
+    if (entry.processed && !entry.signature.empty()) m_pathBySignature[entry.signature] = key;
+
+    m_journal << entry.fileSize << '\t' << entry.lastWriteTime << '\t'
+        << (entry.signature.empty() ? "-" : entry.signature) << '\t' << (entry.processed ? 1 : 0) << '\t' << key << "\n";
+    m_journal.flush();
+}
+
+bool BatchWatcher::IsKnownBuild(const std::string& signature) const {
+    auto indexed = m_pathBySignature.find(signature);
+    if (indexed == m_pathBySignature.end()) return false;
+
+    auto known = m_manifest.find(indexed->second);
+    return known != m_manifest.end() && known->second.processed && known->second.signature == signature;
+}
+
+void BatchWatcher::Scan() {
+    m_stats.scans++;
+
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(m_directory, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_regular_file(error) && IsPdbFile(it->path())) {
+            Queue(it->path().wstring());
+        }
+    }
+}
+
+void BatchWatcher::Queue(const std::wstring& path) {
+    std::string key = WStringToString(path);
+
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(path, error);
+    auto writeTime = std::filesystem::last_write_time(path, error);
+    if (error) {
+        // Deleted or renamed away before it settled.
+        m_pending.erase(key);
+        return;
+    }
+    uint64_t lastWriteTime = static_cast<uint64_t>(writeTime.time_since_epoch().count());
+
+    auto known = m_manifest.find(key);
+    if (known != m_manifest.end() && known->second.fileSize == fileSize && known->second.lastWriteTime == lastWriteTime) {
+        m_pending.erase(key);
+        return;
+    }
+
+    auto it = m_pending.find(key);
+    if (it != m_pending.end() && it->second.fileSize == fileSize && it->second.lastWriteTime == lastWriteTime) return;
+
+    // A file last written longer ago than the debounce interval has already settled.
+    const std::chrono::milliseconds debounce(m_options.debounceMs);
+    auto now = std::chrono::steady_clock::now();
+    bool settled = std::filesystem::file_time_type::clock::now() - writeTime >= debounce;
+    m_pending[key] = { path, fileSize, lastWriteTime, settled ? now - debounce : now };
+}
+
+void BatchWatcher::ProcessReady() {
+    const std::chrono::milliseconds debounce(m_options.debounceMs);
+
+    std::vector<std::string> ready;
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& [key, pending] : m_pending) {
+        if (now - pending.stableSince >= debounce) ready.push_back(key);
+    }
+    std::sort(ready.begin(), ready.end());
+
+    for (const auto& key : ready) {
+        // A writer may have touched the file since the last notification; that restarts its wait.
+        Queue(m_pending[key].path);
+        auto it = m_pending.find(key);
+        if (it == m_pending.end() || std::chrono::steady_clock::now() - it->second.stableSince < debounce) continue;
+
+        PendingFile file = std::move(it->second);
+        m_pending.erase(it);
+
+        ManifestEntry entry;
+        entry.fileSize = file.fileSize;
+        entry.lastWriteTime = file.lastWriteTime;
+        try {
+            MsfReader msf(file.path);
+            if (auto signature = PdbSignature::Read(msf)) entry.signature = signature->ToString();
+        }
+        catch (...) {
+        }
+
+        // Touched, or copied in from another path, but the same build: the earlier output still describes it.
+        if (!entry.signature.empty() && IsKnownBuild(entry.signature)) {
+            entry.processed = true;
+            m_stats.unchanged++;
+        }
+        else {
+            entry.processed = !entry.signature.empty() && BatchProcessor::ProcessPdb(file.path, m_options.outputDir);
+            if (entry.processed) m_stats.processed++;
+            else m_stats.failed++;
+        }
+
+        Record(key, entry);
+    }
+}
+
+std::chrono::milliseconds BatchWatcher::NextWait() const {
+    const std::chrono::milliseconds debounce(m_options.debounceMs);
+    auto now = std::chrono::steady_clock::now();
+
+    std::chrono::milliseconds wait = debounce;
+    for (const auto& [key, pending] : m_pending) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(pending.stableSince + debounce - now);
+        wait = (std::min)(wait, remaining);
+    }
+    return (std::max)(wait, std::chrono::milliseconds(10));
+}
+
+BatchWatchStats BatchWatcher::Run() {
+    std::filesystem::create_directories(m_options.outputDir);
+
+    LoadManifest();
+    m_stats.fromManifest = m_manifest.size();
+    CompactManifest();
+    m_journal.open(m_manifestPath, std::ios::app);
+
+    Scan();
+
+    if (m_options.once) {
+        for (ProcessReady(); !m_pending.empty(); ProcessReady()) {
+            std::this_thread::sleep_for(NextWait());
+        }
+        return m_stats;
+    }
+
+    HANDLE directory = CreateFileW(m_directory.c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (directory == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open directory for change notifications");
+    }
+
+    HANDLE event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = event;
+
+    // DWORD-aligned as ReadDirectoryChangesW requires; 64 KB is the most a network share delivers.
+    std::vector<DWORD> buffer(64 * 1024 / sizeof(DWORD));
+    const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+    auto arm = [&]() {
+        ResetEvent(event);
+        return ReadDirectoryChangesW(directory, buffer.data(), static_cast<DWORD>(buffer.size() * sizeof(DWORD)),
+            FALSE, filter, nullptr, &overlapped, nullptr) != FALSE;
+    };
+
+    // File systems without change notifications are polled with a rescan every debounce interval.
+    bool armed = arm();
+
+    for (;;) {
+        ProcessReady();
+
+        if (!armed) {
+            std::this_thread::sleep_for(m_pending.empty() ? std::chrono::milliseconds(m_options.debounceMs) : NextWait());
+            Scan();
+            continue;
+        }
+
+        DWORD timeout = m_pending.empty() ? INFINITE : static_cast<DWORD>(NextWait().count());
+        if (WaitForSingleObject(event, timeout) != WAIT_OBJECT_0) continue;
+
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(directory, &overlapped, &bytes, FALSE) || bytes == 0) {
+            // The notification buffer overflowed and the individual changes are lost.
+            Scan();
+        }
+        else {
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer.data());
+            for (DWORD offset = 0;;) {
+                const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(data + offset);
+                std::filesystem::path path = std::filesystem::path(m_directory) /
+                    std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                if (IsPdbFile(path)) {
+                    Queue(path.wstring());
+                }
+
+                if (info->NextEntryOffset == 0) break;
+                offset += info->NextEntryOffset;
+            }
+        }
+
+        armed = arm();
+    }
+}
+
+void BatchWatcher::PrintStats(const BatchWatchStats& stats) {
+    std::cout << "Processed:      " << stats.processed << " (" << stats.failed << " failed)\n";
+    std::cout << "Unchanged:      " << stats.unchanged << " (same GUID+age as already processed)\n";
+    std::cout << "From manifest:  " << stats.fromManifest << " files recorded by earlier runs\n";
+    std::cout << "Directory scans: " << stats.scans << "\n";
+}
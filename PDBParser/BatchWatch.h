@@ -0,0 +1,73 @@
+#pragma once
+#include "PdbParser.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+struct BatchWatchOptions {
+    std::wstring outputDir = L"batch_output";
+    uint32_t debounceMs = 2000;
+    // Process what is new or changed, then return instead of waiting for more.
+    bool once = false;
+};
+
+struct BatchWatchStats {
+    size_t processed = 0;
+    size_t failed = 0;
+    size_t unchanged = 0;
+    size_t fromManifest = 0;
+    size_t scans = 0;
+};
+
+// Keeps a directory's *.pdb files processed as BatchProcessor would, touching only new or changed
+// files. A manifest in the output directory records each file's size, write time and GUID+age; a
+// line is appended as each file finishes and the manifest is compacted on start, so a restart
+// resumes where the last run stopped. A file is taken only once its size and write time have held
+// still for the debounce interval, and a new or changed file whose GUID+age is already in the
+// manifest, at this path or any other, is recorded without being parsed again.
+class BatchWatcher {
+private:
+    struct ManifestEntry {
+        uint64_t fileSize = 0;
+        uint64_t lastWriteTime = 0;
+        std::string signature;
+        bool processed = false;
+    };
+
+    struct PendingFile {
+        std::wstring path;
+        uint64_t fileSize = 0;
+        uint64_t lastWriteTime = 0;
+        std::chrono::steady_clock::time_point stableSince;
+    };
+
+    std::wstring m_directory;
+    BatchWatchOptions m_options;
+    std::wstring m_manifestPath;
+    std::unordered_map<std::string, ManifestEntry> m_manifest;
+    // GUID+age of each processed entry to its manifest path; checked against m_manifest on lookup,
+    // since that path may since have been rewritten with another build.
+    std::unordered_map<std::string, std::string> m_pathBySignature;
+    std::unordered_map<std::string, PendingFile> m_pending;
+    BatchWatchStats m_stats;
+    std::ofstream m_journal;
+
+    void LoadManifest();
+    bool CompactManifest() const;
+    void Record(const std::string& key, const ManifestEntry& entry);
+    bool IsKnownBuild(const std::string& signature) const;
+    void Scan();
+    void Queue(const std::wstring& path);
+    void ProcessReady();
+    std::chrono::milliseconds NextWait() const;
+
+public:
+    BatchWatcher(const std::wstring& directory, const BatchWatchOptions& options);
+
+    // Processes files as they settle until the process is stopped; with options.once it returns as
+    // soon as nothing is pending.
+    BatchWatchStats Run();
+    static void PrintStats(const BatchWatchStats& stats);
+};
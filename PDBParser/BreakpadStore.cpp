@@ -0,0 +1,94 @@
+#include "BreakpadStore.h"
+#include "BatchUtil.h"
+#include "PdbParser.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Writes to a temporary file first so an interrupted run never leaves a truncated .sym behind.
+    bool ConvertPdb(const std::wstring& pdbPath, const std::filesystem::path& outputDirectory, uint64_t& outputBytes) {
+        PdbParser parser(pdbPath);
+        auto identity = parser.GetIdentity();
+        if (!identity) return false;
+
+        std::filesystem::path directory = outputDirectory / std::filesystem::path(pdbPath).filename() /
+            std::wstring(identity->guidAge.begin(), identity->guidAge.end());
+        std::filesystem::create_directories(directory);
+
+        std::wstring symbolPath = (directory / std::filesystem::path(pdbPath).stem()).wstring() + L".sym";
+        std::wstring tempPath = symbolPath + L".tmp";
+
+        bool written = false;
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            written = file.is_open() && parser.StreamToBreakpad(file);
+        }
+
+        if (!written || !MoveFileExW(tempPath.c_str(), symbolPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+            return false;
+        }
+
+        outputBytes = std::filesystem::file_size(symbolPath);
+        return true;
+    }
+}
+
+BreakpadStoreStats BreakpadStoreConverter::Convert(const std::wstring& storeDirectory, const std::wstring& outputDirectory,
+    const BreakpadStoreOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    BreakpadStoreStats stats;
+
+    std::vector<std::wstring> found;
+    std::error_code error;
+    for (std::filesystem::recursive_directory_iterator it(storeDirectory,
+        std::filesystem::directory_options::skip_permission_denied, error), end;
+        !error && it != end; it.increment(error)) {
+        if (it->is_regular_file(error) && IsPdbFile(it->path())) {
+            found.push_back(it->path().wstring());
+        }
+    }
+    stats.pdbsFound = found.size();
+
+    stats.threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+    stats.threads = (std::max<size_t>)(1, (std::min)(stats.threads, found.size()));
+
+    std::atomic<size_t> converted{ 0 }, failed{ 0 };
+    std::atomic<uint64_t> outputBytes{ 0 };
+
+    RunParallel(found.size(), stats.threads, [&](size_t i) {
+        try {
+            uint64_t bytes = 0;
+            if (ConvertPdb(found[i], outputDirectory, bytes)) {
+                converted++;
+                outputBytes += bytes;
+                return;
+            }
+        }
+        catch (...) {
+        }
+        failed++;
+        });
+
+    stats.converted = converted;
+    stats.failed = failed;
+    stats.outputBytes = outputBytes;
+    stats.wallUs = ElapsedUs(start);
+    return stats;
+}
+
+void BreakpadStoreConverter::PrintStats(const BreakpadStoreStats& stats) {
+    std::cout << "PDBs found:     " << stats.pdbsFound << "\n";
+    std::cout << "Converted:      " << stats.converted << "\n";
+    std::cout << "Failed:         " << stats.failed << "\n";
+    std::cout << "Worker threads: " << stats.threads << "\n";
+    std::cout << "Output size:    " << stats.outputBytes / 1024 << "KB\n";
+    std::cout << "Wall time:      " << stats.wallUs / 1000 << "ms\n";
+}
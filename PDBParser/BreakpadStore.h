@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+struct BreakpadStoreOptions {
+    size_t threads = 0;
+};
+
+struct BreakpadStoreStats {
+    size_t pdbsFound = 0;
+    size_t converted = 0;
+    size_t failed = 0;
+    size_t threads = 0;
+    uint64_t outputBytes = 0;
+    uint64_t wallUs = 0;
+};
+
+// Converts every *.pdb under a directory to a Breakpad symbol file, laid out as
+// <output>\<pdb name>\<GUID+age>\<pdb stem>.sym where Breakpad's symbol suppliers look for it.
+// Several PDBs convert at once; each streams its records straight to disk, so memory use depends on
+// the worker count rather than on the size of the store.
+class BreakpadStoreConverter {
+public:
+    static BreakpadStoreStats Convert(const std::wstring& storeDirectory, const std::wstring& outputDirectory,
+        const BreakpadStoreOptions& options);
+    static void PrintStats(const BreakpadStoreStats& stats);
+};
@@ -0,0 +1,221 @@
+#include "ClassHierarchy.h"
+#include <algorithm>
+#include <deque>
+
+namespace {
+    bool IsDestructor(const std::string& name) noexcept {
+        return !name.empty() && name[0] == '~';
+    }
+}
+
+ClassHierarchy::ClassHierarchy(std::vector<ClassRecord> records) {
+    // Nodes are reserved up front so the name index can point into them; the first definition of a
+    // name wins, as it does for struct lookups.
+    std::vector<uint32_t> recordOfClass;
+    m_classes.reserve(records.size());
+    recordOfClass.reserve(records.size());
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (records[i].name.empty() || m_classesByName.count(records[i].name)) continue;
+
+        m_classes.push_back({ std::move(records[i].name), records[i].size, 0, 0, 0, 0, 0, 0 });
+        m_classesByName.emplace(m_classes.back().name, static_cast<uint32_t>(m_classes.size() - 1));
+        recordOfClass.push_back(static_cast<uint32_t>(i));
+    }
+
+    const uint32_t classCount = static_cast<uint32_t>(m_classes.size());
+    std::vector<uint32_t> derivedCounts(classCount, 0);
+
+    for (uint32_t id = 0; id < classCount; ++id) {
+        ClassNode& node = m_classes[id];
+        node.firstBase = static_cast<uint32_t>(m_bases.size());
+
+        for (const auto& base : records[recordOfClass[id]].bases) {
+            auto it = m_classesByName.find(base.name);
+            if (it == m_classesByName.end() || it->second == id) continue;
+
+            m_bases.push_back({ it->second, base.offset, base.isVirtual, base.isIndirect, base.vbptrOffset, base.vbtableIndex });
+            if (!base.isIndirect) derivedCounts[it->second]++;
+        }
+        node.baseCount = static_cast<uint32_t>(m_bases.size()) - node.firstBase;
+    }
+
+    // Reverse edges laid out by counting sort: each class's subclasses end up contiguous and in id order.
+    uint32_t position = 0;
+    for (uint32_t id = 0; id < classCount; ++id) {
+        m_classes[id].firstDerived = position;
+        position += derivedCounts[id];
+    }
+    m_derived.resize(position);
+
+    for (uint32_t id = 0; id < classCount; ++id) {
+        size_t count = 0;
+        const ClassBase* bases = GetBases(id, count);
+        for (size_t i = 0; i < count; ++i) {
+            if (bases[i].isIndirect) continue;
+            ClassNode& base = m_classes[bases[i].classId];
+            m_derived[base.firstDerived + base.derivedCount++] = id;
+        }
+    }
+
+    // Vtables are built bases-first so every class copies finished base tables. The walk is iterative
+    // and skips back edges, so malformed or cyclic input cannot recurse without bound.
+    std::unordered_map<std::string, uint32_t> methodIndex;
+    std::vector<uint8_t> state(classCount, 0);
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+
+    for (uint32_t root = 0; root < classCount; ++root) {
+        if (state[root] != 0) continue;
+        stack.push_back({ root, 0 });
+        state[root] = 1;
+
+        while (!stack.empty()) {
+            auto& [id, nextBase] = stack.back();
+            const ClassNode& node = m_classes[id];
+
+            if (nextBase < node.baseCount) {
+                uint32_t baseId = m_bases[node.firstBase + nextBase++].classId;
+                if (state[baseId] == 0) {
+                    state[baseId] = 1;
+                    stack.push_back({ baseId, 0 });
+                }
+                continue;
+            }
+
+            uint32_t finished = id;
+            stack.pop_back();
+            BuildVtable(finished, records[recordOfClass[finished]], methodIndex);
+            state[finished] = 2;
+        }
+    }
+}
+
+uint32_t ClassHierarchy::InternMethod(const std::string& name, std::unordered_map<std::string, uint32_t>& index) {
+    auto it = index.find(name);
+    if (it != index.end()) return it->second;
+
+    uint32_t method = static_cast<uint32_t>(m_methodNames.size());
+    m_methodNames.push_back(name);
+    index.emplace(name, method);
+    return method;
+}
+
+void ClassHierarchy::BuildVtable(uint32_t classId, const ClassRecord& record,
+    std::unordered_map<std::string, uint32_t>& methodIndex) {
+    std::vector<VirtualSlot> table;
+
+    size_t baseCount = 0;
+    const ClassBase* bases = GetBases(classId, baseCount);
+    for (size_t i = 0; i < baseCount; ++i) {
+        if (bases[i].isVirtual) continue;
+
+        size_t slotCount = 0;
+        const VirtualSlot* slots = GetVtable(bases[i].classId, slotCount);
+        for (size_t j = 0; j < slotCount; ++j) {
+            VirtualSlot slot = slots[j];
+            slot.vftableOffset += bases[i].offset;
+            table.push_back(slot);
+        }
+    }
+
+    for (const auto& method : record.virtualMethods) {
+        uint32_t methodId = InternMethod(method.name, methodIndex);
+        bool overridden = false;
+
+        // An override replaces the slot in every vftable that inherited it. Destructors match any
+        // inherited destructor, since their names differ per class.
+        if (!method.isIntroducing) {
+            for (auto& entry : table) {
+                bool sameName = IsDestructor(method.name) ? IsDestructor(m_methodNames[entry.method]) : entry.method == methodId;
+                if (!sameName) continue;
+                if (method.signature != 0 && entry.signature != 0 && method.signature != entry.signature) continue;
+                if (method.slot && entry.slot != *method.slot) continue;
+
+                entry.method = methodId;
+                entry.definedBy = classId;
+                entry.isPure = method.isPure;
+                overridden = true;
+            }
+        }
+
+        if (!overridden && method.slot) {
+            table.push_back({ 0, *method.slot, methodId, method.signature, classId, classId, method.isPure });
+        }
+    }
+
+    std::sort(table.begin(), table.end(), [](const VirtualSlot& a, const VirtualSlot& b) {
+        return a.vftableOffset != b.vftableOffset ? a.vftableOffset < b.vftableOffset : a.slot < b.slot;
+        });
+
+    ClassNode& node = m_classes[classId];
+    node.firstSlot = static_cast<uint32_t>(m_slots.size());
+    node.slotCount = static_cast<uint32_t>(table.size());
+    m_slots.insert(m_slots.end(), table.begin(), table.end());
+}
+
+std::optional<uint32_t> ClassHierarchy::FindClass(std::string_view name) const {
+    auto it = m_classesByName.find(name);
+    if (it == m_classesByName.end()) return std::nullopt;
+    return it->second;
+}
+
+const ClassBase* ClassHierarchy::GetBases(uint32_t classId, size_t& count) const noexcept {
+    count = m_classes[classId].baseCount;
+    return m_bases.data() + m_classes[classId].firstBase;
+}
+
+const uint32_t* ClassHierarchy::GetDerived(uint32_t classId, size_t& count) const noexcept {
+    count = m_classes[classId].derivedCount;
+    return m_derived.data() + m_classes[classId].firstDerived;
+}
+
+const VirtualSlot* ClassHierarchy::GetVtable(uint32_t classId, size_t& count) const noexcept {
+    count = m_classes[classId].slotCount;
+    return m_slots.data() + m_classes[classId].firstSlot;
+}
+
+std::vector<uint32_t> ClassHierarchy::GetSubclasses(uint32_t classId) const {
+    std::vector<uint32_t> subclasses;
+    std::vector<bool> visited(m_classes.size(), false);
+    std::deque<uint32_t> pending{ classId };
+    visited[classId] = true;
+
+    while (!pending.empty()) {
+        uint32_t current = pending.front();
+        pending.pop_front();
+
+        size_t count = 0;
+        const uint32_t* derived = GetDerived(current, count);
+        for (size_t i = 0; i < count; ++i) {
+            if (visited[derived[i]]) continue;
+            visited[derived[i]] = true;
+            subclasses.push_back(derived[i]);
+            pending.push_back(derived[i]);
+        }
+    }
+
+    return subclasses;
+}
+
+std::vector<uint32_t> ClassHierarchy::FindOverrides(uint32_t classId, uint32_t slot) const {
+    size_t count = 0;
+    const VirtualSlot* slots = GetVtable(classId, count);
+    const VirtualSlot* target = std::find_if(slots, slots + count,
+        [&](const VirtualSlot& entry) { return entry.vftableOffset == 0 && entry.slot == slot; });
+    if (target == slots + count) return {};
+
+    // The introducing class identifies the slot wherever the subclass placed that vftable.
+    std::vector<uint32_t> overriders;
+    for (uint32_t subclass : GetSubclasses(classId)) {
+        const VirtualSlot* subclassSlots = GetVtable(subclass, count);
+        for (size_t i = 0; i < count; ++i) {
+            const VirtualSlot& entry = subclassSlots[i];
+            if (entry.introducedBy == target->introducedBy && entry.slot == slot && entry.definedBy == subclass) {
+                overriders.push_back(subclass);
+                break;
+            }
+        }
+    }
+
+    return overriders;
+}
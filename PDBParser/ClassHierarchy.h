@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Per-class input to the hierarchy, filled from either the TPI stream or DIA. slot is the vftable
+// index of a method when the reader knows it; overrides without one are matched by name and
+// signature (the argument list type index, 0 if unknown).
+struct ClassBaseRecord {
+    std::string name;
+    uint64_t offset = 0;
+    bool isVirtual = false;
+    bool isIndirect = false;
+    uint64_t vbptrOffset = 0;
+    uint32_t vbtableIndex = 0;
+};
+
+struct ClassMethodRecord {
+    std::string name;
+    uint32_t signature = 0;
+    std::optional<uint32_t> slot;
+    bool isIntroducing = false;
+    bool isPure = false;
+};
+
+struct ClassRecord {
+    std::string name;
+    uint64_t size = 0;
+    std::vector<ClassBaseRecord> bases;
+    std::vector<ClassMethodRecord> virtualMethods;
+};
+
+struct ClassBase {
+    uint32_t classId;
+    uint64_t offset;
+    bool isVirtual;
+    bool isIndirect;
+    uint64_t vbptrOffset;
+    uint32_t vbtableIndex;
+};
+
+// One entry of a class's flattened vftables. vftableOffset is where the vfptr holding the slot sits
+// in the class (0 for the primary vftable); introducedBy names the class that first declared the
+// slot and definedBy the most derived class providing its implementation.
+struct VirtualSlot {
+    uint64_t vftableOffset;
+    uint32_t slot;
+    uint32_t method;
+    uint32_t signature;
+    uint32_t introducedBy;
+    uint32_t definedBy;
+    bool isPure;
+};
+
+struct ClassNode {
+    std::string name;
+    uint64_t size;
+    uint32_t firstBase;
+    uint32_t baseCount;
+    uint32_t firstDerived;
+    uint32_t derivedCount;
+    uint32_t firstSlot;
+    uint32_t slotCount;
+};
+
+// Whole-program inheritance graph. Bases, direct subclasses and vftable slots are stored as
+// contiguous per-class ranges of flat arrays, so walking a class's neighbours touches no map and
+// "all subclasses of X" is a breadth-first walk over the derived ranges. Slots reached only through a
+// virtual base are not listed, since their vfptr has no fixed offset in the derived class.
+class ClassHierarchy {
+private:
+    std::vector<ClassNode> m_classes;
+    std::vector<ClassBase> m_bases;
+    std::vector<uint32_t> m_derived;
+    std::vector<VirtualSlot> m_slots;
+    std::vector<std::string> m_methodNames;
+    std::unordered_map<std::string_view, uint32_t> m_classesByName;
+
+    uint32_t InternMethod(const std::string& name, std::unordered_map<std::string, uint32_t>& index);
+    void BuildVtable(uint32_t classId, const ClassRecord& record, std::unordered_map<std::string, uint32_t>& methodIndex);
+
+public:
+    explicit ClassHierarchy(std::vector<ClassRecord> records);
+
+    ClassHierarchy(const ClassHierarchy&) = delete;
+    ClassHierarchy& operator=(const ClassHierarchy&) = delete;
+
+    size_t GetClassCount() const noexcept { return m_classes.size(); }
+    std::optional<uint32_t> FindClass(std::string_view name) const;
+    const ClassNode& GetClass(uint32_t classId) const { return m_classes[classId]; }
+
+    const ClassBase* GetBases(uint32_t classId, size_t& count) const noexcept;
+    const uint32_t* GetDerived(uint32_t classId, size_t& count) const noexcept;
+    const VirtualSlot* GetVtable(uint32_t classId, size_t& count) const noexcept;
+    const std::string& GetMethodName(const VirtualSlot& slot) const { return m_methodNames[slot.method]; }
+
+    std::vector<uint32_t> GetSubclasses(uint32_t classId) const;
+    std::vector<uint32_t> FindOverrides(uint32_t classId, uint32_t slot) const;
+};
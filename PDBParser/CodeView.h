@@ -0,0 +1,575 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+enum class CodeViewSymbolKind : uint16_t {
+    S_CONSTANT = 0x1107,
+    S_UDT = 0x1108,
+    S_LDATA32 = 0x110C,
+    S_GDATA32 = 0x110D,
+    S_PUB32 = 0x110E,
+    S_LPROC32 = 0x110F,
+    S_GPROC32 = 0x1110,
+    S_LTHREAD32 = 0x1112,
+    S_GTHREAD32 = 0x1113,
+    S_PROCREF = 0x1125,
+    S_LPROCREF = 0x1127
+};
+
+enum class CodeViewLeafKind : uint16_t {
+    LF_VTSHAPE = 0x000A,
+    LF_LABEL = 0x000E,
+    LF_MODIFIER = 0x1001,
+    LF_POINTER = 0x1002,
+    LF_PROCEDURE = 0x1008,
+    LF_MFUNCTION = 0x1009,
+    LF_ARGLIST = 0x1201,
+    LF_FIELDLIST = 0x1203,
+    LF_BITFIELD = 0x1205,
+    LF_METHODLIST = 0x1206,
+    LF_BCLASS = 0x1400,
+    LF_VBCLASS = 0x1401,
+    LF_IVBCLASS = 0x1402,
+    LF_INDEX = 0x1404,
+    LF_VFUNCTAB = 0x1409,
+    LF_FRIENDCLS = 0x140B,
+    LF_VFUNCOFF = 0x140C,
+    LF_ENUMERATE = 0x1502,
+    LF_ARRAY = 0x1503,
+    LF_CLASS = 0x1504,
+    LF_STRUCTURE = 0x1505,
+    LF_UNION = 0x1506,
+    LF_ENUM = 0x1507,
+    LF_FRIENDFCN = 0x150C,
+    LF_MEMBER = 0x150D,
+    LF_STMEMBER = 0x150E,
+    LF_METHOD = 0x150F,
+    LF_NESTTYPE = 0x1510,
+    LF_ONEMETHOD = 0x1511,
+    LF_INTERFACE = 0x1519,
+    LF_VFTABLE = 0x151D
+};
+
+// Variable-length numeric leaf (LF_CHAR ... LF_UQUADWORD, or an inline value below 0x8000).
+struct CodeViewNumeric {
+    uint64_t value;
+};
+
+// The vbase offset of LF_ONEMETHOD, present only for introducing virtual methods.
+struct CodeViewIntroducingOffset {
+    uint32_t value;
+};
+
+namespace CodeView {
+    constexpr uint16_t PropertyForwardRef = 0x0080;
+
+    // Method property bits (2..4) of a member function's attributes.
+    enum class MethodProperty : uint16_t {
+        Vanilla,
+        Virtual,
+        Static,
+        Friend,
+        IntroducingVirtual,
+        PureVirtual,
+        PureIntroducingVirtual
+    };
+
+    constexpr MethodProperty GetMethodProperty(uint16_t attributes) noexcept {
+        return static_cast<MethodProperty>((attributes >> 2) & 7);
+    }
+    constexpr uint32_t FirstNonSimpleType = 0x1000;
+
+    // Bounds-checked reader over one record body. Every Read either fills the field and advances or
+    // fails without touching memory past the end of the record.
+    class Cursor {
+    private:
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_position = 0;
+
+        bool ReadRaw(void* value, size_t size) noexcept {
+            if (size > m_size - m_position) return false;
+            memcpy(value, m_data + m_position, size);
+            m_position += size;
+            return true;
+        }
+
+        template<typename T>
+        bool ReadNumber(uint64_t& value) noexcept {
+            T number{};
+            if (!ReadRaw(&number, sizeof(number))) return false;
+            value = static_cast<uint64_t>(number);
+            return true;
+        }
+
+    public:
+        Cursor(const uint8_t* data, size_t size) noexcept : m_data(data), m_size(size) {}
+
+        size_t GetPosition() const noexcept { return m_position; }
+
+        template<typename Record, typename T>
+        std::enable_if_t<std::is_integral_v<T>, bool> Read(const Record&, T& value) noexcept {
+            return ReadRaw(&value, sizeof(T));
+        }
+
+        template<typename Record>
+        bool Read(const Record&, CodeViewNumeric& numeric) noexcept {
+            uint16_t leaf = 0;
+            if (!ReadRaw(&leaf, sizeof(leaf))) return false;
+            if (leaf < 0x8000) {
+                numeric.value = leaf;
+                return true;
+            }
+
+            switch (leaf) {
+            case 0x8000: return ReadNumber<int8_t>(numeric.value);
+            case 0x8001: return ReadNumber<int16_t>(numeric.value);
+            case 0x8002: return ReadNumber<uint16_t>(numeric.value);
+            case 0x8003: return ReadNumber<int32_t>(numeric.value);
+            case 0x8004: return ReadNumber<uint32_t>(numeric.value);
+            case 0x8009: return ReadNumber<int64_t>(numeric.value);
+            case 0x800A: return ReadNumber<uint64_t>(numeric.value);
+            default: return false;
+            }
+        }
+
+        template<typename Record>
+        bool Read(const Record&, std::string_view& name) noexcept {
+            const char* begin = reinterpret_cast<const char*>(m_data + m_position);
+            const void* terminator = memchr(begin, 0, m_size - m_position);
+            if (!terminator) return false;
+
+            name = std::string_view(begin, static_cast<const char*>(terminator) - begin);
+            m_position += name.size() + 1;
+            return true;
+        }
+
+        template<typename Record>
+        bool Read(const Record& record, CodeViewIntroducingOffset& offset) noexcept {
+            MethodProperty property = GetMethodProperty(record.attributes);
+            offset.value = 0;
+            return (property != MethodProperty::IntroducingVirtual && property != MethodProperty::PureIntroducingVirtual) ||
+                ReadRaw(&offset.value, sizeof(offset.value));
+        }
+    };
+
+    // Decodes a record body field by field in the order of Record::Fields. Returns the number of bytes
+    // consumed, or 0 if the record is truncated.
+    template<typename Record>
+    size_t Decode(const uint8_t* data, size_t size, Record& record) noexcept {
+        Cursor cursor(data, size);
+        bool complete = std::apply([&](auto... fields) {
+            return (cursor.Read(record, record.*fields) && ...);
+            }, Record::Fields);
+
+        return complete ? cursor.GetPosition() : 0;
+    }
+
+    template<typename A, typename B>
+    constexpr bool IsSameField(A a, B b) noexcept {
+        if constexpr (std::is_same_v<A, B>) return a == b;
+        else return false;
+    }
+
+    // Calls func with the address of every field listed in Record::TypeIndices, walking Fields the way
+    // Decode does. Byte is uint8_t when the caller rewrites the indices in place. Returns false if the
+    // record is truncated.
+    template<typename Record, typename Byte, typename Func>
+    bool ForEachTypeIndex(Byte* data, size_t size, const Func& func) {
+        Record record{};
+        Cursor cursor(data, size);
+        return std::apply([&](auto... fields) {
+            return ([&](auto field) {
+                size_t position = cursor.GetPosition();
+                if (!cursor.Read(record, record.*field)) return false;
+
+                bool isTypeIndex = std::apply([&](auto... indices) {
+                    return (IsSameField(field, indices) || ...);
+                    }, Record::TypeIndices);
+                if (isTypeIndex) func(data + position);
+                return true;
+                }(fields) && ...);
+            }, Record::Fields);
+    }
+
+    // Field list members are aligned to 4 bytes with LF_PAD0..LF_PAD15 (0xF0 | count) bytes.
+    inline size_t SkipPadding(const uint8_t* data, size_t size, size_t position) noexcept {
+        if (position < size && data[position] > 0xF0) {
+            return (std::min)(size, position + (data[position] & 0x0F));
+        }
+        return position;
+    }
+
+    template<typename Kind, Kind... Kinds>
+    constexpr uint16_t MinKind() { return (std::min)({ static_cast<uint16_t>(Kinds)... }); }
+
+    template<typename Kind, Kind... Kinds>
+    constexpr uint16_t MaxKind() { return (std::max)({ static_cast<uint16_t>(Kinds)... }); }
+
+    // Jump-table dispatch from a record kind to the decoder generated for its layout. The table is
+    // built at compile time for each visitor type and spans only the kinds actually listed.
+    template<typename... Records>
+    class Dispatcher {
+    private:
+        using KindType = std::common_type_t<decltype(Records::Kind)...>;
+
+        static constexpr uint16_t Base = MinKind<KindType, Records::Kind...>();
+        static constexpr size_t Span = MaxKind<KindType, Records::Kind...>() - Base + 1;
+
+        template<typename Visitor>
+        using Handler = size_t(*)(const uint8_t*, size_t, Visitor&);
+
+        template<typename Record, typename Visitor>
+        static size_t Handle(const uint8_t* data, size_t size, Visitor& visitor) {
+            Record record{};
+            size_t consumed = Decode(data, size, record);
+            if (consumed != 0) {
+                visitor(record);
+            }
+            return consumed;
+        }
+
+        template<typename Visitor>
+        static constexpr std::array<Handler<Visitor>, Span> MakeTable() {
+            std::array<Handler<Visitor>, Span> table{};
+            ((table[static_cast<uint16_t>(Records::Kind) - Base] = &Handle<Records, Visitor>), ...);
+            return table;
+        }
+
+        template<typename Visitor>
+        static constexpr std::array<Handler<Visitor>, Span> Table = MakeTable<Visitor>();
+
+    public:
+        // Returns false for kinds outside the table or truncated records; consumed is the body length
+        // the decoder used, which field list walks need to find the next member.
+        template<typename Visitor>
+        static bool Dispatch(uint16_t kind, const uint8_t* data, size_t size, Visitor& visitor, size_t& consumed) {
+            size_t slot = static_cast<uint16_t>(kind - Base);
+            if (slot >= Span || !Table<Visitor>[slot]) return false;
+
+            consumed = Table<Visitor>[slot](data, size, visitor);
+            return consumed != 0;
+        }
+    };
+}
+
+// Record layouts. Each lists its fields once, in on-disk order after the kind; the decoders and the
+// dispatch tables are generated from these descriptions. TypeIndices names the fields holding type
+// indices, so records can be copied into another type stream with their references renumbered.
+namespace CodeViewRecord {
+    struct Structure {
+        static constexpr auto Kind = CodeViewLeafKind::LF_STRUCTURE;
+        uint16_t count;
+        uint16_t property;
+        uint32_t fieldList;
+        uint32_t derivedList;
+        uint32_t vtableShape;
+        CodeViewNumeric size;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&Structure::count, &Structure::property,
+            &Structure::fieldList, &Structure::derivedList, &Structure::vtableShape, &Structure::size, &Structure::name);
+        static constexpr auto TypeIndices = std::make_tuple(&Structure::fieldList, &Structure::derivedList,
+            &Structure::vtableShape);
+    };
+
+    struct Class : Structure {
+        static constexpr auto Kind = CodeViewLeafKind::LF_CLASS;
+    };
+
+    struct Interface : Structure {
+        static constexpr auto Kind = CodeViewLeafKind::LF_INTERFACE;
+    };
+
+    struct Union {
+        static constexpr auto Kind = CodeViewLeafKind::LF_UNION;
+        uint16_t count;
+        uint16_t property;
+        uint32_t fieldList;
+        CodeViewNumeric size;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&Union::count, &Union::property, &Union::fieldList,
+            &Union::size, &Union::name);
+        static constexpr auto TypeIndices = std::make_tuple(&Union::fieldList);
+    };
+
+    struct Enum {
+        static constexpr auto Kind = CodeViewLeafKind::LF_ENUM;
+        uint16_t count;
+        uint16_t property;
+        uint32_t underlyingType;
+        uint32_t fieldList;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&Enum::count, &Enum::property, &Enum::underlyingType,
+            &Enum::fieldList, &Enum::name);
+        static constexpr auto TypeIndices = std::make_tuple(&Enum::underlyingType, &Enum::fieldList);
+    };
+
+    struct Pointer {
+        static constexpr auto Kind = CodeViewLeafKind::LF_POINTER;
+        uint32_t referentType;
+        uint32_t attributes;
+        static constexpr auto Fields = std::make_tuple(&Pointer::referentType, &Pointer::attributes);
+        static constexpr auto TypeIndices = std::make_tuple(&Pointer::referentType);
+
+        uint32_t GetSize() const noexcept { return (attributes >> 13) & 0x3F; }
+    };
+
+    struct Modifier {
+        static constexpr auto Kind = CodeViewLeafKind::LF_MODIFIER;
+        uint32_t modifiedType;
+        uint16_t modifiers;
+        static constexpr auto Fields = std::make_tuple(&Modifier::modifiedType, &Modifier::modifiers);
+        static constexpr auto TypeIndices = std::make_tuple(&Modifier::modifiedType);
+    };
+
+    struct Array {
+        static constexpr auto Kind = CodeViewLeafKind::LF_ARRAY;
+        uint32_t elementType;
+        uint32_t indexType;
+        CodeViewNumeric size;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&Array::elementType, &Array::indexType, &Array::size, &Array::name);
+        static constexpr auto TypeIndices = std::make_tuple(&Array::elementType, &Array::indexType);
+    };
+
+    struct Bitfield {
+        static constexpr auto Kind = CodeViewLeafKind::LF_BITFIELD;
+        uint32_t type;
+        uint8_t length;
+        uint8_t position;
+        static constexpr auto Fields = std::make_tuple(&Bitfield::type, &Bitfield::length, &Bitfield::position);
+        static constexpr auto TypeIndices = std::make_tuple(&Bitfield::type);
+    };
+
+    struct Procedure {
+        static constexpr auto Kind = CodeViewLeafKind::LF_PROCEDURE;
+        uint32_t returnType;
+        uint8_t callingConvention;
+        uint8_t attributes;
+        uint16_t parameterCount;
+        uint32_t argumentList;
+        static constexpr auto Fields = std::make_tuple(&Procedure::returnType, &Procedure::callingConvention,
+            &Procedure::attributes, &Procedure::parameterCount, &Procedure::argumentList);
+        static constexpr auto TypeIndices = std::make_tuple(&Procedure::returnType, &Procedure::argumentList);
+    };
+
+    // A vftable of a class with its own vfptr layout; the method names that follow are not decoded.
+    struct Vftable {
+        static constexpr auto Kind = CodeViewLeafKind::LF_VFTABLE;
+        uint32_t completeClass;
+        uint32_t overriddenVftable;
+        uint32_t vfptrOffset;
+        uint32_t namesLength;
+        static constexpr auto Fields = std::make_tuple(&Vftable::completeClass, &Vftable::overriddenVftable,
+            &Vftable::vfptrOffset, &Vftable::namesLength);
+        static constexpr auto TypeIndices = std::make_tuple(&Vftable::completeClass, &Vftable::overriddenVftable);
+    };
+
+    struct MemberFunction {
+        static constexpr auto Kind = CodeViewLeafKind::LF_MFUNCTION;
+        uint32_t returnType;
+        uint32_t classType;
+        uint32_t thisType;
+        uint8_t callingConvention;
+        uint8_t attributes;
+        uint16_t parameterCount;
+        uint32_t argumentList;
+        int32_t thisAdjust;
+        static constexpr auto Fields = std::make_tuple(&MemberFunction::returnType, &MemberFunction::classType,
+            &MemberFunction::thisType, &MemberFunction::callingConvention, &MemberFunction::attributes,
+            &MemberFunction::parameterCount, &MemberFunction::argumentList, &MemberFunction::thisAdjust);
+        static constexpr auto TypeIndices = std::make_tuple(&MemberFunction::returnType, &MemberFunction::classType,
+            &MemberFunction::thisType, &MemberFunction::argumentList);
+    };
+
+    // One overload in an LF_METHODLIST body; the list is a plain run of these with no kind prefix.
+    struct MethodListEntry {
+        uint16_t attributes;
+        uint16_t padding;
+        uint32_t type;
+        CodeViewIntroducingOffset vtableOffset;
+        static constexpr auto Fields = std::make_tuple(&MethodListEntry::attributes, &MethodListEntry::padding,
+            &MethodListEntry::type, &MethodListEntry::vtableOffset);
+        static constexpr auto TypeIndices = std::make_tuple(&MethodListEntry::type);
+    };
+
+    // Field list members.
+    struct Member {
+        static constexpr auto Kind = CodeViewLeafKind::LF_MEMBER;
+        uint16_t attributes;
+        uint32_t type;
+        CodeViewNumeric offset;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&Member::attributes, &Member::type, &Member::offset, &Member::name);
+        static constexpr auto TypeIndices = std::make_tuple(&Member::type);
+    };
+
+    struct StaticMember {
+        static constexpr auto Kind = CodeViewLeafKind::LF_STMEMBER;
+        uint16_t attributes;
+        uint32_t type;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&StaticMember::attributes, &StaticMember::type, &StaticMember::name);
+        static constexpr auto TypeIndices = std::make_tuple(&StaticMember::type);
+    };
+
+    struct BaseClass {
+        static constexpr auto Kind = CodeViewLeafKind::LF_BCLASS;
+        uint16_t attributes;
+        uint32_t type;
+        CodeViewNumeric offset;
+        static constexpr auto Fields = std::make_tuple(&BaseClass::attributes, &BaseClass::type, &BaseClass::offset);
+        static constexpr auto TypeIndices = std::make_tuple(&BaseClass::type);
+    };
+
+    struct VirtualBaseClass {
+        static constexpr auto Kind = CodeViewLeafKind::LF_VBCLASS;
+        uint16_t attributes;
+        uint32_t type;
+        uint32_t vbptrType;
+        CodeViewNumeric vbptrOffset;
+        CodeViewNumeric vbtableIndex;
+        static constexpr auto Fields = std::make_tuple(&VirtualBaseClass::attributes, &VirtualBaseClass::type,
+            &VirtualBaseClass::vbptrType, &VirtualBaseClass::vbptrOffset, &VirtualBaseClass::vbtableIndex);
+        static constexpr auto TypeIndices = std::make_tuple(&VirtualBaseClass::type, &VirtualBaseClass::vbptrType);
+    };
+
+    struct IndirectVirtualBaseClass : VirtualBaseClass {
+        static constexpr auto Kind = CodeViewLeafKind::LF_IVBCLASS;
+    };
+
+    struct VirtualFunctionTable {
+        static constexpr auto Kind = CodeViewLeafKind::LF_VFUNCTAB;
+        uint16_t padding;
+        uint32_t type;
+        static constexpr auto Fields = std::make_tuple(&VirtualFunctionTable::padding, &VirtualFunctionTable::type);
+        static constexpr auto TypeIndices = std::make_tuple(&VirtualFunctionTable::type);
+    };
+
+    struct VirtualFunctionOffset {
+        static constexpr auto Kind = CodeViewLeafKind::LF_VFUNCOFF;
+        uint16_t padding;
+        uint32_t type;
+        uint32_t offset;
+        static constexpr auto Fields = std::make_tuple(&VirtualFunctionOffset::padding, &VirtualFunctionOffset::type,
+            &VirtualFunctionOffset::offset);
+        static constexpr auto TypeIndices = std::make_tuple(&VirtualFunctionOffset::type);
+    };
+
+    struct FriendFunction {
+        static constexpr auto Kind = CodeViewLeafKind::LF_FRIENDFCN;
+        uint16_t padding;
+        uint32_t type;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&FriendFunction::padding, &FriendFunction::type, &FriendFunction::name);
+        static constexpr auto TypeIndices = std::make_tuple(&FriendFunction::type);
+    };
+
+    struct FriendClass {
+        static constexpr auto Kind = CodeViewLeafKind::LF_FRIENDCLS;
+        uint16_t padding;
+        uint32_t type;
+        static constexpr auto Fields = std::make_tuple(&FriendClass::padding, &FriendClass::type);
+        static constexpr auto TypeIndices = std::make_tuple(&FriendClass::type);
+    };
+
+    struct OneMethod {
+        static constexpr auto Kind = CodeViewLeafKind::LF_ONEMETHOD;
+        uint16_t attributes;
+        uint32_t type;
+        CodeViewIntroducingOffset vtableOffset;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&OneMethod::attributes, &OneMethod::type,
+            &OneMethod::vtableOffset, &OneMethod::name);
+        static constexpr auto TypeIndices = std::make_tuple(&OneMethod::type);
+    };
+
+    struct Method {
+        static constexpr auto Kind = CodeViewLeafKind::LF_METHOD;
+        uint16_t count;
+        uint32_t methodList;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&Method::count, &Method::methodList, &Method::name);
+        static constexpr auto TypeIndices = std::make_tuple(&Method::methodList);
+    };
+
+    struct NestedType {
+        static constexpr auto Kind = CodeViewLeafKind::LF_NESTTYPE;
+        uint16_t padding;
+        uint32_t type;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&NestedType::padding, &NestedType::type, &NestedType::name);
+        static constexpr auto TypeIndices = std::make_tuple(&NestedType::type);
+    };
+
+    struct Enumerate {
+        static constexpr auto Kind = CodeViewLeafKind::LF_ENUMERATE;
+        uint16_t attributes;
+        CodeViewNumeric value;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&Enumerate::attributes, &Enumerate::value, &Enumerate::name);
+        static constexpr auto TypeIndices = std::make_tuple();
+    };
+
+    struct Index {
+        static constexpr auto Kind = CodeViewLeafKind::LF_INDEX;
+        uint16_t padding;
+        uint32_t continuation;
+        static constexpr auto Fields = std::make_tuple(&Index::padding, &Index::continuation);
+        static constexpr auto TypeIndices = std::make_tuple(&Index::continuation);
+    };
+
+    // Symbol records.
+    struct Public {
+        static constexpr auto Kind = CodeViewSymbolKind::S_PUB32;
+        uint32_t flags;
+        uint32_t offset;
+        uint16_t section;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&Public::flags, &Public::offset, &Public::section, &Public::name);
+        static constexpr auto TypeIndices = std::make_tuple();
+    };
+
+    struct GlobalData {
+        static constexpr auto Kind = CodeViewSymbolKind::S_GDATA32;
+        uint32_t type;
+        uint32_t offset;
+        uint16_t section;
+        std::string_view name;
+        static constexpr auto Fields = std::make_tuple(&GlobalData::type, &GlobalData::offset, &GlobalData::section, &GlobalData::name);
+        static constexpr auto TypeIndices = std::make_tuple(&GlobalData::type);
+    };
+
+    struct LocalData : GlobalData {
+        static constexpr auto Kind = CodeViewSymbolKind::S_LDATA32;
+    };
+
+    struct GlobalThreadData : GlobalData {
+        static constexpr auto Kind = CodeViewSymbolKind::S_GTHREAD32;
+    };
+
+    struct LocalThreadData : GlobalData {
+        static constexpr auto Kind = CodeViewSymbolKind::S_LTHREAD32;
+    };
+}
+
+using CodeViewTypeDispatcher = CodeView::Dispatcher<
+    CodeViewRecord::Structure, CodeViewRecord::Class, CodeViewRecord::Interface, CodeViewRecord::Union,
+    CodeViewRecord::Enum, CodeViewRecord::Pointer, CodeViewRecord::Modifier, CodeViewRecord::Array,
+    CodeViewRecord::Bitfield, CodeViewRecord::Procedure, CodeViewRecord::MemberFunction, CodeViewRecord::Vftable>;
+
+using CodeViewFieldDispatcher = CodeView::Dispatcher<
+    CodeViewRecord::Member, CodeViewRecord::StaticMember, CodeViewRecord::BaseClass,
+    CodeViewRecord::VirtualBaseClass, CodeViewRecord::IndirectVirtualBaseClass,
+    CodeViewRecord::VirtualFunctionTable, CodeViewRecord::VirtualFunctionOffset, CodeViewRecord::FriendFunction,
+    CodeViewRecord::FriendClass, CodeViewRecord::OneMethod, CodeViewRecord::Method, CodeViewRecord::NestedType,
+    CodeViewRecord::Enumerate, CodeViewRecord::Index>;
+
+using CodeViewSymbolDispatcher = CodeView::Dispatcher<
+    CodeViewRecord::Public, CodeViewRecord::GlobalData, CodeViewRecord::LocalData,
+    CodeViewRecord::GlobalThreadData, CodeViewRecord::LocalThreadData>;
@@ -0,0 +1,244 @@
+#include "ColumnarExport.h"
+#include "TableWriter.h"
+#include "Trace.h"
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+size_t ColumnarTable::AddColumn(const std::string& name, ColumnType type) {
+    m_columns.push_back(Column{ name, type, {}, {} });
+    return m_columns.size() - 1;
+}
+
+void ColumnarTable::Append(size_t column, uint64_t value) {
+    auto& col = m_columns[column];
+    if (col.type == ColumnType::UInt64) {
+        col.u64.push_back(value);
+    }
+    else {
+        col.u32.push_back(static_cast<uint32_t>(value));
+    }
+}
+
+uint64_t ColumnarTable::GetRowCount() const noexcept {
+    if (m_columns.empty()) return 0;
+    const auto& col = m_columns.front();
+    return col.type == ColumnType::UInt64 ? col.u64.size() : col.u32.size();
+}
+
+uint32_t StringDictionary::Intern(const std::string& value) {
+    auto it = m_index.find(value);
+    if (it != m_index.end()) {
+        return it->second;
+    }
+
+    uint32_t index = static_cast<uint32_t>(m_values.size());
+    m_values.push_back(value);
+    m_index.emplace(value, index);
+    return index;
+}
+
+static void CopyName(char (&dest)[16], const std::string& name) {
+    memset(dest, 0, sizeof(dest));
+    memcpy(dest, name.c_str(), (std::min)(name.size(), sizeof(dest) - 1));
+}
+
+bool ColumnarExporter::WriteTables(const std::vector<ColumnarTable>& tables, const StringDictionary& dictionary,
+    DWORD machineType, const std::wstring& outputPath) {
+    try {
+        std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        uint64_t position = sizeof(ColumnarFileHeader);
+        for (const auto& table : tables) {
+            position += sizeof(ColumnarTableHeader) + table.GetColumns().size() * sizeof(ColumnarColumnHeader);
+        }
+        position = AlignUp(position);
+
+        std::vector<ColumnarTableHeader> tableHeaders;
+        std::vector<std::vector<ColumnarColumnHeader>> columnHeaders;
+
+        for (const auto& table : tables) {
+            ColumnarTableHeader tableHeader = {};
+            CopyName(tableHeader.name, table.GetName());
+            tableHeader.rowCount = table.GetRowCount();
+            tableHeader.columnCount = static_cast<uint32_t>(table.GetColumns().size());
+            tableHeaders.push_back(tableHeader);
+
+            std::vector<ColumnarColumnHeader> headers;
+            for (const auto& column : table.GetColumns()) {
+                ColumnarColumnHeader columnHeader = {};
+                CopyName(columnHeader.name, column.name);
+                columnHeader.type = column.type;
+                columnHeader.dataOffset = position;
+                columnHeader.dataLength = column.type == ColumnType::UInt64 ?
+                    column.u64.size() * sizeof(uint64_t) : column.u32.size() * sizeof(uint32_t);
+                position = AlignUp(position + columnHeader.dataLength);
+                headers.push_back(columnHeader);
+            }
+            columnHeaders.push_back(std::move(headers));
+        }
+
+        ColumnarFileHeader fileHeader = {};
+        memcpy(fileHeader.magic, "PDBC", 4);
+        fileHeader.version = 1;
+        fileHeader.tableCount = static_cast<uint16_t>(tables.size());
+        fileHeader.machineType = machineType;
+        fileHeader.dictionaryOffset = position;
+
+        file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+        uint64_t written = sizeof(fileHeader);
+
+        for (size_t i = 0; i < tables.size(); ++i) {
+            file.write(reinterpret_cast<const char*>(&tableHeaders[i]), sizeof(ColumnarTableHeader));
+            written += sizeof(ColumnarTableHeader);
+            for (const auto& columnHeader : columnHeaders[i]) {
+                file.write(reinterpret_cast<const char*>(&columnHeader), sizeof(ColumnarColumnHeader));
+                written += sizeof(ColumnarColumnHeader);
+            }
+        }
+        WritePadding(file, written);
+
+        for (const auto& table : tables) {
+            for (const auto& column : table.GetColumns()) {
+                if (column.type == ColumnType::UInt64) {
+                    file.write(reinterpret_cast<const char*>(column.u64.data()),
+                        static_cast<std::streamsize>(column.u64.size() * sizeof(uint64_t)));
+                    written += column.u64.size() * sizeof(uint64_t);
+                }
+                else {
+                    file.write(reinterpret_cast<const char*>(column.u32.data()),
+                        static_cast<std::streamsize>(column.u32.size() * sizeof(uint32_t)));
+                    written += column.u32.size() * sizeof(uint32_t);
+                }
+                WritePadding(file, written);
+            }
+        }
+
+        const auto& values = dictionary.GetValues();
+        uint32_t count = static_cast<uint32_t>(values.size());
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+        uint32_t offset = 0;
+        for (const auto& value : values) {
+            file.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+            offset += static_cast<uint32_t>(value.size());
+        }
+        file.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+
+        for (const auto& value : values) {
+            file.write(value.data(), static_cast<std::streamsize>(value.size()));
+        }
+
+        return file.good();
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+bool ColumnarExporter::Export(const PdbParser& parser, const std::wstring& outputPath) {
+    TraceScope trace(TracePhase::ExportColumnar);
+
+    try {
+        StringDictionary dictionary;
+        std::vector<ColumnarTable> tables;
+
+        ColumnarTable symbolTable("symbols");
+        size_t symName = symbolTable.AddColumn("name", ColumnType::Dictionary);
+        size_t symRva = symbolTable.AddColumn("rva", ColumnType::UInt64);
+        size_t symSize = symbolTable.AddColumn("size", ColumnType::UInt64);
+        size_t symType = symbolTable.AddColumn("type_id", ColumnType::UInt32);
+
+        parser.ForEachPublicSymbol([&](const SymbolInfo& symbol) -> bool {
+            symbolTable.Append(symName, dictionary.Intern(symbol.name));
+            symbolTable.Append(symRva, symbol.rva);
+            symbolTable.Append(symSize, symbol.size);
+            symbolTable.Append(symType, symbol.typeId);
+            return true;
+            });
+
+        ColumnarTable structTable("structs");
+        size_t structName = structTable.AddColumn("name", ColumnType::Dictionary);
+        size_t structSize = structTable.AddColumn("size", ColumnType::UInt64);
+        size_t structFirst = structTable.AddColumn("member_start", ColumnType::UInt32);
+        size_t structCount = structTable.AddColumn("member_count", ColumnType::UInt32);
+        size_t structHashHigh = structTable.AddColumn("layout_hash_hi", ColumnType::UInt64);
+        size_t structHashLow = structTable.AddColumn("layout_hash_lo", ColumnType::UInt64);
+
+        ColumnarTable memberTable("members");
+        size_t memberStruct = memberTable.AddColumn("struct", ColumnType::UInt32);
+        size_t memberName = memberTable.AddColumn("name", ColumnType::Dictionary);
+        size_t memberOffset = memberTable.AddColumn("offset", ColumnType::UInt64);
+        size_t memberSize = memberTable.AddColumn("size", ColumnType::UInt64);
+        size_t memberType = memberTable.AddColumn("type_id", ColumnType::UInt32);
+
+        uint32_t structRow = 0;
+        uint32_t memberRow = 0;
+        const auto& layoutHashes = parser.ComputeLayoutHashes();
+        parser.ForEachStruct([&](const StructInfo& structInfo) -> bool {
+            structTable.Append(structName, dictionary.Intern(structInfo.name));
+            structTable.Append(structSize, structInfo.size);
+            structTable.Append(structFirst, memberRow);
+            structTable.Append(structCount, structInfo.members.size());
+
+            auto hash = layoutHashes.find(structInfo.name);
+            auto layoutHash = hash != layoutHashes.end() ? hash->second : LayoutHash{};
+            structTable.Append(structHashHigh, layoutHash.high);
+            structTable.Append(structHashLow, layoutHash.low);
+
+            for (const auto& member : structInfo.members) {
+                memberTable.Append(memberStruct, structRow);
+                memberTable.Append(memberName, dictionary.Intern(member.name));
+                memberTable.Append(memberOffset, member.offset);
+                memberTable.Append(memberSize, member.size);
+                memberTable.Append(memberType, member.typeId);
+                ++memberRow;
+            }
+            ++structRow;
+            return true;
+            });
+
+        ColumnarTable enumTable("enums");
+        size_t enumName = enumTable.AddColumn("name", ColumnType::Dictionary);
+        size_t enumSize = enumTable.AddColumn("size", ColumnType::UInt64);
+        size_t enumFirst = enumTable.AddColumn("value_start", ColumnType::UInt32);
+        size_t enumCount = enumTable.AddColumn("value_count", ColumnType::UInt32);
+
+        ColumnarTable valueTable("enum_values");
+        size_t valueEnum = valueTable.AddColumn("enum", ColumnType::UInt32);
+        size_t valueName = valueTable.AddColumn("name", ColumnType::Dictionary);
+        size_t valueValue = valueTable.AddColumn("value", ColumnType::UInt64);
+
+        uint32_t enumRow = 0;
+        uint32_t valueRow = 0;
+        parser.ForEachEnum([&](const EnumInfo& enumInfo) -> bool {
+            enumTable.Append(enumName, dictionary.Intern(enumInfo.name));
+            enumTable.Append(enumSize, enumInfo.size);
+            enumTable.Append(enumFirst, valueRow);
+            enumTable.Append(enumCount, enumInfo.values.size());
+
+            for (const auto& value : enumInfo.values) {
+                valueTable.Append(valueEnum, enumRow);
+                valueTable.Append(valueName, dictionary.Intern(value.name));
+                valueTable.Append(valueValue, static_cast<uint64_t>(value.value));
+                ++valueRow;
+            }
+            ++enumRow;
+            return true;
+            });
+
+        Tracer::Count(TraceCounter::RecordsExported, symbolTable.GetRowCount() + structRow + memberRow + enumRow);
+
+        tables.push_back(std::move(symbolTable));
+        tables.push_back(std::move(structTable));
+        tables.push_back(std::move(memberTable));
+        tables.push_back(std::move(enumTable));
+        tables.push_back(std::move(valueTable));
+
+        return WriteTables(tables, dictionary, static_cast<DWORD>(parser.GetMachineType()), outputPath);
+    }
+    catch (...) {
+        return false;
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "PdbParser.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// PDBC columnar export layout (all integers little-endian, every block 8-byte aligned):
+//
+//   ColumnarFileHeader
+//   ColumnarTableHeader[tableCount], each followed by ColumnarColumnHeader[columnCount]
+//   column data blocks
+//   string dictionary: uint32 count, uint32 offsets[count + 1], UTF-8 bytes
+//
+// String columns are dictionary-encoded as uint32 indices into the shared dictionary,
+// which uses the same offsets + data layout as an Arrow variable-size binary array.
+
+enum class ColumnType : uint8_t {
+    UInt32 = 1,
+    UInt64 = 2,
+    Dictionary = 3
+};
+
+#pragma pack(push, 1)
+struct ColumnarFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t tableCount;
+    uint32_t machineType;
+    uint32_t reserved;
+    uint64_t dictionaryOffset;
+};
+
+struct ColumnarTableHeader {
+    char name[16];
+    uint64_t rowCount;
+    uint32_t columnCount;
+    uint32_t reserved;
+};
+
+struct ColumnarColumnHeader {
+    char name[16];
+    ColumnType type;
+    uint8_t reserved[7];
+    uint64_t dataOffset;
+    uint64_t dataLength;
+};
+#pragma pack(pop)
+
+class ColumnarTable {
+public:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        std::vector<uint32_t> u32;
+        std::vector<uint64_t> u64;
+    };
+
+    explicit ColumnarTable(const std::string& name) : m_name(name) {}
+
+    size_t AddColumn(const std::string& name, ColumnType type);
+    void Append(size_t column, uint64_t value);
+
+    const std::string& GetName() const noexcept { return m_name; }
+    const std::vector<Column>& GetColumns() const noexcept { return m_columns; }
+    uint64_t GetRowCount() const noexcept;
+
+private:
+    std::string m_name;
+    std::vector<Column> m_columns;
+};
+
+class StringDictionary {
+public:
+    uint32_t Intern(const std::string& value);
+    const std::vector<std::string>& GetValues() const noexcept { return m_values; }
+
+private:
+    std::unordered_map<std::string, uint32_t> m_index;
+    std::vector<std::string> m_values;
+};
+
+class ColumnarExporter {
+public:
+    static bool Export(const PdbParser& parser, const std::wstring& outputPath);
+    static bool WriteTables(const std::vector<ColumnarTable>& tables, const StringDictionary& dictionary,
+        DWORD machineType, const std::wstring& outputPath);
+};
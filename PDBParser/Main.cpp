@@ -1,30 +1,87 @@
 #include "PdbAnalyzer.h"
+#include "PdbSet.h"
+#include "AutoBatch.h"
+#include "StoreIndex.h"
+#include "BreakpadStore.h"
+#include "Symbolizer.h"
+#include "BatchWatch.h"
+#include "ShardedBatch.h"
+#include "Trace.h"
 #include <iostream>
 #include <filesystem>
 #include <vector>
+#include <chrono>
+#include <cwchar>
 
 void ShowUsage(const char* programName) {
     std::cout << "Advanced PDB Parser - Professional Reverse Engineering Tool\n";
     std::cout << "Usage: " << programName << " <pdb_file> [options]\n";
     std::cout << "       " << programName << " -auto <exe_file> [options]\n";
-    std::cout << "       " << programName << " -diff <old_pdb> <new_pdb> [options]\n";
-    std::cout << "       " << programName << " -batch <directory> [output_dir]\n\n";
+    std::cout << "       " << programName << " -diff <old_pdb> <new_pdb> [-layouts] [-export <file>]\n";
+    std::cout << "       " << programName << " -batch <directory> [output_dir] [-shard <i>/<n>] [-threads <n>]\n";
+    std::cout << "       " << programName << " -merge <output_dir> <shard_dir>...\n";
+    std::cout << "       " << programName << " -watch <directory> [output_dir] [-debounce <ms>] [-once]\n";
+    std::cout << "       " << programName << " -auto-batch <directory> [output_dir] [-fetchers <n>] [-threads <n>]\n";
+    std::cout << "       " << programName << " -set <pdb[@base]>... [-s <name>] [-p <pattern>] [-a <address>]\n";
+    std::cout << "       " << programName << " -index-store <store_dir> <index_file> [-threads <n>]\n";
+    std::cout << "       " << programName << " -index-query <index_file> <name>...\n";
+    std::cout << "       " << programName << " -breakpad-store <store_dir> <output_dir> [-threads <n>]\n";
+    std::cout << "       " << programName << " -symbolize <dump.dmp> [-store <dir>]\n";
+    std::cout << "       " << programName << " -symbolize-batch <directory> [output_dir] [-store <dir>] [-cache-mb <n>]\n\n";
 
     std::cout << "Basic Options:\n";
     std::cout << "  -s <symbol>         Find specific symbol by name\n";
+    std::cout << "  -g <global>         Find typed global/static data (GSI hash lookup)\n";
+    std::cout << "  -gp <pattern>       Search global/static data by regex pattern\n";
     std::cout << "  -t <struct>         Analyze structure layout\n";
     std::cout << "  -m <struct> <member> Find structure member offset\n";
+    std::cout << "  -path <expr>        Compile a field path (_EPROCESS.Pcb.DirectoryTableBase, a[3].b, p->c)\n";
+    std::cout << "  -walk <image[@base]> <head> <Type.Link> <fields|-> Walk a LIST_ENTRY list in a minidump or flat\n";
+    std::cout << "                      memory image and read comma-separated fields of every entry\n";
+    std::cout << "  -f <function>       Show function prototype, frame and locals\n";
+    std::cout << "  -e <enum>           List enum constants\n";
+    std::cout << "  -ev <enum> <value>  Decode a value to its enum name or flag set\n";
+    std::cout << "  -hash <struct>      Show 128-bit layout hash of a structure\n";
+    std::cout << "  -layout-report <n>  Rank the n most wasteful UDTs by holes, padding and cache-line splits (0 = all)\n";
+    std::cout << "  -class <class>      Show base classes, direct subclasses and vftable slots\n";
+    std::cout << "  -subclasses <class> List every class deriving from a class, directly or not\n";
+    std::cout << "  -overrides <class> <slot> List subclasses overriding a slot of the class's primary vftable\n";
     std::cout << "  -p <pattern>        Search symbols by regex pattern\n";
+    std::cout << "  -script <file|->    Run one query per line (-s/-p/-t/-m/-path/-g/-gp/-f/-e/...), batching lookups\n";
+    std::cout << "                      per index and printing results in script order (- for stdin)\n";
     std::cout << "  -l                  List all available structures\n";
     std::cout << "  -perf               Run performance benchmarks\n";
     std::cout << "  -export <file>      Export results to JSON\n";
+    std::cout << "  -export-columnar <file> Export symbols/structs as PDBC columnar binary\n";
+    std::cout << "  -ndjson <file|->    Stream symbols/structs as NDJSON (- for stdout)\n";
+    std::cout << "  -functions <file|-> Decode every function in parallel to NDJSON\n";
+    std::cout << "  -breakpad <file|->  Write a Breakpad .sym file (MODULE/FILE/FUNC/PUBLIC and line records)\n";
+    std::cout << "  -perf-map <file|-> <base> Write a perf map with functions and publics at the given image base\n";
+    std::cout << "  -save-snapshot <file> Save parsed symbols/structs/enums/hashes as a mappable snapshot\n";
+    std::cout << "  -snapshot <file>    Serve later options from a snapshot (rejected if the PDB differs)\n";
+    std::cout << "  -reduce <out> <names> Write a PDB with only the listed publics/globals/UDTs and their types\n";
     std::cout << "  -kernel             Resolve critical kernel symbols\n";
+    std::cout << "  -trace <file>       Write timings, counters and histograms as a Chrome trace\n";
+    std::cout << "  -open <mode>        full (default), publics or types: load only those streams, DIA on demand\n";
     std::cout << "  -full               Complete analysis (default)\n\n";
 
     std::cout << "Advanced Options:\n";
     std::cout << "  -auto <exe>         Download PDB for executable from Microsoft\n";
     std::cout << "  -diff <old> <new>   Compare two PDB files\n";
-    std::cout << "  -batch <dir> [out]  Process all PDBs in directory\n\n";
+    std::cout << "  -batch <dir> [out]  Process all PDBs in directory\n";
+    std::cout << "  -shard <i>/<n>      With -batch: process only shard i of n (by GUID+age hash) into out\\shard-i-of-n\n";
+    std::cout << "  -merge <out> <shard>... Combine shard summaries, indexes and failures into one result\n";
+    std::cout << "  -watch <dir> [out]  Process new or changed PDBs as they arrive, resuming from a manifest\n";
+    std::cout << "  -auto-batch <dir> [out] Fetch and export PDBs for every image in directory (pipelined)\n";
+    std::cout << "  -server <url>       Symbol server for -auto/-auto-batch (default msdl.microsoft.com)\n";
+    std::cout << "  -store <dir>        Local symbol store for downloaded PDBs (default C:\\Symbols)\n";
+    std::cout << "  -set <pdb[@base]>.. Query many PDBs as one namespace (module!name supported)\n";
+    std::cout << "  -index-store <dir> <index> Build or refresh a symbol/type index over every PDB in a store\n";
+    std::cout << "  -index-query <index> <name> List the PDBs defining a symbol or type, with RVA/layout hash\n";
+    std::cout << "  -breakpad-store <dir> <out> Convert every PDB in a store to Breakpad .sym files in parallel\n";
+    std::cout << "  -symbolize <dump>   Resolve every thread's stack of a minidump to module!symbol+offset\n";
+    std::cout << "  -symbolize-batch <dir> [out] Symbolize every dump in a directory with a shared PDB cache\n";
+    std::cout << "  -cache-mb <n>       Memory budget for PDBs kept open by -symbolize-batch (default 512)\n\n";
 
     std::cout << "Examples:\n";
     std::cout << "  " << programName << " YourApp.pdb\n";
@@ -32,10 +89,116 @@ void ShowUsage(const char* programName) {
     std::cout << "  " << programName << " app.pdb -s \"CreateFileW\" -export results.json\n";
     std::cout << "  " << programName << " -diff old_version.pdb new_version.pdb\n";
     std::cout << "  " << programName << " -batch C:\\Symbols\\ C:\\Analysis\\\n";
-    std::cout << "  " << programName << " ntdll.pdb -p \".*Heap.*\" -t \"_HEAP\"\n\n";
+    std::cout << "  " << programName << " -watch D:\\Incoming D:\\Analysis -debounce 5000\n";
+    std::cout << "  " << programName << " -batch \\\\symbols\\store \\\\results\\run1 -shard 3/16\n";
+    std::cout << "  " << programName << " -merge D:\\Merged \\\\results\\run1\\shard-000-of-016 \\\\results\\run1\\shard-001-of-016\n";
+    std::cout << "  " << programName << " -auto-batch C:\\Windows\\System32 C:\\Analysis\\ -store D:\\Symbols\n";
+    std::cout << "  " << programName << " ntdll.pdb -p \".*Heap.*\" -t \"_HEAP\"\n";
+    std::cout << "  " << programName << " -set ntkrnlmp.pdb@0xfffff80000000000 hal.pdb@0xfffff80001000000 -a 0xfffff80000123456\n";
+    std::cout << "  " << programName << " ntkrnlmp.pdb -snapshot ntkrnlmp.pdbs -t \"_EPROCESS\"\n";
+    std::cout << "  " << programName << " -index-store C:\\Symbols store.pdbx -threads 16\n";
+    std::cout << "  " << programName << " -index-query store.pdbx PspCreateProcessNotifyRoutine _EPROCESS\n";
+    std::cout << "  " << programName << " MyService.pdb -layout-report 25\n";
+    std::cout << "  " << programName << " browser.pdb -class \"Widget\" -overrides \"Widget\" 3\n";
+    std::cout << "  " << programName << " ntkrnlmp.pdb -open publics -s PsLoadedModuleList -s KiServiceTable\n";
+    std::cout << "  " << programName << " ntkrnlmp.pdb -reduce ntkrnlmp.min.pdb names.txt\n";
+    std::cout << "  " << programName << " ntkrnlmp.pdb -script queries.txt\n";
+    std::cout << "  " << programName << " ntkrnlmp.pdb -walk kernel.dmp PsActiveProcessHead _EPROCESS.ActiveProcessLinks UniqueProcessId,ImageFileName\n";
+    std::cout << "  " << programName << " MyService.pdb -breakpad MyService.sym -perf-map perf-1234.map 0x7ff6a0000000\n";
+    std::cout << "  " << programName << " -breakpad-store C:\\Symbols D:\\BreakpadSymbols -threads 16\n";
+    std::cout << "  " << programName << " -symbolize crash.dmp -store D:\\Symbols\n";
+    std::cout << "  " << programName << " -symbolize-batch D:\\Dumps D:\\Reports -cache-mb 2048\n";
+    std::cout << "  " << programName << " ntkrnlmp.pdb -perf -trace trace.json\n\n";
+}
+
+struct TraceOutput {
+    std::wstring path;
+
+    ~TraceOutput() {
+        if (path.empty()) return;
+
+        if (Tracer::Instance().WriteChromeTrace(path)) {
+            std::wcerr << L"Trace written to: " << path << L"\n";
+        }
+        else {
+            std::wcerr << L"Failed to write trace: " << path << L"\n";
+        }
+    }
+};
+
+// True if one of the exports after argv[first] writes to stdout, in which case status lines must
+// go to stderr so they don't end up mixed into the exported records.
+static bool StreamsToStdout(int argc, wchar_t* argv[], int first) {
+    for (int i = first; i + 1 < argc; i++) {
+        std::wstring arg = argv[i];
+        if ((arg == L"-ndjson" || arg == L"-functions" || arg == L"-breakpad" || arg == L"-perf-map") &&
+            std::wstring(argv[i + 1]) == L"-") {
+            return true;
+        }
+    }
+    return false;
 }
 
 int wmain(int argc, wchar_t* argv[]) {
+    TraceOutput traceOutput;
+
+    // -trace is accepted in every mode, so strip it before mode dispatch.
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::wstring(argv[i]) == L"-trace") {
+            traceOutput.path = argv[i + 1];
+            Tracer::Enable();
+
+            for (int j = i; j + 2 < argc; j++) {
+                argv[j] = argv[j + 2];
+            }
+            argc -= 2;
+            break;
+        }
+    }
+
+    // -server and -store configure every mode that fetches PDBs, so they are stripped the same way.
+    SymbolServerConfig serverConfig;
+    for (int i = 1; i + 1 < argc;) {
+        std::wstring arg = argv[i];
+
+        if (arg == L"-server") {
+            serverConfig.serverUrl = WStringToString(argv[i + 1]);
+        }
+        else if (arg == L"-store") {
+            serverConfig.storeDirectory = argv[i + 1];
+        }
+        else {
+            i++;
+            continue;
+        }
+
+        for (int j = i; j + 2 < argc; j++) {
+            argv[j] = argv[j + 2];
+        }
+        argc -= 2;
+    }
+
+    // -open picks how much of the PDB is loaded up front for the analyzer of any mode.
+    OpenMode openMode = OpenMode::Full;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::wstring(argv[i]) == L"-open") {
+            std::wstring mode = argv[i + 1];
+            if (mode == L"publics") openMode = OpenMode::PublicsOnly;
+            else if (mode == L"types") openMode = OpenMode::TypesOnly;
+            else if (mode != L"full") {
+                std::wcerr << L"Error: Unknown -open mode: " << mode << L"\n";
+                ShowUsage("PDBParser.exe");
+                return 1;
+            }
+
+            for (int j = i; j + 2 < argc; j++) {
+                argv[j] = argv[j + 2];
+            }
+            argc -= 2;
+            break;
+        }
+    }
+
     if (argc < 2) {
         ShowUsage("PDBParser.exe");
         return 1;
@@ -51,18 +214,22 @@ int wmain(int argc, wchar_t* argv[]) {
             return 1;
         }
 
-        std::cout << "Attempting to download PDB for executable...\n";
-        auto downloadedPdb = PdbDownloader::DownloadPdbForExecutable(exePath);
+        bool streamedToStdout = StreamsToStdout(argc, argv, 3);
+        std::ostream& status = streamedToStdout ? std::cerr : std::cout;
+        std::wostream& wstatus = streamedToStdout ? std::wcerr : std::wcout;
+
+        status << "Attempting to download PDB for executable...\n";
+        auto downloadedPdb = PdbDownloader::DownloadPdbForExecutable(exePath, serverConfig);
 
         if (!downloadedPdb) {
-            std::cout << "Failed to download PDB for executable\n";
+            status << "Failed to download PDB for executable\n";
             return 1;
         }
 
-        std::wcout << L"Successfully downloaded PDB: " << *downloadedPdb << L"\n";
+        wstatus << L"Successfully downloaded PDB: " << *downloadedPdb << L"\n";
 
         try {
-            PdbAnalyzer analyzer(*downloadedPdb);
+            PdbAnalyzer analyzer(*downloadedPdb, openMode);
             bool hasAdditionalOptions = false;
 
             for (int i = 3; i < argc; i++) {
@@ -74,7 +241,7 @@ int wmain(int argc, wchar_t* argv[]) {
                     std::cout << "  Kernel Symbol Resolution\n";
                     std::cout << std::string(60, '=') << "\n";
 
-                    PdbParser parser(*downloadedPdb);
+                    PdbParser parser(*downloadedPdb, OpenMode::PublicsOnly);
                     if (!parser.IsInitialized()) {
                         std::cout << "Failed to initialize PDB parser\n";
                         return 1;
@@ -156,6 +323,12 @@ int wmain(int argc, wchar_t* argv[]) {
                 else if (arg == L"-s" && i + 1 < argc) {
                     analyzer.FindSpecificSymbol(argv[++i]);
                 }
+                else if (arg == L"-g" && i + 1 < argc) {
+                    analyzer.FindGlobalSymbol(argv[++i]);
+                }
+                else if (arg == L"-gp" && i + 1 < argc) {
+                    analyzer.SearchGlobals(argv[++i]);
+                }
                 else if (arg == L"-t" && i + 1 < argc) {
                     analyzer.AnalyzeStructure(argv[++i]);
                 }
@@ -163,6 +336,35 @@ int wmain(int argc, wchar_t* argv[]) {
                     analyzer.FindStructMember(argv[i + 1], argv[i + 2]);
                     i += 2;
                 }
+                else if (arg == L"-path" && i + 1 < argc) {
+                    analyzer.ResolveFieldPath(argv[++i]);
+                }
+                else if (arg == L"-f" && i + 1 < argc) {
+                    analyzer.AnalyzeFunction(argv[++i]);
+                }
+                else if (arg == L"-e" && i + 1 < argc) {
+                    analyzer.AnalyzeEnum(argv[++i]);
+                }
+                else if (arg == L"-ev" && i + 2 < argc) {
+                    analyzer.DecodeEnumValue(argv[i + 1], argv[i + 2]);
+                    i += 2;
+                }
+                else if (arg == L"-hash" && i + 1 < argc) {
+                    analyzer.ShowLayoutHash(argv[++i]);
+                }
+                else if (arg == L"-layout-report" && i + 1 < argc) {
+                    analyzer.ReportLayouts(std::wcstoul(argv[++i], nullptr, 10));
+                }
+                else if (arg == L"-class" && i + 1 < argc) {
+                    analyzer.AnalyzeClass(argv[++i]);
+                }
+                else if (arg == L"-subclasses" && i + 1 < argc) {
+                    analyzer.ListSubclasses(argv[++i]);
+                }
+                else if (arg == L"-overrides" && i + 2 < argc) {
+                    analyzer.FindOverrides(argv[i + 1], std::wcstoul(argv[i + 2], nullptr, 0));
+                    i += 2;
+                }
                 else if (arg == L"-p" && i + 1 < argc) {
                     analyzer.SearchByPattern(argv[++i]);
                 }
@@ -175,6 +377,39 @@ int wmain(int argc, wchar_t* argv[]) {
                 else if (arg == L"-export" && i + 1 < argc) {
                     analyzer.ExportResults(argv[++i]);
                 }
+                else if (arg == L"-export-columnar" && i + 1 < argc) {
+                    analyzer.ExportColumnar(argv[++i]);
+                }
+                else if (arg == L"-ndjson" && i + 1 < argc) {
+                    analyzer.ExportNdjson(argv[++i]);
+                }
+                else if (arg == L"-functions" && i + 1 < argc) {
+                    analyzer.ExportFunctions(argv[++i]);
+                }
+                else if (arg == L"-breakpad" && i + 1 < argc) {
+                    analyzer.ExportBreakpad(argv[++i]);
+                }
+                else if (arg == L"-perf-map" && i + 2 < argc) {
+                    analyzer.ExportPerfMap(argv[i + 1], std::wcstoull(argv[i + 2], nullptr, 0));
+                    i += 2;
+                }
+                else if (arg == L"-snapshot" && i + 1 < argc) {
+                    analyzer.LoadSnapshot(argv[++i]);
+                }
+                else if (arg == L"-save-snapshot" && i + 1 < argc) {
+                    analyzer.SaveSnapshot(argv[++i]);
+                }
+                else if (arg == L"-reduce" && i + 2 < argc) {
+                    analyzer.WriteReducedPdb(argv[i + 1], argv[i + 2]);
+                    i += 2;
+                }
+                else if (arg == L"-walk" && i + 4 < argc) {
+                    analyzer.WalkMemory(argv[i + 1], argv[i + 2], argv[i + 3], argv[i + 4]);
+                    i += 4;
+                }
+                else if (arg == L"-script" && i + 1 < argc) {
+                    analyzer.RunScript(argv[++i]);
+                }
                 else if (arg == L"-full") {
                     hasAdditionalOptions = false;
                     break;
@@ -217,6 +452,13 @@ int wmain(int argc, wchar_t* argv[]) {
             auto diffs = PdbComparer::ComparePdbs(parser1, parser2);
             PdbComparer::PrintDifferences(diffs);
 
+            for (int i = 4; i < argc; i++) {
+                if (std::wstring(argv[i]) == L"-layouts") {
+                    PdbComparer::PrintLayoutDifferences(PdbComparer::CompareLayouts(parser1, parser2));
+                    break;
+                }
+            }
+
             for (int i = 4; i < argc - 1; i++) {
                 if (std::wstring(argv[i]) == L"-export") {
                     PdbComparer::ExportDifferencesToJson(diffs, argv[i + 1]);
@@ -236,7 +478,27 @@ int wmain(int argc, wchar_t* argv[]) {
 
     if (firstArg == L"-batch" && argc >= 3) {
         std::wstring directory = argv[2];
-        std::wstring outputDir = (argc >= 4) ? argv[3] : L"batch_output";
+        std::wstring outputDir = L"batch_output";
+        std::optional<ShardSpec> shard;
+        size_t threads = 0;
+
+        int i = 3;
+        if (i < argc && argv[i][0] != L'-') {
+            outputDir = argv[i++];
+        }
+        for (; i + 1 < argc; i++) {
+            std::wstring arg = argv[i];
+            if (arg == L"-shard") {
+                shard = ShardSpec::Parse(argv[++i]);
+                if (!shard) {
+                    std::wcout << L"Error: -shard expects <index>/<count> with index < count\n";
+                    return 1;
+                }
+            }
+            else if (arg == L"-threads") {
+                threads = std::wcstoul(argv[++i], nullptr, 10);
+            }
+        }
 
         if (!std::filesystem::exists(directory)) {
             std::wcout << L"Error: Directory not found: " << directory << L"\n";
@@ -244,6 +506,13 @@ int wmain(int argc, wchar_t* argv[]) {
         }
 
         try {
+            if (shard) {
+                auto stats = ShardedBatch::RunShard(directory, outputDir, *shard, threads);
+                ShardedBatch::PrintStats(stats);
+                std::wcout << L"Shard written to: " << (std::filesystem::path(outputDir) / shard->GetDirectoryName()).wstring() << L"\n";
+                return 0;
+            }
+
             BatchProcessor::ProcessDirectory(directory, outputDir);
             std::wcout << L"Batch processing complete. Results in: " << outputDir << L"\n";
         }
@@ -255,6 +524,315 @@ int wmain(int argc, wchar_t* argv[]) {
         return 0;
     }
 
+    if (firstArg == L"-merge" && argc >= 4) {
+        std::wstring outputDir = argv[2];
+        std::vector<std::wstring> shardDirs(argv + 3, argv + argc);
+
+        try {
+            auto stats = ShardedBatch::Merge(shardDirs, outputDir);
+            ShardedBatch::PrintStats(stats);
+            std::wcout << L"Merged results in: " << outputDir << L"\n";
+            if (!stats.missingShards.empty() || stats.shardsMerged == 0) {
+                return 1;
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error merging shards: " << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (firstArg == L"-watch" && argc >= 3) {
+        std::wstring directory = argv[2];
+        BatchWatchOptions options;
+
+        int i = 3;
+        if (i < argc && argv[i][0] != L'-') {
+            options.outputDir = argv[i++];
+        }
+        for (; i < argc; i++) {
+            std::wstring arg = argv[i];
+            if (arg == L"-debounce" && i + 1 < argc) {
+                options.debounceMs = std::wcstoul(argv[++i], nullptr, 10);
+            }
+            else if (arg == L"-once") {
+                options.once = true;
+            }
+        }
+
+        if (!std::filesystem::exists(directory)) {
+            std::wcout << L"Error: Directory not found: " << directory << L"\n";
+            return 1;
+        }
+
+        try {
+            if (!options.once) {
+                std::wcout << L"Watching: " << directory << L" (Ctrl+C to stop)\n";
+            }
+            auto stats = BatchWatcher(directory, options).Run();
+            BatchWatcher::PrintStats(stats);
+            std::wcout << L"Results in: " << options.outputDir << L"\n";
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error watching directory: " << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (firstArg == L"-auto-batch" && argc >= 3) {
+        std::wstring directory = argv[2];
+        AutoBatchOptions options;
+        options.server = serverConfig;
+
+        int i = 3;
+        if (i < argc && argv[i][0] != L'-') {
+            options.outputDir = argv[i++];
+        }
+
+        for (; i + 1 < argc; i++) {
+            std::wstring arg = argv[i];
+
+            if (arg == L"-fetchers") {
+                options.fetchThreads = std::wcstoul(argv[++i], nullptr, 10);
+            }
+            else if (arg == L"-threads") {
+                options.parseThreads = std::wcstoul(argv[++i], nullptr, 10);
+            }
+        }
+
+        if (!std::filesystem::exists(directory)) {
+            std::wcout << L"Error: Directory not found: " << directory << L"\n";
+            return 1;
+        }
+
+        try {
+            auto stats = AutoBatchProcessor::ProcessDirectory(directory, options);
+            AutoBatchProcessor::PrintStats(stats);
+            std::wcout << L"Results in: " << options.outputDir << L"\n";
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error in auto batch processing: " << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (firstArg == L"-index-store" && argc >= 4) {
+        std::wstring storeDirectory = argv[2];
+        std::wstring indexPath = argv[3];
+        StoreIndexOptions options;
+
+        for (int i = 4; i + 1 < argc; i++) {
+            if (std::wstring(argv[i]) == L"-threads") {
+                options.threads = std::wcstoul(argv[++i], nullptr, 10);
+            }
+        }
+
+        if (!std::filesystem::exists(storeDirectory)) {
+            std::wcout << L"Error: Directory not found: " << storeDirectory << L"\n";
+            return 1;
+        }
+
+        try {
+            auto stats = StoreIndexer::Update(storeDirectory, indexPath, options);
+            StoreIndexer::PrintStats(stats);
+            std::wcout << L"Index written to: " << indexPath << L"\n";
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error indexing store: " << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (firstArg == L"-breakpad-store" && argc >= 4) {
+        std::wstring storeDirectory = argv[2];
+        std::wstring outputDirectory = argv[3];
+        BreakpadStoreOptions options;
+
+        for (int i = 4; i + 1 < argc; i++) {
+            if (std::wstring(argv[i]) == L"-threads") {
+                options.threads = std::wcstoul(argv[++i], nullptr, 10);
+            }
+        }
+
+        if (!std::filesystem::exists(storeDirectory)) {
+            std::wcout << L"Error: Directory not found: " << storeDirectory << L"\n";
+            return 1;
+        }
+
+        try {
+            auto stats = BreakpadStoreConverter::Convert(storeDirectory, outputDirectory, options);
+            BreakpadStoreConverter::PrintStats(stats);
+            std::wcout << L"Symbol files written to: " << outputDirectory << L"\n";
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error converting store: " << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (firstArg == L"-symbolize" && argc >= 3) {
+        SymbolizerOptions options;
+        options.storeDirectory = serverConfig.storeDirectory;
+
+        Symbolizer symbolizer(options);
+        auto dumps = symbolizer.Symbolize({ argv[2] });
+        Symbolizer::PrintDump(std::cout, dumps.front());
+
+        if (!dumps.front().loaded) {
+            return 1;
+        }
+
+        std::cout << "\n";
+        Symbolizer::PrintStats(symbolizer.GetStats());
+        return 0;
+    }
+
+    if (firstArg == L"-symbolize-batch" && argc >= 3) {
+        std::wstring directory = argv[2];
+        std::wstring outputDirectory = L"symbolized";
+        SymbolizerOptions options;
+        options.storeDirectory = serverConfig.storeDirectory;
+
+        int i = 3;
+        if (i < argc && argv[i][0] != L'-') {
+            outputDirectory = argv[i++];
+        }
+        for (; i + 1 < argc; i++) {
+            if (std::wstring(argv[i]) == L"-cache-mb") {
+                options.cacheBytes = static_cast<size_t>(std::wcstoull(argv[++i], nullptr, 10)) * 1024 * 1024;
+            }
+        }
+
+        if (!std::filesystem::exists(directory)) {
+            std::wcout << L"Error: Directory not found: " << directory << L"\n";
+            return 1;
+        }
+
+        try {
+            auto stats = Symbolizer::ProcessDirectory(directory, outputDirectory, options);
+            Symbolizer::PrintStats(stats);
+            std::wcout << L"Reports written to: " << outputDirectory << L"\n";
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error symbolizing dumps: " << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (firstArg == L"-index-query" && argc >= 4) {
+        try {
+            auto start = std::chrono::high_resolution_clock::now();
+            StoreIndex index(argv[2]);
+
+            for (int i = 3; i < argc; i++) {
+                std::string name = WStringToString(argv[i]);
+                auto hits = index.Query(name);
+
+                std::cout << name << ": " << hits.size() << " hit(s)\n";
+                for (const auto& hit : hits) {
+                    if (hit.kind == StoreIndexTermKind::Symbol) {
+                        std::cout << "  symbol RVA 0x" << std::hex << hit.rva << std::dec;
+                    }
+                    else {
+                        std::cout << "  type   hash " << hit.layoutHash.ToString();
+                    }
+                    std::cout << " | " << hit.signature.ToString() << " | " << hit.pdbPath << "\n";
+                }
+            }
+
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << "Query time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "us\n";
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error reading store index: " << e.what() << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (firstArg == L"-set" && argc >= 3) {
+        PdbSet pdbSet;
+        int i = 2;
+
+        for (; i < argc && argv[i][0] != L'-'; i++) {
+            std::wstring spec = argv[i];
+            DWORD64 base = 0;
+
+            size_t at = spec.rfind(L'@');
+            if (at != std::wstring::npos) {
+                base = std::wcstoull(spec.c_str() + at + 1, nullptr, 0);
+                spec = spec.substr(0, at);
+            }
+
+            if (!std::filesystem::exists(spec)) {
+                std::wcerr << L"Error: PDB file not found: " << spec << L"\n";
+                return 1;
+            }
+
+            pdbSet.AddModule(spec, base);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        size_t loaded = pdbSet.Load();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "Loaded " << loaded << "/" << pdbSet.GetModuleCount() << " modules in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms\n";
+
+        for (; i < argc; i++) {
+            std::wstring arg = argv[i];
+
+            if (arg == L"-s" && i + 1 < argc) {
+                auto matches = pdbSet.FindSymbol(argv[++i]);
+                if (matches.empty()) {
+                    std::wcout << L"Symbol not found: " << argv[i] << L"\n";
+                }
+                for (const auto& match : matches) {
+                    std::cout << match.moduleName << "!" << match.name << " = 0x" << std::hex
+                        << match.address << " (RVA 0x" << match.rva << ")\n" << std::dec;
+                }
+            }
+            else if (arg == L"-p" && i + 1 < argc) {
+                auto matches = pdbSet.FindSymbolsByPattern(argv[++i]);
+                std::cout << "Found " << matches.size() << " matches\n";
+                for (const auto& match : matches) {
+                    std::cout << "0x" << std::hex << match.address << std::dec << " | "
+                        << match.moduleName << "!" << match.name << "\n";
+                }
+            }
+            else if (arg == L"-a" && i + 1 < argc) {
+                DWORD64 address = std::wcstoull(argv[++i], nullptr, 0);
+                auto resolved = pdbSet.ResolveAddress(address);
+                if (resolved && !resolved->symbolName.empty()) {
+                    std::cout << "0x" << std::hex << address << " = " << resolved->moduleName << "!"
+                        << resolved->symbolName << "+0x" << resolved->displacement << "\n" << std::dec;
+                }
+                else if (resolved) {
+                    std::cout << "0x" << std::hex << address << " = " << resolved->moduleName
+                        << "+0x" << resolved->displacement << "\n" << std::dec;
+                }
+                else {
+                    std::cout << "0x" << std::hex << address << " = <unknown>\n" << std::dec;
+                }
+            }
+        }
+
+        return 0;
+    }
+
     std::wstring pdbPath = firstArg;
 
     if (!std::filesystem::exists(pdbPath)) {
@@ -263,8 +841,9 @@ int wmain(int argc, wchar_t* argv[]) {
     }
 
     try {
-        PdbAnalyzer analyzer(pdbPath);
+        PdbAnalyzer analyzer(pdbPath, openMode);
         bool hasOptions = false;
+        bool streamedToStdout = false;
 
         for (int i = 2; i < argc; i++) {
             std::wstring arg = argv[i];
@@ -273,6 +852,12 @@ int wmain(int argc, wchar_t* argv[]) {
             if (arg == L"-s" && i + 1 < argc) {
                 analyzer.FindSpecificSymbol(argv[++i]);
             }
+            else if (arg == L"-g" && i + 1 < argc) {
+                analyzer.FindGlobalSymbol(argv[++i]);
+            }
+            else if (arg == L"-gp" && i + 1 < argc) {
+                analyzer.SearchGlobals(argv[++i]);
+            }
             else if (arg == L"-t" && i + 1 < argc) {
                 analyzer.AnalyzeStructure(argv[++i]);
             }
@@ -280,6 +865,35 @@ int wmain(int argc, wchar_t* argv[]) {
                 analyzer.FindStructMember(argv[i + 1], argv[i + 2]);
                 i += 2;
             }
+            else if (arg == L"-path" && i + 1 < argc) {
+                analyzer.ResolveFieldPath(argv[++i]);
+            }
+            else if (arg == L"-f" && i + 1 < argc) {
+                analyzer.AnalyzeFunction(argv[++i]);
+            }
+            else if (arg == L"-e" && i + 1 < argc) {
+                analyzer.AnalyzeEnum(argv[++i]);
+            }
+            else if (arg == L"-ev" && i + 2 < argc) {
+                analyzer.DecodeEnumValue(argv[i + 1], argv[i + 2]);
+                i += 2;
+            }
+            else if (arg == L"-hash" && i + 1 < argc) {
+                analyzer.ShowLayoutHash(argv[++i]);
+            }
+            else if (arg == L"-layout-report" && i + 1 < argc) {
+                analyzer.ReportLayouts(std::wcstoul(argv[++i], nullptr, 10));
+            }
+            else if (arg == L"-class" && i + 1 < argc) {
+                analyzer.AnalyzeClass(argv[++i]);
+            }
+            else if (arg == L"-subclasses" && i + 1 < argc) {
+                analyzer.ListSubclasses(argv[++i]);
+            }
+            else if (arg == L"-overrides" && i + 2 < argc) {
+                analyzer.FindOverrides(argv[i + 1], std::wcstoul(argv[i + 2], nullptr, 0));
+                i += 2;
+            }
             else if (arg == L"-p" && i + 1 < argc) {
                 analyzer.SearchByPattern(argv[++i]);
             }
@@ -292,12 +906,53 @@ int wmain(int argc, wchar_t* argv[]) {
             else if (arg == L"-export" && i + 1 < argc) {
                 analyzer.ExportResults(argv[++i]);
             }
+            else if (arg == L"-export-columnar" && i + 1 < argc) {
+                analyzer.ExportColumnar(argv[++i]);
+            }
+            else if (arg == L"-ndjson" && i + 1 < argc) {
+                std::wstring target = argv[++i];
+                streamedToStdout = streamedToStdout || target == L"-";
+                analyzer.ExportNdjson(target);
+            }
+            else if (arg == L"-functions" && i + 1 < argc) {
+                std::wstring target = argv[++i];
+                streamedToStdout = streamedToStdout || target == L"-";
+                analyzer.ExportFunctions(target);
+            }
+            else if (arg == L"-breakpad" && i + 1 < argc) {
+                std::wstring target = argv[++i];
+                streamedToStdout = streamedToStdout || target == L"-";
+                analyzer.ExportBreakpad(target);
+            }
+            else if (arg == L"-perf-map" && i + 2 < argc) {
+                std::wstring target = argv[i + 1];
+                streamedToStdout = streamedToStdout || target == L"-";
+                analyzer.ExportPerfMap(target, std::wcstoull(argv[i + 2], nullptr, 0));
+                i += 2;
+            }
+            else if (arg == L"-snapshot" && i + 1 < argc) {
+                analyzer.LoadSnapshot(argv[++i]);
+            }
+            else if (arg == L"-save-snapshot" && i + 1 < argc) {
+                analyzer.SaveSnapshot(argv[++i]);
+            }
+            else if (arg == L"-reduce" && i + 2 < argc) {
+                analyzer.WriteReducedPdb(argv[i + 1], argv[i + 2]);
+                i += 2;
+            }
+            else if (arg == L"-walk" && i + 4 < argc) {
+                analyzer.WalkMemory(argv[i + 1], argv[i + 2], argv[i + 3], argv[i + 4]);
+                i += 4;
+            }
+            else if (arg == L"-script" && i + 1 < argc) {
+                analyzer.RunScript(argv[++i]);
+            }
             else if (arg == L"-kernel") {
                 std::cout << "\n" << std::string(60, '=') << "\n";
                 std::cout << "  Kernel Symbol Resolution\n";
                 std::cout << std::string(60, '=') << "\n";
 
-                PdbParser parser(pdbPath);
+                PdbParser parser(pdbPath, OpenMode::PublicsOnly);
                 if (!parser.IsInitialized()) {
                     std::cout << "Failed to initialize PDB parser\n";
                     continue;
@@ -398,6 +1053,9 @@ int wmain(int argc, wchar_t* argv[]) {
             analyzer.FindStructMember(L"_UNICODE_STRING", L"Buffer");
         }
 
+        if (streamedToStdout) {
+            return 0;
+        }
     }
     catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
@@ -0,0 +1,42 @@
+#include "MappedFile.h"
+#include <stdexcept>
+
+MappedFile::MappedFile(const std::wstring& path) {
+    m_hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, 0, nullptr);
+    if (m_hFile == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file");
+    }
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(m_hFile, &fileSize) || fileSize.QuadPart <= 0) {
+        Close();
+        throw std::runtime_error("File is empty");
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    m_hMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_hMapping) {
+        m_pBase = static_cast<const uint8_t*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+    }
+
+    if (!m_pBase) {
+        Close();
+        throw std::runtime_error("Failed to map file");
+    }
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+void MappedFile::Close() noexcept {
+    if (m_pBase) UnmapViewOfFile(m_pBase);
+    if (m_hMapping) CloseHandle(m_hMapping);
+    if (m_hFile != INVALID_HANDLE_VALUE) CloseHandle(m_hFile);
+
+    m_pBase = nullptr;
+    m_hMapping = nullptr;
+    m_hFile = INVALID_HANDLE_VALUE;
+    m_size = 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <string>
+
+// A whole file mapped read-only for the lifetime of the object. The constructor throws if the file
+// cannot be opened or mapped; empty files cannot be mapped and are rejected the same way.
+class MappedFile {
+private:
+    HANDLE m_hFile = INVALID_HANDLE_VALUE;
+    HANDLE m_hMapping = nullptr;
+    const uint8_t* m_pBase = nullptr;
+    size_t m_size = 0;
+
+    void Close() noexcept;
+
+public:
+    explicit MappedFile(const std::wstring& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* GetData() const noexcept { return m_pBase; }
+    size_t GetSize() const noexcept { return m_size; }
+};
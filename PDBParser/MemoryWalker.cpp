@@ -0,0 +1,258 @@
+#include "MemoryWalker.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    constexpr uint32_t MinidumpSignature = 0x504D444D; // 'MDMP'
+    constexpr size_t CacheLineSize = 64;
+    constexpr uintptr_t PageSize = 4096;
+
+    inline void PrefetchLine(const uint8_t* line) noexcept {
+#if defined(_M_X64) || defined(_M_IX86)
+        _mm_prefetch(reinterpret_cast<const char*>(line), _MM_HINT_T0);
+#elif defined(_M_ARM64)
+        __prefetch(line);
+#else
+        (void)line;
+#endif
+    }
+}
+
+MemoryImage::MemoryImage(const std::wstring& path, DWORD64 flatBase)
+    : m_flat(std::make_unique<MappedFile>(path)) {
+    uint32_t signature = 0;
+    if (m_flat->GetSize() >= sizeof(signature)) {
+        memcpy(&signature, m_flat->GetData(), sizeof(signature));
+    }
+
+    if (signature == MinidumpSignature) {
+        m_flat.reset();
+        m_dump = std::make_unique<Minidump>(path, 0);
+        m_data = m_dump->GetFile().GetData();
+        m_ranges = m_dump->GetMemoryRanges();
+    }
+    else {
+        m_data = m_flat->GetData();
+        m_ranges.push_back({ flatBase, m_flat->GetSize(), 0 });
+    }
+}
+
+const uint8_t* MemoryImage::Translate(DWORD64 address, size_t size) const noexcept {
+    auto it = std::upper_bound(m_ranges.begin(), m_ranges.end(), address,
+        [](DWORD64 value, const MinidumpMemoryRange& range) { return value < range.address; });
+    if (it == m_ranges.begin()) return nullptr;
+
+    --it;
+    DWORD64 offset = address - it->address;
+    if (offset > it->size || it->size - offset < size) return nullptr;
+    return m_data + it->fileOffset + offset;
+}
+
+bool MemoryImage::Read(DWORD64 address, void* buffer, size_t size) const noexcept {
+    const uint8_t* data = Translate(address, size);
+    if (!data) return false;
+
+    memcpy(buffer, data, size);
+    return true;
+}
+
+bool MemoryImage::ReadPointer(DWORD64 address, DWORD pointerSize, DWORD64& value) const noexcept {
+    if (pointerSize == sizeof(uint32_t)) {
+        uint32_t narrow = 0;
+        if (!Read(address, &narrow, sizeof(narrow))) return false;
+        value = narrow;
+        return true;
+    }
+    return Read(address, &value, sizeof(value));
+}
+
+void MemoryImage::Prefetch(DWORD64 address, size_t size) const noexcept {
+    const uint8_t* data = Translate(address, size);
+    if (!data) return;
+
+    const uint8_t* line = data - reinterpret_cast<uintptr_t>(data) % CacheLineSize;
+    for (; line < data + size; line += CacheLineSize) {
+        PrefetchLine(line);
+    }
+}
+
+void MemoryImage::PrefetchPages(const DWORD64* addresses, size_t count, size_t size) const {
+    std::vector<WIN32_MEMORY_RANGE_ENTRY> entries;
+    entries.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* data = Translate(addresses[i], size);
+        if (!data) continue;
+
+        uintptr_t begin = reinterpret_cast<uintptr_t>(data) & ~(PageSize - 1);
+        uintptr_t end = (reinterpret_cast<uintptr_t>(data) + size + PageSize - 1) & ~(PageSize - 1);
+
+        // Objects allocated back to back share pages; extend the previous entry instead of repeating it.
+        if (!entries.empty()) {
+            uintptr_t lastBegin = reinterpret_cast<uintptr_t>(entries.back().VirtualAddress);
+            uintptr_t lastEnd = lastBegin + entries.back().NumberOfBytes;
+            if (begin >= lastBegin && begin <= lastEnd) {
+                entries.back().NumberOfBytes = (std::max)(lastEnd, end) - lastBegin;
+                continue;
+            }
+        }
+
+        entries.push_back({ reinterpret_cast<PVOID>(begin), end - begin });
+    }
+
+    if (!entries.empty()) {
+        PrefetchVirtualMemory(GetCurrentProcess(), entries.size(), entries.data(), 0);
+    }
+}
+
+MemoryWalker::MemoryWalker(const PdbParser& parser, const MemoryImage& image)
+    : m_parser(parser), m_image(image) {
+    MachineType machineType = parser.GetMachineType();
+    m_pointerSize = machineType == MachineType::x86 || machineType == MachineType::ARM ? 4 : 8;
+}
+
+FieldPath::PointerReader MemoryWalker::GetPointerReader() const {
+    return [this](DWORD64 address, DWORD64& value) {
+        return m_image.ReadPointer(address, m_pointerSize, value);
+    };
+}
+
+std::vector<DWORD64> MemoryWalker::WalkList(DWORD64 listHead, DWORD64 linkOffset, size_t maxEntries) const {
+    TraceScope trace(TracePhase::WalkMemory);
+    std::vector<DWORD64> entries;
+
+    DWORD64 previous = listHead;
+    DWORD64 link = 0;
+    if (!m_image.ReadPointer(listHead, m_pointerSize, link)) return entries;
+
+    while (link != 0 && link != listHead && entries.size() < maxEntries) {
+        DWORD64 next = 0;
+        DWORD64 back = 0;
+        if (!m_image.ReadPointer(link, m_pointerSize, next) ||
+            !m_image.ReadPointer(link + m_pointerSize, m_pointerSize, back) || back != previous) {
+            break;
+        }
+
+        // The chain itself is serial; the most that can be started early is the next link's line.
+        m_image.Prefetch(next, 2 * m_pointerSize);
+        entries.push_back(link - linkOffset);
+
+        previous = link;
+        link = next;
+    }
+
+    return entries;
+}
+
+std::optional<std::vector<DWORD64>> MemoryWalker::WalkList(DWORD64 listHead, const std::wstring& linkPath,
+    size_t maxEntries) const {
+    auto path = m_parser.CompileFieldPath(linkPath);
+    if (!path || !path->IsDirect()) return std::nullopt;
+
+    return WalkList(listHead, path->offsets.front(), maxEntries);
+}
+
+std::vector<DWORD64> MemoryWalker::WalkArray(DWORD64 address, DWORD64 elementSize, size_t count) const {
+    std::vector<DWORD64> elements(count);
+    for (size_t i = 0; i < count; ++i) {
+        elements[i] = address + i * elementSize;
+    }
+    return elements;
+}
+
+std::vector<DWORD64> MemoryWalker::FollowPointers(const std::vector<DWORD64>& objects, DWORD64 offset) const {
+    TraceScope trace(TracePhase::WalkMemory);
+    std::vector<DWORD64> targets;
+    targets.reserve(objects.size());
+
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (i + PrefetchDistance < objects.size()) {
+            m_image.Prefetch(objects[i + PrefetchDistance] + offset, m_pointerSize);
+        }
+
+        DWORD64 pointer = 0;
+        if (m_image.ReadPointer(objects[i] + offset, m_pointerSize, pointer) && pointer != 0) {
+            targets.push_back(pointer);
+        }
+    }
+
+    return targets;
+}
+
+void MemoryWalker::ReadFields(const std::vector<DWORD64>& objects, const std::vector<FieldPath>& fields,
+    FieldTable& table) const {
+    TraceScope trace(TracePhase::WalkMemory);
+
+    table.columns = fields.size();
+    table.values.assign(objects.size() * fields.size(), 0);
+    table.present.assign(objects.size() * fields.size(), 0);
+    if (fields.empty() || objects.empty()) return;
+
+    // The part of each object the direct fields touch; pointer-chasing fields land elsewhere and are
+    // only read, not prefetched.
+    DWORD64 spanBegin = INVALID_OFFSET;
+    DWORD64 spanEnd = 0;
+    for (const auto& field : fields) {
+        if (!field.IsDirect()) continue;
+        spanBegin = (std::min)(spanBegin, field.offsets.front());
+        spanEnd = (std::max)(spanEnd, field.offsets.front() + (std::min<DWORD64>)(field.size, sizeof(uint64_t)));
+    }
+    const size_t span = spanBegin < spanEnd ? static_cast<size_t>(spanEnd - spanBegin) : 0;
+
+    std::vector<DWORD64> batchAddresses;
+    auto prefetchBatch = [&](size_t first) {
+        if (span == 0 || first >= objects.size()) return;
+
+        size_t last = (std::min)(first + PageBatch, objects.size());
+        batchAddresses.clear();
+        for (size_t i = first; i < last; ++i) {
+            batchAddresses.push_back(objects[i] + spanBegin);
+        }
+        m_image.PrefetchPages(batchAddresses.data(), batchAddresses.size(), span);
+    };
+
+    const FieldPath::PointerReader reader = GetPointerReader();
+    prefetchBatch(0);
+
+    for (size_t batch = 0; batch < objects.size(); batch += PageBatch) {
+        prefetchBatch(batch + PageBatch);
+        size_t batchEnd = (std::min)(batch + PageBatch, objects.size());
+
+        for (size_t row = batch; row < batchEnd; ++row) {
+            if (row + PrefetchDistance < objects.size()) {
+                for (const auto& field : fields) {
+                    if (field.IsDirect()) {
+                        m_image.Prefetch(objects[row + PrefetchDistance] + field.offsets.front(),
+                            static_cast<size_t>((std::min<DWORD64>)(field.size, CacheLineSize)));
+                    }
+                }
+            }
+
+            for (size_t column = 0; column < fields.size(); ++column) {
+                const FieldPath& field = fields[column];
+                DWORD64 address = field.IsDirect() ? objects[row] + field.offsets.front()
+                    : field.Resolve(objects[row], reader).value_or(INVALID_OFFSET);
+                if (address == INVALID_OFFSET) continue;
+
+                size_t cell = row * table.columns + column;
+                if (field.size > sizeof(uint64_t)) {
+                    if (m_image.Translate(address, static_cast<size_t>(field.size))) {
+                        table.values[cell] = address;
+                        table.present[cell] = 1;
+                    }
+                    continue;
+                }
+
+                uint64_t raw = 0;
+                if (m_image.Read(address, &raw, static_cast<size_t>(field.size))) {
+                    table.values[cell] = field.ExtractBits(raw);
+                    table.present[cell] = 1;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "MappedFile.h"
+#include "Minidump.h"
+#include "PdbParser.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// A target address space read straight out of a mapped file: the memory ranges of a minidump, or a
+// flat file holding one contiguous range that starts at a base address (a .writemem or raw region
+// capture). Reads never span two ranges, so a value split across captured blocks reads as missing.
+class MemoryImage {
+private:
+    std::unique_ptr<MappedFile> m_flat;
+    std::unique_ptr<Minidump> m_dump;
+    const uint8_t* m_data = nullptr;
+    std::vector<MinidumpMemoryRange> m_ranges;
+
+public:
+    // Minidumps are recognized by their signature and flatBase is then ignored.
+    explicit MemoryImage(const std::wstring& path, DWORD64 flatBase = 0);
+
+    MemoryImage(const MemoryImage&) = delete;
+    MemoryImage& operator=(const MemoryImage&) = delete;
+
+    const Minidump* GetMinidump() const noexcept { return m_dump.get(); }
+    const std::vector<MinidumpMemoryRange>& GetRanges() const noexcept { return m_ranges; }
+
+    const uint8_t* Translate(DWORD64 address, size_t size) const noexcept;
+    bool Read(DWORD64 address, void* buffer, size_t size) const noexcept;
+    bool ReadPointer(DWORD64 address, DWORD pointerSize, DWORD64& value) const noexcept;
+
+    // Pulls the cache lines of [address, address + size) toward the core.
+    void Prefetch(DWORD64 address, size_t size) const noexcept;
+    // Asks the OS to page in the file pages behind each [address, address + size) in one call, so a
+    // cold mapping is read with overlapped I/O instead of one fault at a time.
+    void PrefetchPages(const DWORD64* addresses, size_t count, size_t size) const;
+};
+
+// Row-major result of MemoryWalker::ReadFields, one row per object and one column per field. Fields
+// of up to 8 bytes hold their value, bitfields already shifted and masked; wider fields hold the
+// field's address, to be read with MemoryImage::Read.
+struct FieldTable {
+    size_t columns = 0;
+    std::vector<uint64_t> values;
+    std::vector<uint8_t> present;
+
+    size_t GetRowCount() const noexcept { return columns ? values.size() / columns : 0; }
+    bool Has(size_t row, size_t column) const noexcept { return present[row * columns + column] != 0; }
+    uint64_t Get(size_t row, size_t column) const noexcept { return values[row * columns + column]; }
+};
+
+// Typed traversal of a memory image using a PDB's layouts. Offsets are compiled once (FieldPath)
+// and applied to every object, so walking a list of thousands of _EPROCESS costs one translation per
+// field read rather than one layout lookup.
+class MemoryWalker {
+private:
+    static constexpr size_t PrefetchDistance = 8;
+    static constexpr size_t PageBatch = 64;
+
+    const PdbParser& m_parser;
+    const MemoryImage& m_image;
+    DWORD m_pointerSize;
+
+public:
+    MemoryWalker(const PdbParser& parser, const MemoryImage& image);
+
+    DWORD GetPointerSize() const noexcept { return m_pointerSize; }
+    FieldPath::PointerReader GetPointerReader() const;
+
+    // Containers of every entry of a circular LIST_ENTRY list, in Flink order. listHead is the
+    // address of the head (which is not an entry) and linkOffset the LIST_ENTRY's offset in the
+    // container. The walk stops back at the head, at a null or unreadable link, at an entry whose
+    // Blink does not point back, or after maxEntries.
+    std::vector<DWORD64> WalkList(DWORD64 listHead, DWORD64 linkOffset, size_t maxEntries = 1 << 20) const;
+    // linkPath names the link member as a field path, e.g. "_EPROCESS.ActiveProcessLinks".
+    std::optional<std::vector<DWORD64>> WalkList(DWORD64 listHead, const std::wstring& linkPath,
+        size_t maxEntries = 1 << 20) const;
+
+    std::vector<DWORD64> WalkArray(DWORD64 address, DWORD64 elementSize, size_t count) const;
+    // The pointer at each object + offset; null or unreadable pointers are dropped.
+    std::vector<DWORD64> FollowPointers(const std::vector<DWORD64>& objects, DWORD64 offset) const;
+
+    // Reads every field of every object. Rows are processed in batches whose pages are requested
+    // from the OS one batch ahead, and each object's field lines are prefetched a few rows ahead.
+    void ReadFields(const std::vector<DWORD64>& objects, const std::vector<FieldPath>& fields, FieldTable& table) const;
+};
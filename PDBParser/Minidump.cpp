@@ -0,0 +1,353 @@
+#include "Minidump.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t MinidumpSignature = 0x504D444D; // 'MDMP'
+    constexpr uint32_t CodeViewSignature = 0x53445352; // 'RSDS'
+
+    constexpr uint32_t ThreadListStream = 3;
+    constexpr uint32_t ModuleListStream = 4;
+    constexpr uint32_t ExceptionStream = 6;
+    constexpr uint32_t SystemInfoStream = 7;
+    constexpr uint32_t MemoryListStream = 5;
+    constexpr uint32_t Memory64ListStream = 9;
+
+    constexpr uint16_t ArchitectureX86 = 0;
+    constexpr uint16_t ArchitectureArm = 5;
+    constexpr uint16_t ArchitectureAmd64 = 9;
+    constexpr uint16_t ArchitectureArm64 = 12;
+
+#pragma pack(push, 1)
+    struct MinidumpHeader {
+        uint32_t signature;
+        uint32_t version;
+        uint32_t streamCount;
+        uint32_t streamDirectoryRva;
+        uint32_t checkSum;
+        uint32_t timeDateStamp;
+        uint64_t flags;
+    };
+
+    struct MinidumpDirectory {
+        uint32_t streamType;
+        uint32_t dataSize;
+        uint32_t rva;
+    };
+
+    struct MinidumpLocation {
+        uint32_t dataSize;
+        uint32_t rva;
+    };
+
+    struct MinidumpModuleRecord {
+        uint64_t baseOfImage;
+        uint32_t sizeOfImage;
+        uint32_t checkSum;
+        uint32_t timeDateStamp;
+        uint32_t moduleNameRva;
+        uint32_t versionInfo[13];
+        MinidumpLocation cvRecord;
+        MinidumpLocation miscRecord;
+        uint64_t reserved0;
+        uint64_t reserved1;
+    };
+
+    struct MinidumpMemoryDescriptor {
+        uint64_t startOfMemoryRange;
+        MinidumpLocation memory;
+    };
+
+    struct MinidumpMemory64Header {
+        uint64_t rangeCount;
+        uint64_t baseRva;
+    };
+
+    struct MinidumpMemoryDescriptor64 {
+        uint64_t startOfMemoryRange;
+        uint64_t dataSize;
+    };
+
+    struct MinidumpThreadRecord {
+        uint32_t threadId;
+        uint32_t suspendCount;
+        uint32_t priorityClass;
+        uint32_t priority;
+        uint64_t teb;
+        uint64_t stackStart;
+        MinidumpLocation stackMemory;
+        MinidumpLocation context;
+    };
+
+    struct MinidumpExceptionStream {
+        uint32_t threadId;
+        uint32_t alignment;
+        uint32_t exceptionCode;
+        uint32_t exceptionFlags;
+        uint64_t exceptionRecord;
+        uint64_t exceptionAddress;
+        uint32_t parameterCount;
+        uint32_t unusedAlignment;
+        uint64_t information[15];
+        MinidumpLocation context;
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(MinidumpHeader) == 32, "minidump header layout");
+    static_assert(sizeof(MinidumpModuleRecord) == 108, "minidump module layout");
+    static_assert(sizeof(MinidumpThreadRecord) == 48, "minidump thread layout");
+    static_assert(sizeof(MinidumpExceptionStream) == 168, "minidump exception layout");
+
+    // Where the program counter, stack pointer and link register sit in each architecture's CONTEXT.
+    struct ContextLayout {
+        size_t pc;
+        size_t sp;
+        size_t link;
+        size_t pointerSize;
+    };
+
+    constexpr size_t NoLinkRegister = SIZE_MAX;
+
+    ContextLayout GetContextLayout(MachineType machineType) {
+        switch (machineType) {
+        case MachineType::x86: return { 0xB8, 0xC4, NoLinkRegister, 4 };
+        case MachineType::ARM: return { 0x40, 0x38, 0x3C, 4 };
+        case MachineType::ARM64: return { 0x108, 0x100, 0xF8, 8 };
+        default: return { 0xF8, 0x98, NoLinkRegister, 8 };
+        }
+    }
+
+    std::string ModuleNameFromPath(const std::wstring& path) {
+        size_t slash = path.find_last_of(L"\\/");
+        std::wstring name = slash == std::wstring::npos ? path : path.substr(slash + 1);
+        size_t dot = name.find_last_of(L'.');
+        if (dot != std::wstring::npos && dot > 0) name.resize(dot);
+        return WStringToString(name);
+    }
+}
+
+template<typename T>
+bool Minidump::Read(size_t offset, T& value) const noexcept {
+    if (offset > m_file.GetSize() || m_file.GetSize() - offset < sizeof(T)) return false;
+    memcpy(&value, m_file.GetData() + offset, sizeof(T));
+    return true;
+}
+
+Minidump::Minidump(const std::wstring& path, size_t maxFrames)
+    : m_file(path) {
+    MinidumpHeader header{};
+    if (!Read(0, header) || header.signature != MinidumpSignature) {
+        throw std::runtime_error("Not a minidump");
+    }
+
+    std::optional<MinidumpDirectory> moduleList, threadList, memoryList, memory64List;
+    std::optional<DWORD> crashedThread;
+    uint32_t crashContextRva = 0;
+
+    for (uint32_t i = 0; i < header.streamCount; ++i) {
+        MinidumpDirectory directory{};
+        if (!Read(header.streamDirectoryRva + static_cast<size_t>(i) * sizeof(directory), directory)) break;
+
+        switch (directory.streamType) {
+        case ModuleListStream:
+            moduleList = directory;
+            break;
+        case ThreadListStream:
+            threadList = directory;
+            break;
+        case MemoryListStream:
+            memoryList = directory;
+            break;
+        case Memory64ListStream:
+            memory64List = directory;
+            break;
+        case ExceptionStream: {
+            MinidumpExceptionStream exception{};
+            if (Read(directory.rva, exception)) {
+                crashedThread = exception.threadId;
+                crashContextRva = exception.context.rva;
+            }
+            break;
+        }
+        case SystemInfoStream: {
+            uint16_t architecture = 0;
+            if (Read(directory.rva, architecture)) {
+                if (architecture == ArchitectureX86) m_machineType = MachineType::x86;
+                else if (architecture == ArchitectureArm) m_machineType = MachineType::ARM;
+                else if (architecture == ArchitectureArm64) m_machineType = MachineType::ARM64;
+                else if (architecture == ArchitectureAmd64) m_machineType = MachineType::x64;
+            }
+            break;
+        }
+        }
+    }
+
+    if (!moduleList) {
+        throw std::runtime_error("Minidump has no module list");
+    }
+
+    ReadModules(moduleList->rva, moduleList->dataSize);
+    if (memoryList) ReadMemoryList(memoryList->rva, memoryList->dataSize);
+    if (memory64List) ReadMemory64List(memory64List->rva, memory64List->dataSize);
+    std::sort(m_memory.begin(), m_memory.end(),
+        [](const MinidumpMemoryRange& a, const MinidumpMemoryRange& b) { return a.address < b.address; });
+
+    if (threadList) {
+        ReadThreads(threadList->rva, threadList->dataSize, crashedThread, crashContextRva, maxFrames);
+    }
+}
+
+// MINIDUMP_STRING: a byte length followed by UTF-16 code units.
+std::wstring Minidump::ReadString(uint32_t rva) const {
+    uint32_t length = 0;
+    if (!Read(rva, length) || rva + sizeof(length) + static_cast<size_t>(length) > m_file.GetSize()) return {};
+
+    std::wstring value(length / sizeof(uint16_t), L'\0');
+    for (size_t i = 0; i < value.size(); ++i) {
+        uint16_t unit = 0;
+        memcpy(&unit, m_file.GetData() + rva + sizeof(length) + i * sizeof(unit), sizeof(unit));
+        value[i] = static_cast<wchar_t>(unit);
+    }
+    return value;
+}
+
+void Minidump::ReadModules(uint32_t rva, uint32_t size) {
+    uint32_t count = 0;
+    if (!Read(rva, count) || size < sizeof(count) || count > (size - sizeof(count)) / sizeof(MinidumpModuleRecord)) {
+        throw std::runtime_error("Corrupt minidump module list");
+    }
+
+    m_modules.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        MinidumpModuleRecord record{};
+        if (!Read(rva + sizeof(count) + static_cast<size_t>(i) * sizeof(record), record)) break;
+
+        MinidumpModule module;
+        module.path = ReadString(record.moduleNameRva);
+        module.name = ModuleNameFromPath(module.path);
+        module.base = record.baseOfImage;
+        module.size = record.sizeOfImage;
+
+        // The CodeView record is the image's RSDS entry: GUID, age and the PDB path the linker wrote.
+        uint32_t cvSignature = 0;
+        GUID guid{};
+        DWORD age = 0;
+        const size_t nameOffset = sizeof(cvSignature) + sizeof(guid) + sizeof(age);
+        if (record.cvRecord.dataSize > nameOffset && Read(record.cvRecord.rva, cvSignature) && cvSignature == CodeViewSignature &&
+            Read(record.cvRecord.rva + sizeof(cvSignature), guid) && Read(record.cvRecord.rva + sizeof(cvSignature) + sizeof(guid), age) &&
+            static_cast<size_t>(record.cvRecord.rva) + record.cvRecord.dataSize <= m_file.GetSize()) {
+            const char* name = reinterpret_cast<const char*>(m_file.GetData() + record.cvRecord.rva + nameOffset);
+            std::string pdbPath(name, strnlen(name, record.cvRecord.dataSize - nameOffset));
+
+            size_t slash = pdbPath.find_last_of("\\/");
+            PdbIdentity identity;
+            identity.pdbName = slash == std::string::npos ? pdbPath : pdbPath.substr(slash + 1);
+            identity.guidAge = FormatGuidAge(guid, age);
+            if (!identity.pdbName.empty()) module.identity = std::move(identity);
+        }
+
+        m_modules.push_back(std::move(module));
+    }
+
+    std::sort(m_modules.begin(), m_modules.end(),
+        [](const MinidumpModule& a, const MinidumpModule& b) { return a.base < b.base; });
+}
+
+void Minidump::ReadMemoryList(uint32_t rva, uint32_t size) {
+    uint32_t count = 0;
+    if (!Read(rva, count) || size < sizeof(count) || count > (size - sizeof(count)) / sizeof(MinidumpMemoryDescriptor)) return;
+
+    m_memory.reserve(m_memory.size() + count);
+    for (uint32_t i = 0; i < count; ++i) {
+        MinidumpMemoryDescriptor descriptor{};
+        if (!Read(rva + sizeof(count) + static_cast<size_t>(i) * sizeof(descriptor), descriptor)) break;
+        if (static_cast<uint64_t>(descriptor.memory.rva) + descriptor.memory.dataSize > m_file.GetSize()) continue;
+
+        m_memory.push_back({ descriptor.startOfMemoryRange, descriptor.memory.dataSize, descriptor.memory.rva });
+    }
+}
+
+// Full-memory dumps store every range's bytes back to back from one base offset.
+void Minidump::ReadMemory64List(uint32_t rva, uint32_t size) {
+    MinidumpMemory64Header header{};
+    if (!Read(rva, header) || size < sizeof(header) ||
+        header.rangeCount > (size - sizeof(header)) / sizeof(MinidumpMemoryDescriptor64)) return;
+
+    m_memory.reserve(m_memory.size() + static_cast<size_t>(header.rangeCount));
+    uint64_t fileOffset = header.baseRva;
+    for (uint64_t i = 0; i < header.rangeCount; ++i) {
+        MinidumpMemoryDescriptor64 descriptor{};
+        if (!Read(rva + sizeof(header) + static_cast<size_t>(i) * sizeof(descriptor), descriptor)) break;
+        if (fileOffset > m_file.GetSize() || m_file.GetSize() - fileOffset < descriptor.dataSize) break;
+
+        m_memory.push_back({ descriptor.startOfMemoryRange, descriptor.dataSize, fileOffset });
+        fileOffset += descriptor.dataSize;
+    }
+}
+
+std::optional<size_t> Minidump::FindModuleIndex(DWORD64 address) const noexcept {
+    auto it = std::upper_bound(m_modules.begin(), m_modules.end(), address,
+        [](DWORD64 value, const MinidumpModule& module) { return value < module.base; });
+    if (it == m_modules.begin()) return std::nullopt;
+
+    --it;
+    if (address - it->base >= it->size) return std::nullopt;
+    return static_cast<size_t>(it - m_modules.begin());
+}
+
+void Minidump::ReadThreads(uint32_t rva, uint32_t size, std::optional<DWORD> crashedThread, uint32_t crashContextRva,
+    size_t maxFrames) {
+    uint32_t count = 0;
+    if (!Read(rva, count) || size < sizeof(count) || count > (size - sizeof(count)) / sizeof(MinidumpThreadRecord)) return;
+
+    const ContextLayout layout = GetContextLayout(m_machineType);
+    auto readPointer = [&](size_t offset, DWORD64& value) {
+        if (layout.pointerSize == sizeof(uint32_t)) {
+            uint32_t narrow = 0;
+            if (!Read(offset, narrow)) return false;
+            value = narrow;
+            return true;
+        }
+        return Read(offset, value);
+    };
+
+    m_threads.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        MinidumpThreadRecord record{};
+        if (!Read(rva + sizeof(count) + static_cast<size_t>(i) * sizeof(record), record)) break;
+
+        MinidumpThread thread;
+        thread.threadId = record.threadId;
+        thread.crashed = crashedThread && *crashedThread == record.threadId;
+
+        // The exception stream holds the context at the fault; the thread's own context is the one
+        // inside the exception dispatcher.
+        size_t context = thread.crashed && crashContextRva ? crashContextRva : record.context.rva;
+        DWORD64 pc = 0, sp = 0, link = 0;
+        if (readPointer(context + layout.pc, pc) && pc != 0) {
+            thread.frames.push_back(pc);
+        }
+        if (layout.link != NoLinkRegister && readPointer(context + layout.link, link) && link != 0 && FindModuleIndex(link)) {
+            thread.frames.push_back(link);
+        }
+        thread.contextFrames = thread.frames.size();
+
+        // Without the images' unwind data the caller chain is recovered by scanning: every aligned
+        // stack word from the stack pointer up that lands inside a loaded module is a candidate.
+        if (readPointer(context + layout.sp, sp) && sp >= record.stackStart &&
+            sp - record.stackStart < record.stackMemory.dataSize) {
+            size_t offset = static_cast<size_t>(sp - record.stackStart) & ~(layout.pointerSize - 1);
+            for (; offset + layout.pointerSize <= record.stackMemory.dataSize && thread.frames.size() < maxFrames;
+                offset += layout.pointerSize) {
+                DWORD64 word = 0;
+                if (!readPointer(static_cast<size_t>(record.stackMemory.rva) + offset, word)) break;
+                if (FindModuleIndex(word)) thread.frames.push_back(word);
+            }
+        }
+
+        m_threads.push_back(std::move(thread));
+    }
+
+    std::stable_partition(m_threads.begin(), m_threads.end(), [](const MinidumpThread& thread) { return thread.crashed; });
+}
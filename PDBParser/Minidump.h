@@ -0,0 +1,66 @@
+#pragma once
+#include "MappedFile.h"
+#include "PdbParser.h"
+#include <optional>
+#include <string>
+#include <vector>
+
+struct MinidumpModule {
+    std::wstring path;
+    std::string name;
+    DWORD64 base = 0;
+    DWORD size = 0;
+    std::optional<PdbIdentity> identity;
+};
+
+// A captured block of target memory and where its bytes sit in the dump file.
+struct MinidumpMemoryRange {
+    DWORD64 address = 0;
+    DWORD64 size = 0;
+    uint64_t fileOffset = 0;
+};
+
+struct MinidumpThread {
+    DWORD threadId = 0;
+    bool crashed = false;
+    // Frame 0 (and the link register on ARM64) come from the thread context; the rest are found by
+    // scanning the captured stack for words that point into a loaded module.
+    std::vector<DWORD64> frames;
+    size_t contextFrames = 0;
+};
+
+// Module list and thread stacks of a minidump, read from the mapped file. The constructor throws if
+// the file is not a minidump or its module list cannot be read; threads whose context or stack
+// memory is missing are kept with whatever frames could be recovered.
+class Minidump {
+private:
+    MappedFile m_file;
+    MachineType m_machineType = MachineType::x64;
+    std::vector<MinidumpModule> m_modules;
+    std::vector<MinidumpThread> m_threads;
+    std::vector<MinidumpMemoryRange> m_memory;
+
+    template<typename T>
+    bool Read(size_t offset, T& value) const noexcept;
+
+    std::wstring ReadString(uint32_t rva) const;
+    void ReadModules(uint32_t rva, uint32_t size);
+    void ReadMemoryList(uint32_t rva, uint32_t size);
+    void ReadMemory64List(uint32_t rva, uint32_t size);
+    void ReadThreads(uint32_t rva, uint32_t size, std::optional<DWORD> crashedThread, uint32_t crashContextRva,
+        size_t maxFrames);
+
+public:
+    explicit Minidump(const std::wstring& path, size_t maxFrames = 64);
+
+    Minidump(const Minidump&) = delete;
+    Minidump& operator=(const Minidump&) = delete;
+
+    MachineType GetMachineType() const noexcept { return m_machineType; }
+    const std::vector<MinidumpModule>& GetModules() const noexcept { return m_modules; }
+    const std::vector<MinidumpThread>& GetThreads() const noexcept { return m_threads; }
+    const MappedFile& GetFile() const noexcept { return m_file; }
+    // Sorted by address, from the memory list of a small dump or the Memory64 list of a full one.
+    const std::vector<MinidumpMemoryRange>& GetMemoryRanges() const noexcept { return m_memory; }
+    std::optional<size_t> FindModuleIndex(DWORD64 address) const noexcept;
+};
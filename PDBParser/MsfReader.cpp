@@ -0,0 +1,141 @@
+#include "MsfReader.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    const char MsfMagic[] = "Microsoft C/C++ MSF 7.00\r\n\x1a" "DS\0\0";
+
+#pragma pack(push, 1)
+    struct MsfSuperBlock {
+        char magic[32];
+        uint32_t blockSize;
+        uint32_t freeBlockMapBlock;
+        uint32_t numBlocks;
+        uint32_t numDirectoryBytes;
+        uint32_t unknown;
+        uint32_t blockMapAddr;
+    };
+#pragma pack(pop)
+
+    constexpr uint32_t NilStreamSize = 0xFFFFFFFF;
+}
+
+MsfReader::MsfReader(const std::wstring& pdbPath) : m_file(pdbPath) {
+    if (m_file.GetSize() < sizeof(MsfSuperBlock)) {
+        throw std::runtime_error("PDB file is too small");
+    }
+
+    if (!ReadDirectory()) {
+        throw std::runtime_error("Not an MSF 7.00 PDB file");
+    }
+}
+
+const uint8_t* MsfReader::GetBlock(uint32_t blockIndex) const noexcept {
+    uint64_t offset = static_cast<uint64_t>(blockIndex) * m_blockSize;
+    if (offset + m_blockSize > m_file.GetSize()) return nullptr;
+    return m_file.GetData() + offset;
+}
+
+bool MsfReader::ReadDirectory() {
+    const auto* superBlock = reinterpret_cast<const MsfSuperBlock*>(m_file.GetData());
+    if (memcmp(superBlock->magic, MsfMagic, sizeof(superBlock->magic)) != 0) return false;
+
+    m_blockSize = superBlock->blockSize;
+    if (m_blockSize != 512 && m_blockSize != 1024 && m_blockSize != 2048 && m_blockSize != 4096) return false;
+
+    uint32_t directoryBlockCount = (superBlock->numDirectoryBytes + m_blockSize - 1) / m_blockSize;
+    if (directoryBlockCount == 0 || directoryBlockCount > m_blockSize / sizeof(uint32_t)) return false;
+
+    const uint8_t* blockMap = GetBlock(superBlock->blockMapAddr);
+    if (!blockMap) return false;
+
+    std::vector<uint8_t> directory;
+    directory.reserve(static_cast<size_t>(directoryBlockCount) * m_blockSize);
+
+    for (uint32_t i = 0; i < directoryBlockCount; ++i) {
+        uint32_t blockIndex = 0;
+        memcpy(&blockIndex, blockMap + i * sizeof(uint32_t), sizeof(blockIndex));
+
+        const uint8_t* block = GetBlock(blockIndex);
+        if (!block) return false;
+        directory.insert(directory.end(), block, block + m_blockSize);
+    }
+    directory.resize(superBlock->numDirectoryBytes);
+
+    auto readU32 = [&](size_t& position, uint32_t& value) -> bool {
+        if (position + sizeof(uint32_t) > directory.size()) return false;
+        memcpy(&value, directory.data() + position, sizeof(value));
+        position += sizeof(uint32_t);
+        return true;
+    };
+
+    size_t position = 0;
+    uint32_t streamCount = 0;
+    if (!readU32(position, streamCount)) return false;
+
+    m_streamSizes.resize(streamCount);
+    for (uint32_t i = 0; i < streamCount; ++i) {
+        if (!readU32(position, m_streamSizes[i])) return false;
+    }
+
+    m_streamBlocks.resize(streamCount);
+    for (uint32_t i = 0; i < streamCount; ++i) {
+        if (m_streamSizes[i] == NilStreamSize) continue;
+
+        uint32_t blockCount = (m_streamSizes[i] + m_blockSize - 1) / m_blockSize;
+        m_streamBlocks[i].resize(blockCount);
+        for (uint32_t j = 0; j < blockCount; ++j) {
+            if (!readU32(position, m_streamBlocks[i][j])) return false;
+        }
+    }
+
+    return true;
+}
+
+uint32_t MsfReader::GetStreamSize(uint32_t streamIndex) const noexcept {
+    if (streamIndex >= m_streamSizes.size() || m_streamSizes[streamIndex] == NilStreamSize) return 0;
+    return m_streamSizes[streamIndex];
+}
+
+bool MsfReader::ReadStream(uint32_t streamIndex, std::vector<uint8_t>& data) const {
+    data.clear();
+    if (streamIndex >= m_streamSizes.size() || m_streamSizes[streamIndex] == NilStreamSize) return false;
+
+    uint32_t remaining = m_streamSizes[streamIndex];
+    data.reserve(remaining);
+
+    for (uint32_t blockIndex : m_streamBlocks[streamIndex]) {
+        const uint8_t* block = GetBlock(blockIndex);
+        if (!block) {
+            data.clear();
+            return false;
+        }
+
+        uint32_t chunk = remaining < m_blockSize ? remaining : m_blockSize;
+        data.insert(data.end(), block, block + chunk);
+        remaining -= chunk;
+    }
+
+    return true;
+}
+
+bool MsfReader::ReadStreamRange(uint32_t streamIndex, uint32_t offset, uint32_t length, uint8_t* destination) const {
+    uint32_t streamSize = GetStreamSize(streamIndex);
+    if (offset > streamSize || length > streamSize - offset) return false;
+
+    while (length > 0) {
+        const uint8_t* block = GetBlock(m_streamBlocks[streamIndex][offset / m_blockSize]);
+        if (!block) return false;
+
+        uint32_t blockOffset = offset % m_blockSize;
+        uint32_t chunk = (std::min)(length, m_blockSize - blockOffset);
+        memcpy(destination, block + blockOffset, chunk);
+
+        destination += chunk;
+        offset += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only view of the MSF container a PDB is stored in. The file is memory-mapped and streams are
+// reassembled from their block lists on request.
+class MsfReader {
+private:
+    MappedFile m_file;
+
+    uint32_t m_blockSize = 0;
+    std::vector<uint32_t> m_streamSizes;
+    std::vector<std::vector<uint32_t>> m_streamBlocks;
+
+    const uint8_t* GetBlock(uint32_t blockIndex) const noexcept;
+    bool ReadDirectory();
+
+public:
+    static constexpr uint32_t InvalidStream = 0xFFFF;
+
+    explicit MsfReader(const std::wstring& pdbPath);
+
+    MsfReader(const MsfReader&) = delete;
+    MsfReader& operator=(const MsfReader&) = delete;
+
+    uint32_t GetStreamCount() const noexcept { return static_cast<uint32_t>(m_streamSizes.size()); }
+    uint32_t GetStreamSize(uint32_t streamIndex) const noexcept;
+    bool ReadStream(uint32_t streamIndex, std::vector<uint8_t>& data) const;
+
+    // Copies [offset, offset + length) of a stream, touching only the blocks that range spans.
+    bool ReadStreamRange(uint32_t streamIndex, uint32_t offset, uint32_t length, uint8_t* destination) const;
+};
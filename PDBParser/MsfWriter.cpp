@@ -0,0 +1,154 @@
+#include "MsfWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    const char MsfMagic[] = "Microsoft C/C++ MSF 7.00\r\n\x1a" "DS\0\0";
+
+#pragma pack(push, 1)
+    struct MsfSuperBlock {
+        char magic[32];
+        uint32_t blockSize;
+        uint32_t freeBlockMapBlock;
+        uint32_t numBlocks;
+        uint32_t numDirectoryBytes;
+        uint32_t unknown;
+        uint32_t blockMapAddr;
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(MsfSuperBlock) == 56, "MSF superblock layout");
+}
+
+MsfWriter::MsfWriter(const std::wstring& path)
+    : m_file(path, std::ios::binary | std::ios::trunc) {
+    if (!m_file.is_open()) {
+        throw std::runtime_error("Failed to create MSF file");
+    }
+}
+
+// Blocks 1 and 2 of every BlockSize-block interval hold the two free block maps.
+uint32_t MsfWriter::AllocateBlock() noexcept {
+    while (m_blockCount % BlockSize == 1 || m_blockCount % BlockSize == 2) {
+        m_blockCount++;
+    }
+    return m_blockCount++;
+}
+
+void MsfWriter::WriteBlock(uint32_t blockIndex, const uint8_t* data, size_t size) {
+    static const uint8_t zeros[BlockSize] = {};
+    m_file.seekp(static_cast<std::streamoff>(blockIndex) * BlockSize);
+    m_file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    m_file.write(reinterpret_cast<const char*>(zeros), static_cast<std::streamsize>(BlockSize - size));
+}
+
+uint32_t MsfWriter::ReserveStream() {
+    m_streamSizes.push_back(0);
+    m_streamBlocks.emplace_back();
+    return static_cast<uint32_t>(m_streamSizes.size() - 1);
+}
+
+void MsfWriter::BeginStream(uint32_t streamIndex) {
+    EndStream();
+    m_currentStream = streamIndex;
+    m_streamSizes[streamIndex] = 0;
+    m_streamBlocks[streamIndex].clear();
+    m_pending.reserve(BlockSize);
+}
+
+void MsfWriter::FlushPending() {
+    uint32_t block = AllocateBlock();
+    WriteBlock(block, m_pending.data(), m_pending.size());
+    m_streamBlocks[m_currentStream].push_back(block);
+    m_streamSizes[m_currentStream] += static_cast<uint32_t>(m_pending.size());
+    m_pending.clear();
+}
+
+void MsfWriter::Write(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        size_t chunk = (std::min)(size, BlockSize - m_pending.size());
+        m_pending.insert(m_pending.end(), bytes, bytes + chunk);
+        bytes += chunk;
+        size -= chunk;
+
+        if (m_pending.size() == BlockSize) {
+            FlushPending();
+        }
+    }
+}
+
+void MsfWriter::EndStream() {
+    if (m_currentStream == UINT32_MAX) return;
+    if (!m_pending.empty()) {
+        FlushPending();
+    }
+    m_currentStream = UINT32_MAX;
+}
+
+void MsfWriter::WriteStream(uint32_t streamIndex, const std::vector<uint8_t>& data) {
+    BeginStream(streamIndex);
+    Write(data.data(), data.size());
+    EndStream();
+}
+
+bool MsfWriter::Close() {
+    EndStream();
+
+    std::vector<uint8_t> directory;
+    auto append = [&](uint32_t value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        directory.insert(directory.end(), bytes, bytes + sizeof(value));
+    };
+
+    append(static_cast<uint32_t>(m_streamSizes.size()));
+    for (uint32_t size : m_streamSizes) append(size);
+    for (const auto& blocks : m_streamBlocks) {
+        for (uint32_t block : blocks) append(block);
+    }
+
+    std::vector<uint32_t> directoryBlocks;
+    for (size_t offset = 0; offset < directory.size(); offset += BlockSize) {
+        uint32_t block = AllocateBlock();
+        WriteBlock(block, directory.data() + offset, (std::min)(directory.size() - offset, size_t{ BlockSize }));
+        directoryBlocks.push_back(block);
+    }
+    if (directoryBlocks.size() > BlockSize / sizeof(uint32_t)) return false;
+
+    uint32_t blockMap = AllocateBlock();
+    WriteBlock(blockMap, reinterpret_cast<const uint8_t*>(directoryBlocks.data()), directoryBlocks.size() * sizeof(uint32_t));
+
+    // Every block up to the end of the file is in use. The map is one bit per block spread over the
+    // map blocks of successive intervals; bits past the end of the file mark free blocks.
+    uint32_t numBlocks = m_blockCount;
+    uint32_t intervals = (numBlocks - 1 + BlockSize - 1) / BlockSize;
+    std::vector<uint8_t> freeMap(BlockSize);
+
+    for (uint32_t interval = 0; interval < intervals; ++interval) {
+        uint64_t firstBit = static_cast<uint64_t>(interval) * BlockSize * 8;
+        for (uint32_t byte = 0; byte < BlockSize; ++byte) {
+            uint64_t bit = firstBit + static_cast<uint64_t>(byte) * 8;
+            uint8_t value = 0;
+            for (uint32_t i = 0; i < 8; ++i) {
+                if (bit + i >= numBlocks) value |= static_cast<uint8_t>(1u << i);
+            }
+            freeMap[byte] = value;
+        }
+
+        WriteBlock(interval * BlockSize + 1, freeMap.data(), freeMap.size());
+        WriteBlock(interval * BlockSize + 2, freeMap.data(), freeMap.size());
+    }
+
+    MsfSuperBlock superBlock{};
+    memcpy(superBlock.magic, MsfMagic, sizeof(superBlock.magic));
+    superBlock.blockSize = BlockSize;
+    superBlock.freeBlockMapBlock = 1;
+    superBlock.numBlocks = numBlocks;
+    superBlock.numDirectoryBytes = static_cast<uint32_t>(directory.size());
+    superBlock.blockMapAddr = blockMap;
+    WriteBlock(0, reinterpret_cast<const uint8_t*>(&superBlock), sizeof(superBlock));
+
+    m_file.close();
+    return !m_file.fail();
+}
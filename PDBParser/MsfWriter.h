@@ -0,0 +1,46 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Writes an MSF 7.00 container block by block. Streams are reserved up front so their indices can be
+// referenced before they are written, then filled one at a time; only the block being filled is held
+// in memory. Close() writes the stream directory, the free block maps and the superblock. The
+// constructor throws if the file cannot be created.
+class MsfWriter {
+private:
+    static constexpr uint32_t BlockSize = 4096;
+
+    std::ofstream m_file;
+    uint32_t m_blockCount = 3;
+    std::vector<uint32_t> m_streamSizes;
+    std::vector<std::vector<uint32_t>> m_streamBlocks;
+
+    uint32_t m_currentStream = UINT32_MAX;
+    std::vector<uint8_t> m_pending;
+
+    uint32_t AllocateBlock() noexcept;
+    void WriteBlock(uint32_t blockIndex, const uint8_t* data, size_t size);
+    void FlushPending();
+
+public:
+    explicit MsfWriter(const std::wstring& path);
+
+    MsfWriter(const MsfWriter&) = delete;
+    MsfWriter& operator=(const MsfWriter&) = delete;
+
+    uint32_t ReserveStream();
+    void BeginStream(uint32_t streamIndex);
+    void Write(const void* data, size_t size);
+    void EndStream();
+    void WriteStream(uint32_t streamIndex, const std::vector<uint8_t>& data);
+
+    template<typename T>
+    void WriteValue(const T& value) {
+        Write(&value, sizeof(value));
+    }
+
+    bool Close();
+};
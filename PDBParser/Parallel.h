@@ -0,0 +1,92 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+template<typename Func>
+void RunParallel(size_t count, size_t maxThreads, const Func& work) {
+    if (count == 0) return;
+
+    size_t threadCount = maxThreads ? maxThreads : std::thread::hardware_concurrency();
+    threadCount = (std::max<size_t>)(1, (std::min)(threadCount, count));
+
+    if (threadCount == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            work(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{ 0 };
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+
+    for (size_t t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                work(i);
+            }
+            });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// Blocking FIFO with a fixed capacity, used to connect pipeline stages. Push blocks while the queue
+// is full so a fast producer cannot run ahead of its consumers; Close() lets consumers drain what is
+// left and then makes Pop() return nullopt.
+template<typename T>
+class BoundedQueue {
+private:
+    std::mutex m_lock;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    std::deque<T> m_items;
+    size_t m_capacity;
+    bool m_closed = false;
+
+public:
+    explicit BoundedQueue(size_t capacity) : m_capacity((std::max<size_t>)(1, capacity)) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    bool Push(T item) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_notFull.wait(lock, [&]() { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed) return false;
+
+        m_items.push_back(std::move(item));
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    std::optional<T> Pop() {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_notEmpty.wait(lock, [&]() { return m_closed || !m_items.empty(); });
+        if (m_items.empty()) return std::nullopt;
+
+        T item = std::move(m_items.front());
+        m_items.pop_front();
+        lock.unlock();
+        m_notFull.notify_one();
+        return item;
+    }
+
+    void Close() {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_closed = true;
+        }
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <memory_resource>
+#include <cstddef>
+
+class CountingResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* m_upstream;
+    size_t m_allocations = 0;
+    size_t m_bytes = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++m_allocations;
+        m_bytes += bytes;
+        return m_upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        m_upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_upstream(upstream) {}
+
+    size_t GetAllocations() const noexcept { return m_allocations; }
+    size_t GetBytes() const noexcept { return m_bytes; }
+};
+
+// Monotonic arena for objects that only live for one parse or query. Everything allocated from it
+// is released at once when the arena goes out of scope or Release() is called. Layout hashing is the
+// only user; decoded structs, enums and functions outlive their pass in the caches and stay on the heap.
+class ParseArena {
+private:
+    CountingResource m_upstream;
+    std::pmr::monotonic_buffer_resource m_arena;
+
+public:
+    explicit ParseArena(size_t initialSize = 64 * 1024)
+        : m_upstream(), m_arena(initialSize, &m_upstream) {}
+
+    ParseArena(const ParseArena&) = delete;
+    ParseArena& operator=(const ParseArena&) = delete;
+
+    std::pmr::memory_resource* GetResource() noexcept { return &m_arena; }
+    operator std::pmr::memory_resource*() noexcept { return &m_arena; }
+
+    size_t GetBlockAllocations() const noexcept { return m_upstream.GetAllocations(); }
+    size_t GetBytesReserved() const noexcept { return m_upstream.GetBytes(); }
+
+    void Release() noexcept { m_arena.release(); }
+};
@@ -1,12 +1,23 @@
 ﻿#include "PdbAnalyzer.h"
+#include "ColumnarExport.h"
+#include "MemoryWalker.h"
+#include "QueryScript.h"
+#include "ReducedPdb.h"
+#include "Trace.h"
 #include <iostream>
 #include <chrono>
 #include <iomanip>
 #include <filesystem>
-
-PdbAnalyzer::PdbAnalyzer(const std::wstring& pdbPath) {
+#include <cwchar>
+#include <cstring>
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <thread>
+
+PdbAnalyzer::PdbAnalyzer(const std::wstring& pdbPath, OpenMode openMode) {
     try {
-        m_parser = std::make_unique<PdbParser>(pdbPath);
+        m_parser = std::make_unique<PdbParser>(pdbPath, openMode);
         if (!m_parser->IsInitialized()) {
             throw std::runtime_error("Failed to initialize PDB parser");
         }
@@ -41,6 +52,34 @@ void PdbAnalyzer::PrintStructInfo(const StructInfo& structInfo) const {
     }
 }
 
+void PdbAnalyzer::PrintGlobalInfo(const GlobalSymbolInfo& global) const {
+    std::cout << std::hex << "0x" << std::setw(8) << std::setfill('0') << global.rva
+        << " | " << std::setw(4) << global.section << ":" << std::setw(8) << global.offset
+        << " | " << (global.isThreadLocal ? "tls    " : global.isStatic ? "static " : "global ")
+        << " | " << global.typeName << " " << global.name << "\n" << std::dec;
+}
+
+void PdbAnalyzer::PrintFunctionVariable(const FunctionVariable& variable) const {
+    std::cout << "  ";
+    if (variable.locationType == LocIsRegRel) {
+        std::cout << "[reg " << variable.registerId << (variable.offset < 0 ? " - 0x" : " + 0x")
+            << std::hex << (variable.offset < 0 ? -static_cast<int64_t>(variable.offset) : variable.offset)
+            << std::dec << "]";
+    }
+    else if (variable.locationType == LocIsEnregistered) {
+        std::cout << "[reg " << variable.registerId << "]";
+    }
+    else {
+        std::cout << "[-]";
+    }
+
+    std::cout << " " << variable.typeName;
+    if (!variable.name.empty()) {
+        std::cout << " " << variable.name;
+    }
+    std::cout << " (" << variable.size << " bytes)\n";
+}
+
 void PdbAnalyzer::ShowBasicInfo() const {
     PrintHeader("PDB Basic Information");
 
@@ -101,6 +140,63 @@ void PdbAnalyzer::FindSpecificSymbol(const std::wstring& symbolName) const {
     }
 }
 
+void PdbAnalyzer::FindGlobalSymbol(const std::wstring& name) const {
+    PrintHeader("Global Data Lookup");
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto global = m_parser->GetGlobalSymbol(name);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    std::wcout << L"Searching for: " << name << L"\n";
+    std::cout << "Lookup time: " << duration.count() << "μs\n";
+
+    if (global) {
+        std::cout << "Type:     " << global->typeName << " (" << std::dec << global->size << " bytes)\n";
+        std::cout << "Scope:    " << (global->isThreadLocal ? "thread-local" : global->isStatic ? "file static" : "global") << "\n";
+        std::cout << "Address:  " << std::hex << std::setfill('0') << std::setw(4) << global->section << ":"
+            << std::setw(8) << global->offset << "\n";
+        if (!global->isThreadLocal) {
+            std::cout << "RVA:      0x" << global->rva << "\n";
+        }
+        std::cout << std::dec;
+    }
+    else {
+        std::cout << "Global not found\n";
+    }
+}
+
+void PdbAnalyzer::SearchGlobals(const std::wstring& pattern, size_t maxResults) const {
+    PrintHeader("Global Data Search");
+
+    std::wcout << L"Pattern: " << pattern << L"\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto matches = m_parser->FindGlobalsByPattern(pattern);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Found " << matches.size() << " matches in "
+        << duration.count() << "ms\n\n";
+
+    PrintGlobalMatches(matches, maxResults);
+}
+
+void PdbAnalyzer::PrintGlobalMatches(const std::vector<GlobalSymbolInfo>& matches, size_t maxResults) const {
+    std::cout << "RVA        | Sect:Offset   | Scope   | Type Name\n";
+    std::cout << std::string(60, '-') << "\n";
+
+    size_t count = 0;
+    for (const auto& match : matches) {
+        if (count++ >= maxResults) {
+            std::cout << "... and " << (matches.size() - maxResults) << " more\n";
+            break;
+        }
+        PrintGlobalInfo(match);
+    }
+}
+
 void PdbAnalyzer::AnalyzeStructure(const std::wstring& structName) const {
     PrintHeader("Structure Analysis");
 
@@ -113,6 +209,93 @@ void PdbAnalyzer::AnalyzeStructure(const std::wstring& structName) const {
     }
 }
 
+void PdbAnalyzer::AnalyzeFunction(const std::wstring& functionName) const {
+    PrintHeader("Function Analysis");
+
+    auto function = m_parser->GetFunctionInfo(functionName);
+    if (!function) {
+        std::wcout << L"Function not found: " << functionName << L"\n";
+        return;
+    }
+
+    std::cout << function->returnType << " " << function->callingConvention << " " << function->name << "\n";
+    std::cout << "RVA: 0x" << std::hex << function->rva << ", Length: 0x" << function->length << std::dec << "\n";
+
+    const auto& frame = function->frame;
+    std::cout << "Frame: " << frame.frameSize << " bytes"
+        << (frame.framePointerPresent ? ", frame pointer" : "")
+        << (frame.hasAlloca ? ", alloca" : "")
+        << (frame.hasSEH ? ", SEH" : "")
+        << (frame.hasEH ? ", C++ EH" : "") << "\n";
+
+    if (frame.hasFrameData) {
+        std::cout << "Frame data: locals " << frame.lengthLocals << ", params " << frame.lengthParams
+            << ", saved registers " << frame.lengthSavedRegisters << ", prolog " << frame.lengthProlog
+            << ", max stack " << frame.maxStack << "\n";
+    }
+
+    std::cout << "\nParameters (" << function->parameters.size() << "):\n";
+    for (const auto& parameter : function->parameters) {
+        PrintFunctionVariable(parameter);
+    }
+
+    std::cout << "\nLocals (" << function->locals.size() << "):\n";
+    for (const auto& local : function->locals) {
+        PrintFunctionVariable(local);
+    }
+}
+
+void PdbAnalyzer::AnalyzeEnum(const std::wstring& enumName) const {
+    PrintHeader("Enum Analysis");
+
+    auto enumInfo = m_parser->GetEnumInfo(enumName);
+    if (!enumInfo) {
+        std::wcout << L"Enum not found: " << enumName << L"\n";
+        return;
+    }
+
+    std::cout << "Enum: " << enumInfo->name << " (Size: " << std::dec << enumInfo->size
+        << " bytes, " << enumInfo->values.size() << " values)\n";
+
+    for (const auto& value : enumInfo->values) {
+        std::cout << "  " << std::setw(20) << std::setfill(' ') << value.value
+            << " | 0x" << std::hex << std::setw(8) << std::setfill('0') << static_cast<uint64_t>(value.value)
+            << std::dec << " | " << value.name << "\n";
+    }
+}
+
+void PdbAnalyzer::DecodeEnumValue(const std::wstring& enumName, const std::wstring& valueText) const {
+    PrintHeader("Enum Value Decode");
+
+    uint64_t value = std::wcstoull(valueText.c_str(), nullptr, 0);
+    if (!valueText.empty() && valueText[0] == L'-') {
+        value = static_cast<uint64_t>(std::wcstoll(valueText.c_str(), nullptr, 0));
+    }
+
+    auto name = m_parser->GetEnumValueName(enumName, static_cast<int64_t>(value));
+    std::wcout << enumName << L"(" << valueText << L") = ";
+
+    if (name) {
+        std::cout << *name << "\n";
+        return;
+    }
+
+    uint64_t remainder = 0;
+    auto flags = m_parser->DecomposeEnumFlags(enumName, value, &remainder);
+    if (flags.empty()) {
+        std::cout << "<no matching value>\n";
+        return;
+    }
+
+    for (size_t i = 0; i < flags.size(); ++i) {
+        std::cout << (i > 0 ? " | " : "") << flags[i];
+    }
+    if (remainder != 0) {
+        std::cout << " | 0x" << std::hex << remainder << std::dec;
+    }
+    std::cout << "\n";
+}
+
 void PdbAnalyzer::FindStructMember(const std::wstring& structName, const std::wstring& memberName) const {
     PrintHeader("Structure Member Lookup");
 
@@ -128,6 +311,340 @@ void PdbAnalyzer::FindStructMember(const std::wstring& structName, const std::ws
     }
 }
 
+void PdbAnalyzer::ResolveFieldPath(const std::wstring& path) const {
+    PrintHeader("Field Path");
+
+    std::wcout << L"Path: " << path << L"\n";
+
+    auto fieldPath = m_parser->CompileFieldPath(path);
+    if (!fieldPath) {
+        std::cout << "Path could not be resolved\n";
+        return;
+    }
+
+    for (size_t i = 0; i < fieldPath->offsets.size(); ++i) {
+        std::cout << (i == 0 ? "Offset: +0x" : "  -> +0x") << std::hex << fieldPath->offsets[i] << std::dec << "\n";
+    }
+    if (!fieldPath->IsDirect()) {
+        std::cout << "Dereferences: " << fieldPath->offsets.size() - 1 << " (" << fieldPath->pointerSize << "-byte pointers)\n";
+    }
+
+    std::cout << "Size: " << fieldPath->size << " bytes\n";
+    if (fieldPath->IsBitfield()) {
+        std::cout << "Bitfield: bits " << fieldPath->bitPosition << ".."
+            << fieldPath->bitPosition + fieldPath->bitLength - 1 << "\n";
+    }
+    if (!fieldPath->typeName.empty()) {
+        std::cout << "Type: " << fieldPath->typeName << "\n";
+    }
+}
+
+namespace {
+    // Wide fields print as a quoted string when they hold printable text up to a NUL (ImageFileName,
+    // fixed name buffers), otherwise as their leading bytes.
+    std::string FormatWideField(const MemoryImage& image, DWORD64 address, DWORD64 size) {
+        uint8_t bytes[64] = {};
+        size_t length = static_cast<size_t>((std::min<DWORD64>)(size, sizeof(bytes)));
+        if (!image.Read(address, bytes, length)) return "?";
+
+        size_t text = 0;
+        while (text < length && bytes[text] >= 0x20 && bytes[text] < 0x7F) ++text;
+        if (text > 0 && (text == length || bytes[text] == 0)) {
+            return "\"" + std::string(reinterpret_cast<const char*>(bytes), text) + "\"";
+        }
+
+        std::string hex;
+        char buffer[4];
+        for (size_t i = 0; i < (std::min<size_t>)(length, 16); ++i) {
+            sprintf_s(buffer, "%02x", bytes[i]);
+            hex += buffer;
+        }
+        return hex + (length > 16 ? ".." : "");
+    }
+}
+
+void PdbAnalyzer::WalkMemory(const std::wstring& imageSpec, const std::wstring& head, const std::wstring& linkPath,
+    const std::wstring& fieldList) const {
+    PrintHeader("Memory Walk");
+
+    std::wstring imagePath = imageSpec;
+    DWORD64 flatBase = 0;
+    size_t at = imagePath.rfind(L'@');
+    if (at != std::wstring::npos) {
+        flatBase = std::wcstoull(imagePath.c_str() + at + 1, nullptr, 0);
+        imagePath = imagePath.substr(0, at);
+    }
+
+    std::unique_ptr<MemoryImage> image;
+    try {
+        image = std::make_unique<MemoryImage>(imagePath, flatBase);
+    }
+    catch (const std::exception& e) {
+        std::cout << "Cannot open memory image: " << e.what() << "\n";
+        return;
+    }
+
+    DWORD64 imageBytes = 0;
+    for (const auto& range : image->GetRanges()) imageBytes += range.size;
+    std::wcout << L"Image: " << imagePath << (image->GetMinidump() ? L" (minidump, " : L" (flat, ")
+        << image->GetRanges().size() << L" ranges, " << imageBytes / (1024 * 1024) << L" MB)\n";
+
+    // The head is an address, or a symbol of this PDB placed at the base of the matching module in a
+    // minidump's module list.
+    wchar_t* parsed = nullptr;
+    DWORD64 headAddress = std::wcstoull(head.c_str(), &parsed, 0);
+    if (head.empty() || *parsed != L'\0') {
+        auto rva = m_parser->GetSymbolRva(head);
+        std::optional<DWORD64> moduleBase;
+        if (image->GetMinidump()) {
+            std::string pdbName = WStringToString(std::filesystem::path(m_parser->GetPdbPath()).filename().wstring());
+            auto sameName = [](char x, char y) {
+                return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+            };
+            for (const auto& module : image->GetMinidump()->GetModules()) {
+                if (module.identity && module.identity->pdbName.size() == pdbName.size() &&
+                    std::equal(pdbName.begin(), pdbName.end(), module.identity->pdbName.begin(), sameName)) {
+                    moduleBase = module.base;
+                    break;
+                }
+            }
+        }
+
+        if (!rva || !moduleBase) {
+            std::wcout << L"Cannot place list head: " << head
+                << (rva ? L" (no module in the image matches this PDB)" : L" (symbol not found)") << L"\n";
+            return;
+        }
+        headAddress = *moduleBase + *rva;
+    }
+
+    std::wstring typeName = linkPath.substr(0, linkPath.find(L'.'));
+    std::vector<FieldPath> fields;
+    std::vector<std::string> columns;
+    if (fieldList != L"-") {
+        size_t position = 0;
+        while (position <= fieldList.size()) {
+            size_t comma = fieldList.find(L',', position);
+            std::wstring field = fieldList.substr(position, comma == std::wstring::npos ? std::wstring::npos : comma - position);
+            position = comma == std::wstring::npos ? fieldList.size() + 1 : comma + 1;
+            if (field.empty()) continue;
+
+            auto path = m_parser->CompileFieldPath(typeName + L"." + field);
+            if (!path) {
+                std::wcout << L"Field path could not be resolved: " << typeName << L"." << field << L"\n";
+                return;
+            }
+            fields.push_back(std::move(*path));
+            columns.push_back(WStringToString(field));
+        }
+    }
+
+    MemoryWalker walker(*m_parser, *image);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto entries = walker.WalkList(headAddress, linkPath);
+    if (!entries) {
+        std::wcout << L"Link member could not be resolved: " << linkPath << L"\n";
+        return;
+    }
+
+    FieldTable table;
+    walker.ReadFields(*entries, fields, table);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::wcout << L"List head: " << head << L" = 0x" << std::hex << headAddress << std::dec << L"\n";
+    std::wcout << L"Entries: " << entries->size() << L"\n\n";
+
+    std::cout << std::left << std::setw(20) << "Address";
+    for (const auto& column : columns) std::cout << "  " << std::setw(18) << column;
+    std::cout << "\n";
+
+    for (size_t row = 0; row < entries->size(); ++row) {
+        std::ostringstream address;
+        address << "0x" << std::hex << (*entries)[row];
+
+        std::ostringstream line;
+        line << std::left << std::setw(20) << address.str();
+        for (size_t column = 0; column < fields.size(); ++column) {
+            std::string value = "?";
+            if (table.Has(row, column)) {
+                if (fields[column].size > sizeof(uint64_t)) {
+                    value = FormatWideField(*image, table.Get(row, column), fields[column].size);
+                }
+                else {
+                    std::ostringstream number;
+                    number << "0x" << std::hex << table.Get(row, column);
+                    value = number.str();
+                }
+            }
+            line << "  " << std::setw(18) << value;
+        }
+        std::cout << line.str() << "\n";
+    }
+    std::cout << std::right;
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    std::cout << "\nWalked " << entries->size() << " entries and read " << entries->size() * fields.size()
+        << " fields in " << duration.count() << "us\n";
+}
+
+void PdbAnalyzer::ShowLayoutHash(const std::wstring& structName) const {
+    PrintHeader("Structure Layout Hash");
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto layoutHash = m_parser->GetLayoutHash(structName);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    std::wcout << L"Struct: " << structName << L"\n";
+    std::cout << "Hash pass: " << m_parser->ComputeLayoutHashes().size() << " types in "
+        << duration.count() << "ms\n";
+
+    if (layoutHash) {
+        std::cout << "Layout hash: " << layoutHash->ToString() << "\n";
+    }
+    else {
+        std::cout << "Structure not found\n";
+    }
+}
+
+void PdbAnalyzer::ReportLayouts(size_t maxResults) const {
+    PrintHeader("Layout Efficiency Report");
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto reports = m_parser->AnalyzeLayouts();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    DWORD64 totalWaste = 0;
+    size_t totalStraddlers = 0, wasteful = 0;
+    for (const auto& report : reports) {
+        totalWaste += report.wastedBytes;
+        totalStraddlers += report.straddlers.size();
+        if (report.wastedBytes > 0 || !report.straddlers.empty()) wasteful++;
+    }
+
+    std::cout << "Analyzed " << reports.size() << " UDTs in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms: "
+        << wasteful << " with waste or split members, " << totalWaste << " bytes wasted, "
+        << totalStraddlers << " members straddling a 64-byte line\n\n";
+
+    std::cout << " Waste |   Size | Lines (packed) | Holes | Straddlers | Name\n";
+
+    size_t shown = 0;
+    for (const auto& report : reports) {
+        if (report.wastedBytes == 0 && report.straddlers.empty()) break;
+        if (maxResults != 0 && shown++ >= maxResults) {
+            std::cout << "... and " << (wasteful - maxResults) << " more\n";
+            break;
+        }
+
+        std::cout << std::setw(6) << std::setfill(' ') << report.wastedBytes << " | "
+            << std::setw(6) << report.size << " | "
+            << std::setw(5) << report.cacheLines << " (" << report.packedCacheLines << ")      | "
+            << std::setw(5) << report.holes.size() << " | "
+            << std::setw(10) << report.straddlers.size() << " | "
+            << (report.isUnion ? "union " : "") << report.name << "\n";
+
+        for (const auto& hole : report.holes) {
+            std::cout << "         hole of " << hole.bitSize / 8 << " bytes";
+            if (hole.bitSize % 8) std::cout << " " << hole.bitSize % 8 << " bits";
+            std::cout << " at +0x" << std::hex << hole.bitOffset / 8 << std::dec;
+            if (hole.bitOffset % 8) std::cout << "." << hole.bitOffset % 8;
+            std::cout << (hole.after.empty() ? "" : " after ") << hole.after << "\n";
+        }
+        if (report.tailPadding) {
+            std::cout << "         tail padding " << report.tailPadding << " bytes\n";
+        }
+        for (const auto& straddler : report.straddlers) {
+            std::cout << "         " << straddler.member << " at +0x" << std::hex << straddler.offset << std::dec
+                << " (" << straddler.size << " bytes) crosses into line " << (straddler.offset + straddler.size - 1) / 64 << "\n";
+        }
+    }
+}
+
+void PdbAnalyzer::AnalyzeClass(const std::wstring& className) const {
+    PrintHeader("Class Hierarchy");
+
+    const ClassHierarchy* hierarchy = m_parser->GetClassHierarchy();
+    auto classId = hierarchy ? hierarchy->FindClass(WStringToString(className)) : std::nullopt;
+    if (!classId) {
+        std::wcout << L"Class '" << className << L"' not found\n";
+        return;
+    }
+
+    const ClassNode& node = hierarchy->GetClass(*classId);
+    std::cout << "Class: " << node.name << " (" << node.size << " bytes)\n";
+
+    size_t count = 0;
+    const ClassBase* bases = hierarchy->GetBases(*classId, count);
+    std::cout << "\nBases (" << count << "):\n";
+    for (size_t i = 0; i < count; ++i) {
+        const ClassBase& base = bases[i];
+        if (base.isVirtual) {
+            std::cout << "  " << (base.isIndirect ? "indirect virtual " : "virtual ") << hierarchy->GetClass(base.classId).name
+                << " (vbptr +0x" << std::hex << base.vbptrOffset << std::dec << ", vbtable index " << base.vbtableIndex << ")\n";
+        }
+        else {
+            std::cout << "  +0x" << std::hex << base.offset << std::dec << " " << hierarchy->GetClass(base.classId).name << "\n";
+        }
+    }
+
+    const uint32_t* derived = hierarchy->GetDerived(*classId, count);
+    std::cout << "\nDirect subclasses (" << count << "):\n";
+    for (size_t i = 0; i < count; ++i) {
+        std::cout << "  " << hierarchy->GetClass(derived[i]).name << "\n";
+    }
+
+    const VirtualSlot* slots = hierarchy->GetVtable(*classId, count);
+    std::cout << "\nVirtual slots (" << count << "):\n";
+    for (size_t i = 0; i < count; ++i) {
+        const VirtualSlot& slot = slots[i];
+        std::cout << "  vftable +0x" << std::hex << slot.vftableOffset << std::dec << " [" << slot.slot << "] "
+            << hierarchy->GetMethodName(slot) << (slot.isPure ? " = 0" : "")
+            << " (" << hierarchy->GetClass(slot.definedBy).name;
+        if (slot.introducedBy != slot.definedBy) {
+            std::cout << ", introduced by " << hierarchy->GetClass(slot.introducedBy).name;
+        }
+        std::cout << ")\n";
+    }
+}
+
+void PdbAnalyzer::ListSubclasses(const std::wstring& className) const {
+    PrintHeader("Subclasses");
+
+    const ClassHierarchy* hierarchy = m_parser->GetClassHierarchy();
+    auto classId = hierarchy ? hierarchy->FindClass(WStringToString(className)) : std::nullopt;
+    if (!classId) {
+        std::wcout << L"Class '" << className << L"' not found\n";
+        return;
+    }
+
+    auto subclasses = hierarchy->GetSubclasses(*classId);
+    std::cout << subclasses.size() << " classes derive from " << hierarchy->GetClass(*classId).name << "\n";
+    for (uint32_t subclass : subclasses) {
+        std::cout << "  " << hierarchy->GetClass(subclass).name << "\n";
+    }
+}
+
+void PdbAnalyzer::FindOverrides(const std::wstring& className, DWORD slot) const {
+    PrintHeader("Slot Overrides");
+
+    const ClassHierarchy* hierarchy = m_parser->GetClassHierarchy();
+    auto classId = hierarchy ? hierarchy->FindClass(WStringToString(className)) : std::nullopt;
+    if (!classId) {
+        std::wcout << L"Class '" << className << L"' not found\n";
+        return;
+    }
+
+    auto overriders = hierarchy->FindOverrides(*classId, slot);
+    std::cout << overriders.size() << " subclasses of " << hierarchy->GetClass(*classId).name
+        << " override slot " << slot << "\n";
+    for (uint32_t overrider : overriders) {
+        std::cout << "  " << hierarchy->GetClass(overrider).name << "\n";
+    }
+}
+
 void PdbAnalyzer::SearchByPattern(const std::wstring& pattern, size_t maxResults) const {
     PrintHeader("Pattern Search");
 
@@ -141,6 +658,10 @@ void PdbAnalyzer::SearchByPattern(const std::wstring& pattern, size_t maxResults
     std::cout << "Found " << matches.size() << " matches in "
         << duration.count() << "ms\n\n";
 
+    PrintSymbolMatches(matches, maxResults);
+}
+
+void PdbAnalyzer::PrintSymbolMatches(const std::vector<SymbolInfo>& matches, size_t maxResults) const {
     std::cout << std::hex << "RVA      | Size     | Symbol Name\n";
     std::cout << std::string(60, '-') << "\n";
 
@@ -171,6 +692,13 @@ void PdbAnalyzer::PerformanceTest() const {
 
     std::cout << "Symbol preload time: " << preloadTime.count() << "ms\n";
 
+    start = std::chrono::high_resolution_clock::now();
+    m_parser->PreloadStructures();
+    end = std::chrono::high_resolution_clock::now();
+    auto structPreloadTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    std::cout << "Structure preload time: " << structPreloadTime.count() << "ms\n";
+
     if (!symbols.empty()) {
         std::wstring testSymbol(symbols[symbols.size() / 2].name.begin(),
             symbols[symbols.size() / 2].name.end());
@@ -214,60 +742,442 @@ void PdbAnalyzer::ExportResults(const std::wstring& outputPath) const {
     }
 }
 
-#include <wininet.h>
-#pragma comment(lib, "wininet.lib")
+void PdbAnalyzer::ExportColumnar(const std::wstring& outputPath) const {
+    PrintHeader("Columnar Export");
 
-std::string PdbDownloader::ExtractPdbInfo(const std::wstring& exePath) {
-    HANDLE hFile = CreateFileW(exePath.c_str(), GENERIC_READ, FILE_SHARE_READ,
-        nullptr, OPEN_EXISTING, 0, nullptr);
-    if (hFile == INVALID_HANDLE_VALUE) return "";
+    std::wcout << L"Exporting to: " << outputPath << L"\n";
 
-    HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
-    if (!hMapping) { CloseHandle(hFile); return ""; }
+    auto start = std::chrono::high_resolution_clock::now();
+    bool success = ColumnarExporter::Export(*m_parser, outputPath);
+    auto end = std::chrono::high_resolution_clock::now();
 
-    LPVOID pBase = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
-    if (!pBase) { CloseHandle(hMapping); CloseHandle(hFile); return ""; }
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    if (success) {
+        std::cout << "Export successful (" << std::filesystem::file_size(outputPath)
+            << " bytes in " << duration.count() << "ms)\n";
+    }
+    else {
+        std::cout << "Export failed\n";
+    }
+}
+
+void PdbAnalyzer::ExportFunctions(const std::wstring& outputPath) const {
+    if (outputPath == L"-") {
+        if (!m_parser->ExportFunctions(outputPath)) {
+            std::cerr << "Function export failed\n";
+        }
+        return;
+    }
+
+    PrintHeader("Function Export");
+
+    std::wcout << L"Decoding all functions to: " << outputPath << L"\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bool success = m_parser->ExportFunctions(outputPath);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    if (success) {
+        std::cout << "Export successful (" << std::filesystem::file_size(outputPath)
+            << " bytes in " << duration.count() << "ms)\n";
+    }
+    else {
+        std::cout << "Export failed\n";
+    }
+}
+
+void PdbAnalyzer::ExportBreakpad(const std::wstring& outputPath) const {
+    if (outputPath == L"-") {
+        if (!m_parser->ExportBreakpad(outputPath)) {
+            std::cerr << "Breakpad export failed\n";
+        }
+        return;
+    }
 
-    std::string result;
+    PrintHeader("Breakpad Export");
 
-    IMAGE_DOS_HEADER* dosHeader = nullptr;
-    IMAGE_NT_HEADERS* ntHeaders = nullptr;
-    IMAGE_DATA_DIRECTORY* debugDir = nullptr;
-    IMAGE_DEBUG_DIRECTORY* debugInfo = nullptr;
+    std::wcout << L"Writing Breakpad symbols to: " << outputPath << L"\n";
 
-    dosHeader = (IMAGE_DOS_HEADER*)pBase;
-    if (dosHeader->e_magic != IMAGE_DOS_SIGNATURE) goto cleanup;
+    auto start = std::chrono::high_resolution_clock::now();
+    bool success = m_parser->ExportBreakpad(outputPath);
+    auto end = std::chrono::high_resolution_clock::now();
 
-    ntHeaders = (IMAGE_NT_HEADERS*)((BYTE*)pBase + dosHeader->e_lfanew);
-    if (ntHeaders->Signature != IMAGE_NT_SIGNATURE) goto cleanup;
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-    debugDir = &ntHeaders->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG];
-    if (debugDir->VirtualAddress == 0) goto cleanup;
+    if (success) {
+        std::cout << "Export successful (" << std::filesystem::file_size(outputPath)
+            << " bytes in " << duration.count() << "ms)\n";
+    }
+    else {
+        std::cout << "Export failed\n";
+    }
+}
 
-    debugInfo = (IMAGE_DEBUG_DIRECTORY*)((BYTE*)pBase + debugDir->VirtualAddress);
+void PdbAnalyzer::ExportPerfMap(const std::wstring& outputPath, DWORD64 imageBase) const {
+    if (outputPath == L"-") {
+        if (!m_parser->ExportPerfMap(outputPath, imageBase)) {
+            std::cerr << "perf map export failed\n";
+        }
+        return;
+    }
 
-    for (DWORD i = 0; i < debugDir->Size / sizeof(IMAGE_DEBUG_DIRECTORY); i++) {
-        if (debugInfo[i].Type == IMAGE_DEBUG_TYPE_CODEVIEW) {
-            BYTE* cvData = (BYTE*)pBase + debugInfo[i].AddressOfRawData;
+    PrintHeader("perf Map Export");
 
-            if (*(DWORD*)cvData == 0x53445352) { // 'RSDS'
-                GUID* guid = (GUID*)(cvData + 4);
-                DWORD age = *(DWORD*)(cvData + 20);
-                char* pdbName = (char*)(cvData + 24);
+    std::wcout << L"Writing perf map to: " << outputPath << L" (image base 0x" << std::hex << imageBase << std::dec << L")\n";
 
-                char guidStr[64];
-                sprintf_s(guidStr, "%08X%04X%04X%02X%02X%02X%02X%02X%02X%02X%02X%X",
-                    guid->Data1, guid->Data2, guid->Data3,
-                    guid->Data4[0], guid->Data4[1], guid->Data4[2], guid->Data4[3],
-                    guid->Data4[4], guid->Data4[5], guid->Data4[6], guid->Data4[7], age);
+    auto start = std::chrono::high_resolution_clock::now();
+    bool success = m_parser->ExportPerfMap(outputPath, imageBase);
+    auto end = std::chrono::high_resolution_clock::now();
 
-                result = std::string(pdbName) + "|" + guidStr;
-                break;
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    if (success) {
+        std::cout << "Export successful (" << std::filesystem::file_size(outputPath)
+            << " bytes in " << duration.count() << "ms)\n";
+    }
+    else {
+        std::cout << "Export failed\n";
+    }
+}
+
+void PdbAnalyzer::SaveSnapshot(const std::wstring& snapshotPath) const {
+    PrintHeader("Snapshot");
+
+    std::wcout << L"Saving snapshot to: " << snapshotPath << L"\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bool success = m_parser->SaveSnapshot(snapshotPath);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    if (success) {
+        std::cout << "Snapshot saved (" << std::filesystem::file_size(snapshotPath)
+            << " bytes in " << duration.count() << "ms)\n";
+    }
+    else {
+        std::cout << "Snapshot save failed\n";
+    }
+}
+
+void PdbAnalyzer::RunScript(const std::wstring& scriptPath) const {
+    PrintHeader("Query Script");
+
+    QueryScript script;
+    if (scriptPath == L"-") {
+        script.Load(std::cin);
+    }
+    else {
+        std::ifstream file(scriptPath);
+        if (!file.is_open()) {
+            std::wcout << L"Cannot open query script: " << scriptPath << L"\n";
+            return;
+        }
+        script.Load(file);
+    }
+
+    for (const auto& error : script.GetErrors()) {
+        std::cout << error << "\n";
+    }
+
+    script.Execute(*m_parser);
+    QueryScript::PrintStats(script.GetStats());
+
+    // Batched answers are printed as the single-query options print them; the rest run as usual.
+    for (const auto& query : script.GetQueries()) {
+        const auto& args = query.args;
+        switch (query.op) {
+        case ScriptOp::Symbol: {
+            PrintHeader("Symbol Lookup");
+            std::wcout << L"Searching for: " << args[0] << L"\n";
+            const auto& rva = script.GetSymbolRva(query);
+            if (rva) {
+                std::cout << "Found at RVA: 0x" << std::hex << *rva << std::dec << "\n";
             }
+            else {
+                std::cout << "Symbol not found\n";
+            }
+            break;
+        }
+        case ScriptOp::Pattern: {
+            PrintHeader("Pattern Search");
+            std::wcout << L"Pattern: " << args[0] << L"\n";
+            const auto& matches = script.GetSymbolMatches(query);
+            std::cout << "Found " << std::dec << matches.size() << " matches\n\n";
+            PrintSymbolMatches(matches, 20);
+            std::cout << std::dec;
+            break;
+        }
+        case ScriptOp::GlobalPattern: {
+            PrintHeader("Global Data Search");
+            std::wcout << L"Pattern: " << args[0] << L"\n";
+            const auto& matches = script.GetGlobalMatches(query);
+            std::cout << "Found " << std::dec << matches.size() << " matches\n\n";
+            PrintGlobalMatches(matches, 20);
+            break;
         }
+        case ScriptOp::Struct: {
+            PrintHeader("Structure Analysis");
+            const auto& structInfo = script.GetStruct(query);
+            if (structInfo) {
+                PrintStructInfo(*structInfo);
+                std::cout << std::dec;
+            }
+            else {
+                std::wcout << L"Structure '" << args[0] << L"' not found\n";
+            }
+            break;
+        }
+        case ScriptOp::Member: {
+            PrintHeader("Structure Member Lookup");
+            std::wcout << L"Struct: " << args[0] << L", Member: " << args[1] << L"\n";
+            const auto& structInfo = script.GetStruct(query);
+            const StructMember* member = structInfo ? structInfo->FindMember(WStringToString(args[1])) : nullptr;
+            if (member) {
+                std::cout << "Member offset: +0x" << std::hex << member->offset << std::dec << "\n";
+            }
+            else {
+                std::cout << "Member not found\n";
+            }
+            break;
+        }
+        case ScriptOp::FieldPath:
+            if (script.GetStruct(query)) {
+                ResolveFieldPath(args[0]);
+            }
+            else {
+                PrintHeader("Field Path");
+                std::wcout << L"Path: " << args[0] << L"\n";
+                std::cout << "Path could not be resolved\n";
+            }
+            break;
+        case ScriptOp::Global:
+            FindGlobalSymbol(args[0]);
+            break;
+        case ScriptOp::Function:
+            AnalyzeFunction(args[0]);
+            break;
+        case ScriptOp::Enum:
+            AnalyzeEnum(args[0]);
+            break;
+        case ScriptOp::EnumValue:
+            DecodeEnumValue(args[0], args[1]);
+            break;
+        case ScriptOp::LayoutHash:
+            ShowLayoutHash(args[0]);
+            break;
+        case ScriptOp::Class:
+            AnalyzeClass(args[0]);
+            break;
+        case ScriptOp::Subclasses:
+            ListSubclasses(args[0]);
+            break;
+        case ScriptOp::Overrides:
+            FindOverrides(args[0], std::wcstoul(args[1].c_str(), nullptr, 0));
+            break;
+        }
+    }
+}
+
+void PdbAnalyzer::WriteReducedPdb(const std::wstring& outputPath, const std::wstring& namesFile) const {
+    PrintHeader("Reduced PDB");
+
+    std::ifstream file(namesFile);
+    if (!file.is_open()) {
+        std::wcout << L"Cannot open name list: " << namesFile << L"\n";
+        return;
+    }
+
+    // One name per line; blank lines and lines starting with '#' are skipped.
+    std::vector<std::string> names;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        size_t last = line.find_last_not_of(" \t\r");
+        names.push_back(line.substr(first, last - first + 1));
+    }
+
+    std::wcout << L"Writing " << names.size() << L" names to: " << outputPath << L"\n";
+
+    ReducedPdbStats stats;
+    if (!ReducedPdbWriter::Write(m_parser->GetPdbPath(), outputPath, names, stats)) {
+        std::cout << "Reduced PDB write failed\n";
+        return;
+    }
+    ReducedPdbWriter::PrintStats(stats);
+}
+
+void PdbAnalyzer::LoadSnapshot(const std::wstring& snapshotPath) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    bool success = m_parser->LoadSnapshot(snapshotPath);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    if (success) {
+        std::wcerr << L"Snapshot loaded: " << snapshotPath << L" (" << duration.count() << L"us)\n";
+    }
+    else {
+        std::wcerr << L"Snapshot rejected (missing, corrupt or built from a different PDB): " << snapshotPath << L"\n";
+    }
+}
+
+void PdbAnalyzer::ExportNdjson(const std::wstring& outputPath) const {
+    if (outputPath == L"-") {
+        if (!m_parser->ExportNdjson(outputPath)) {
+            std::cerr << "NDJSON export failed\n";
+        }
+        return;
+    }
+
+    PrintHeader("NDJSON Export");
+
+    std::wcout << L"Streaming to: " << outputPath << L"\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bool success = m_parser->ExportNdjson(outputPath);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    if (success) {
+        std::cout << "Export successful in " << duration.count() << "ms\n";
+    }
+    else {
+        std::cout << "Export failed\n";
+    }
+}
+
+#include <wininet.h>
+#pragma comment(lib, "wininet.lib")
+
+namespace {
+    template<typename T>
+    bool ReadImageValue(const BYTE* base, size_t size, size_t offset, T& value) noexcept {
+        if (offset > size || sizeof(T) > size - offset) return false;
+        memcpy(&value, base + offset, sizeof(T));
+        return true;
+    }
+
+    // Images are mapped as flat files, so RVAs have to be translated through the section table.
+    std::optional<size_t> RvaToFileOffset(const BYTE* base, size_t size, size_t sectionsOffset,
+        WORD sectionCount, DWORD rva) noexcept {
+        for (WORD i = 0; i < sectionCount; ++i) {
+            IMAGE_SECTION_HEADER section{};
+            if (!ReadImageValue(base, size, sectionsOffset + i * sizeof(section), section)) break;
+
+            DWORD extent = (std::max)(section.Misc.VirtualSize, section.SizeOfRawData);
+            if (rva >= section.VirtualAddress && rva - section.VirtualAddress < extent) {
+                return static_cast<size_t>(section.PointerToRawData) + (rva - section.VirtualAddress);
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<PdbIdentity> ParseCodeViewIdentity(const BYTE* base, size_t size) {
+        IMAGE_DOS_HEADER dosHeader{};
+        if (!ReadImageValue(base, size, 0, dosHeader) || dosHeader.e_magic != IMAGE_DOS_SIGNATURE) return std::nullopt;
+
+        size_t ntOffset = static_cast<DWORD>(dosHeader.e_lfanew);
+        DWORD signature = 0;
+        IMAGE_FILE_HEADER fileHeader{};
+        if (!ReadImageValue(base, size, ntOffset, signature) || signature != IMAGE_NT_SIGNATURE ||
+            !ReadImageValue(base, size, ntOffset + sizeof(DWORD), fileHeader)) {
+            return std::nullopt;
+        }
+
+        size_t optionalOffset = ntOffset + sizeof(DWORD) + sizeof(IMAGE_FILE_HEADER);
+        WORD magic = 0;
+        ReadImageValue(base, size, optionalOffset, magic);
+
+        size_t directoriesOffset = 0, directoryCountOffset = 0;
+        if (magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC) {
+            directoriesOffset = optionalOffset + offsetof(IMAGE_OPTIONAL_HEADER32, DataDirectory);
+            directoryCountOffset = optionalOffset + offsetof(IMAGE_OPTIONAL_HEADER32, NumberOfRvaAndSizes);
+        }
+        else if (magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC) {
+            directoriesOffset = optionalOffset + offsetof(IMAGE_OPTIONAL_HEADER64, DataDirectory);
+            directoryCountOffset = optionalOffset + offsetof(IMAGE_OPTIONAL_HEADER64, NumberOfRvaAndSizes);
+        }
+        else {
+            return std::nullopt;
+        }
+
+        DWORD directoryCount = 0;
+        IMAGE_DATA_DIRECTORY debugDir{};
+        if (!ReadImageValue(base, size, directoryCountOffset, directoryCount) ||
+            directoryCount <= IMAGE_DIRECTORY_ENTRY_DEBUG ||
+            !ReadImageValue(base, size, directoriesOffset + IMAGE_DIRECTORY_ENTRY_DEBUG * sizeof(IMAGE_DATA_DIRECTORY), debugDir) ||
+            debugDir.VirtualAddress == 0) {
+            return std::nullopt;
+        }
+
+        auto debugOffset = RvaToFileOffset(base, size, optionalOffset + fileHeader.SizeOfOptionalHeader,
+            fileHeader.NumberOfSections, debugDir.VirtualAddress);
+        if (!debugOffset) return std::nullopt;
+
+        for (DWORD i = 0; i < debugDir.Size / sizeof(IMAGE_DEBUG_DIRECTORY); i++) {
+            IMAGE_DEBUG_DIRECTORY entry{};
+            if (!ReadImageValue(base, size, *debugOffset + i * sizeof(entry), entry)) break;
+            if (entry.Type != IMAGE_DEBUG_TYPE_CODEVIEW || entry.SizeOfData <= 24) continue;
+
+            size_t cvOffset = entry.PointerToRawData;
+            DWORD cvSignature = 0, age = 0;
+            GUID guid{};
+            if (!ReadImageValue(base, size, cvOffset, cvSignature) || cvSignature != 0x53445352 || // 'RSDS'
+                !ReadImageValue(base, size, cvOffset + 4, guid) ||
+                !ReadImageValue(base, size, cvOffset + 20, age) ||
+                cvOffset + 24 >= size) {
+                continue;
+            }
+
+            const char* name = reinterpret_cast<const char*>(base + cvOffset + 24);
+            std::string pdbPath(name, strnlen(name, (std::min)(static_cast<size_t>(entry.SizeOfData - 24), size - cvOffset - 24)));
+
+            // Linkers record the full build path; the symbol server only knows the file name.
+            size_t slash = pdbPath.find_last_of("\\/");
+            PdbIdentity identity;
+            identity.pdbName = slash == std::string::npos ? pdbPath : pdbPath.substr(slash + 1);
+            if (identity.pdbName.empty()) continue;
+
+            identity.guidAge = FormatGuidAge(guid, age);
+            return identity;
+        }
+
+        return std::nullopt;
+    }
+}
+
+std::optional<PdbIdentity> PdbDownloader::ReadPdbIdentity(const std::wstring& exePath) {
+    TraceScope trace(TracePhase::ScanImage);
+
+    HANDLE hFile = CreateFileW(exePath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, 0, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) return std::nullopt;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(IMAGE_DOS_HEADER))) {
+        CloseHandle(hFile);
+        return std::nullopt;
+    }
+
+    HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!hMapping) { CloseHandle(hFile); return std::nullopt; }
+
+    LPVOID pBase = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!pBase) { CloseHandle(hMapping); CloseHandle(hFile); return std::nullopt; }
+
+    std::optional<PdbIdentity> result;
+    try {
+        result = ParseCodeViewIdentity(static_cast<const BYTE*>(pBase), static_cast<size_t>(fileSize.QuadPart));
+    }
+    catch (...) {
     }
 
-cleanup:
     UnmapViewOfFile(pBase);
     CloseHandle(hMapping);
     CloseHandle(hFile);
@@ -285,6 +1195,15 @@ bool PdbDownloader::DownloadFile(const std::string& url, const std::wstring& out
         return false;
     }
 
+    // A missing PDB comes back as an HTTP error page, which must not end up in the store.
+    DWORD statusCode = 0, statusSize = sizeof(statusCode);
+    if (HttpQueryInfoA(hUrl, HTTP_QUERY_STATUS_CODE | HTTP_QUERY_FLAG_NUMBER, &statusCode, &statusSize, nullptr) &&
+        statusCode != HTTP_STATUS_OK) {
+        InternetCloseHandle(hUrl);
+        InternetCloseHandle(hInternet);
+        return false;
+    }
+
     HANDLE hFile = CreateFileW(outputPath.c_str(), GENERIC_WRITE, 0, nullptr,
         CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
     if (hFile == INVALID_HANDLE_VALUE) {
@@ -297,7 +1216,13 @@ bool PdbDownloader::DownloadFile(const std::string& url, const std::wstring& out
     DWORD bytesRead, bytesWritten;
     bool success = true;
 
-    while (InternetReadFile(hUrl, buffer, sizeof(buffer), &bytesRead) && bytesRead > 0) {
+    for (;;) {
+        if (!InternetReadFile(hUrl, buffer, sizeof(buffer), &bytesRead)) {
+            success = false;
+            break;
+        }
+        if (bytesRead == 0) break;
+
         if (!WriteFile(hFile, buffer, bytesRead, &bytesWritten, nullptr) || bytesWritten != bytesRead) {
             success = false;
             break;
@@ -315,41 +1240,66 @@ bool PdbDownloader::DownloadFile(const std::string& url, const std::wstring& out
     return success;
 }
 
-std::optional<std::wstring> PdbDownloader::DownloadPdbForExecutable(const std::wstring& exePath) {
-    std::string pdbInfo = ExtractPdbInfo(exePath);
-    if (pdbInfo.empty()) return std::nullopt;
-
-    size_t pos = pdbInfo.find('|');
-    if (pos == std::string::npos) return std::nullopt;
+std::wstring PdbDownloader::GetStorePath(const PdbIdentity& identity, const SymbolServerConfig& config) {
+    std::wstring pdbName(identity.pdbName.begin(), identity.pdbName.end());
+    std::wstring guidAge(identity.guidAge.begin(), identity.guidAge.end());
 
-    std::string pdbName = pdbInfo.substr(0, pos);
-    std::string guidAge = pdbInfo.substr(pos + 1);
+    return (std::filesystem::path(config.storeDirectory) / pdbName / guidAge / pdbName).wstring();
+}
 
-    std::wstring symbolDir = L"C:\\Symbols\\";
-    CreateDirectoryW(symbolDir.c_str(), nullptr);
+std::string PdbDownloader::GetDownloadUrl(const PdbIdentity& identity, const SymbolServerConfig& config) {
+    std::string serverUrl = config.serverUrl;
+    while (!serverUrl.empty() && serverUrl.back() == '/') {
+        serverUrl.pop_back();
+    }
 
-    std::wstring pdbDir = symbolDir + std::wstring(pdbName.begin(), pdbName.end()) + L"\\";
-    CreateDirectoryW(pdbDir.c_str(), nullptr);
+    return serverUrl + "/" + identity.pdbName + "/" + identity.guidAge + "/" + identity.pdbName;
+}
 
-    std::wstring guidDir = pdbDir + std::wstring(guidAge.begin(), guidAge.end()) + L"\\";
-    CreateDirectoryW(guidDir.c_str(), nullptr);
+std::optional<std::wstring> PdbDownloader::FetchPdb(const PdbIdentity& identity, const SymbolServerConfig& config) {
+    TraceScope trace(TracePhase::FetchPdb);
 
-    std::wstring pdbPath = guidDir + std::wstring(pdbName.begin(), pdbName.end());
+    std::wstring pdbPath = GetStorePath(identity, config);
 
-    if (std::filesystem::exists(pdbPath)) {
+    std::error_code error;
+    if (std::filesystem::exists(pdbPath, error)) {
         return pdbPath;
     }
 
-    // Download from Microsoft Symbol Server
-    std::string url = "https://msdl.microsoft.com/download/symbols/" +
-        pdbName + "/" + guidAge + "/" + pdbName;
+    std::filesystem::create_directories(std::filesystem::path(pdbPath).parent_path(), error);
 
-    std::wcout << L"Downloading PDB from: " << std::wstring(url.begin(), url.end()) << L"\n";
-    std::wcout << L"Saving to: " << pdbPath << L"\n";
+    // Download beside the target and rename, so an interrupted fetch never leaves a truncated PDB in
+    // the store for the next run to pick up.
+    std::wstring partialPath = pdbPath + L"." +
+        std::to_wstring(std::hash<std::thread::id>{}(std::this_thread::get_id())) + L".partial";
 
-    if (DownloadFile(url, pdbPath)) {
+    if (!DownloadFile(GetDownloadUrl(identity, config), partialPath)) {
+        return std::nullopt;
+    }
+
+    if (!MoveFileExW(partialPath.c_str(), pdbPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileW(partialPath.c_str());
+        if (!std::filesystem::exists(pdbPath, error)) return std::nullopt;
+    }
+
+    return pdbPath;
+}
+
+std::optional<std::wstring> PdbDownloader::DownloadPdbForExecutable(const std::wstring& exePath,
+    const SymbolServerConfig& config) {
+    auto identity = ReadPdbIdentity(exePath);
+    if (!identity) return std::nullopt;
+
+    std::wstring pdbPath = GetStorePath(*identity, config);
+
+    if (std::filesystem::exists(pdbPath)) {
         return pdbPath;
     }
 
-    return std::nullopt;
-}
\ No newline at end of file
+    std::string url = GetDownloadUrl(*identity, config);
+
+    std::wcerr << L"Downloading PDB from: " << std::wstring(url.begin(), url.end()) << L"\n";
+    std::wcerr << L"Saving to: " << pdbPath << L"\n";
+
+    return FetchPdb(*identity, config);
+}
@@ -11,9 +11,13 @@ private:
     void PrintHeader(const std::string& title) const;
     void PrintSymbolInfo(const SymbolInfo& symbol) const;
     void PrintStructInfo(const StructInfo& structInfo) const;
+    void PrintGlobalInfo(const GlobalSymbolInfo& global) const;
+    void PrintFunctionVariable(const FunctionVariable& variable) const;
+    void PrintSymbolMatches(const std::vector<SymbolInfo>& matches, size_t maxResults) const;
+    void PrintGlobalMatches(const std::vector<GlobalSymbolInfo>& matches, size_t maxResults) const;
 
 public:
-    explicit PdbAnalyzer(const std::wstring& pdbPath);
+    explicit PdbAnalyzer(const std::wstring& pdbPath, OpenMode openMode = OpenMode::Full);
     ~PdbAnalyzer() = default;
 
     PdbAnalyzer(const PdbAnalyzer&) = delete;
@@ -24,11 +28,34 @@ public:
     void ShowBasicInfo() const;
     void AnalyzeSymbols(size_t maxResults = 50) const;
     void FindSpecificSymbol(const std::wstring& symbolName) const;
+    void FindGlobalSymbol(const std::wstring& name) const;
+    void SearchGlobals(const std::wstring& pattern, size_t maxResults = 20) const;
     void AnalyzeStructure(const std::wstring& structName) const;
+    void AnalyzeFunction(const std::wstring& functionName) const;
+    void AnalyzeEnum(const std::wstring& enumName) const;
+    void DecodeEnumValue(const std::wstring& enumName, const std::wstring& valueText) const;
     void FindStructMember(const std::wstring& structName, const std::wstring& memberName) const;
+    void ResolveFieldPath(const std::wstring& path) const;
+    void WalkMemory(const std::wstring& imageSpec, const std::wstring& head, const std::wstring& linkPath,
+        const std::wstring& fieldList) const;
+    void ShowLayoutHash(const std::wstring& structName) const;
+    void ReportLayouts(size_t maxResults = 25) const;
+    void AnalyzeClass(const std::wstring& className) const;
+    void ListSubclasses(const std::wstring& className) const;
+    void FindOverrides(const std::wstring& className, DWORD slot) const;
     void SearchByPattern(const std::wstring& pattern, size_t maxResults = 20) const;
     void PerformanceTest() const;
     void ListStructures(size_t maxResults = 30) const;
     void ExportResults(const std::wstring& outputPath) const;
+    void ExportColumnar(const std::wstring& outputPath) const;
+    void ExportNdjson(const std::wstring& outputPath) const;
+    void ExportFunctions(const std::wstring& outputPath) const;
+    void ExportBreakpad(const std::wstring& outputPath) const;
+    void ExportPerfMap(const std::wstring& outputPath, DWORD64 imageBase) const;
+    void SaveSnapshot(const std::wstring& snapshotPath) const;
+    void LoadSnapshot(const std::wstring& snapshotPath) const;
+    // Runs a file of queries ("-" for stdin) with lookups batched per index; see QueryScript.
+    void RunScript(const std::wstring& scriptPath) const;
+    void WriteReducedPdb(const std::wstring& outputPath, const std::wstring& namesFile) const;
     bool DumpToJson(const std::wstring& outputPath) const;
 };
\ No newline at end of file
@@ -5,32 +5,118 @@
 #include <cvconst.h>
 #include <filesystem>
 #include <iostream>
+#include <unordered_set>
+#include <cstdio>
+#include <fcntl.h>
+#include <io.h>
+#include "Parallel.h"
+#include "ParseArena.h"
+#include "Trace.h"
+#include "MsfReader.h"
+
+static std::string_view ConvertToUtf8(const wchar_t* data, size_t length) {
+    thread_local std::string scratch;
+
+    if (length == 0) return {};
+
+    size_t capacity = length * 3;
+    if (scratch.size() < capacity) {
+        scratch.resize(capacity);
+    }
+
+    int size = WideCharToMultiByte(CP_UTF8, 0, data, static_cast<int>(length),
+        &scratch[0], static_cast<int>(capacity), nullptr, nullptr);
+    if (size <= 0) return {};
+
+    return std::string_view(scratch.data(), static_cast<size_t>(size));
+}
+
+std::string WStringToString(const wchar_t* data, size_t length) {
+    return std::string(ConvertToUtf8(data, length));
+}
+
+std::pmr::string WStringToString(const wchar_t* data, size_t length, std::pmr::memory_resource* resource) {
+    return std::pmr::string(ConvertToUtf8(data, length), resource);
+}
+
+std::string FormatGuidAge(const GUID& guid, DWORD age) {
+    char guidAge[64];
+    sprintf_s(guidAge, "%08X%04X%04X%02X%02X%02X%02X%02X%02X%02X%02X%X",
+        guid.Data1, guid.Data2, guid.Data3,
+        guid.Data4[0], guid.Data4[1], guid.Data4[2], guid.Data4[3],
+        guid.Data4[4], guid.Data4[5], guid.Data4[6], guid.Data4[7], age);
+    return guidAge;
+}
 
 std::string WStringToString(const std::wstring& wstr) {
-    if (wstr.empty()) return {};
+    return WStringToString(wstr.data(), wstr.size());
+}
 
-    int size = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, nullptr, 0, nullptr, nullptr);
-    if (size <= 0) return {};
+static void IndexEnumValues(EnumInfo& enumInfo) {
+    enumInfo.sortedByValue.resize(enumInfo.values.size());
+    for (uint32_t i = 0; i < enumInfo.sortedByValue.size(); ++i) {
+        enumInfo.sortedByValue[i] = i;
+    }
 
-    std::string result(size - 1, 0);
-    WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, &result[0], size, nullptr, nullptr);
-    return result;
+    std::stable_sort(enumInfo.sortedByValue.begin(), enumInfo.sortedByValue.end(),
+        [&](uint32_t a, uint32_t b) { return enumInfo.values[a].value < enumInfo.values[b].value; });
 }
 
-PdbParser::PdbParser(const std::wstring& pdbPath)
-    : m_pdbPath(pdbPath), m_machineType(MachineType::x86) {
+PdbParser::PdbParser(const std::wstring& pdbPath, OpenMode openMode)
+    : m_pdbPath(pdbPath), m_machineType(MachineType::x86), m_openMode(openMode) {
 
     if (FAILED(CoInitialize(nullptr))) {
         throw std::runtime_error("Failed to initialize COM");
     }
 
-    if (!InitializeDia()) {
+    // A lightweight mode whose streams cannot be read natively degrades to a full open.
+    std::optional<uint16_t> machine;
+    if (m_openMode == OpenMode::PublicsOnly) {
+        TraceScope trace(TracePhase::OpenPdb);
+        if (const SymbolStreams* streams = GetSymbolStreams()) {
+            machine = streams->GetMachine();
+        }
+    }
+    else if (m_openMode == OpenMode::TypesOnly) {
+        TraceScope trace(TracePhase::OpenPdb);
+        auto msf = GetMsf();
+        if (msf && GetTypeStream()) {
+            machine = SymbolStreams::ReadMachine(*msf);
+        }
+    }
+
+    if (machine) {
+        if (*machine != 0) m_machineType = static_cast<MachineType>(*machine);
+        return;
+    }
+
+    m_openMode = OpenMode::Full;
+    if (!EnsureDia()) {
         CleanupCom();
         throw std::runtime_error("Failed to initialize DIA SDK");
     }
+
+    DWORD machType = 0;
+    if (SUCCEEDED(m_pGlobalScope->get_machineType(&machType))) {
+        m_machineType = static_cast<MachineType>(machType);
+    }
+}
+
+bool PdbParser::EnsureDia() const noexcept {
+    if (!m_diaLoaded) {
+        m_diaLoaded = true;
+        if (!InitializeDia()) {
+            m_pGlobalScope.Release();
+            m_pSession.Release();
+            m_pDataSource.Release();
+        }
+    }
+    return m_pGlobalScope != nullptr;
 }
 
-bool PdbParser::InitializeDia() noexcept {
+bool PdbParser::InitializeDia() const noexcept {
+    TraceScope trace(TracePhase::OpenPdb);
+
     HRESULT hr = CoCreateInstance(__uuidof(DiaSource), nullptr, CLSCTX_INPROC_SERVER,
         __uuidof(IDiaDataSource), reinterpret_cast<void**>(&m_pDataSource));
 
@@ -50,11 +136,6 @@ bool PdbParser::InitializeDia() noexcept {
     hr = m_pSession->get_globalScope(&m_pGlobalScope);
     if (FAILED(hr)) return false;
 
-    DWORD machType = 0;
-    if (SUCCEEDED(m_pGlobalScope->get_machineType(&machType))) {
-        m_machineType = static_cast<MachineType>(machType);
-    }
-
     return true;
 }
 
@@ -64,8 +145,11 @@ void PdbParser::CleanupCom() noexcept {
 
 template<typename Func>
 bool PdbParser::EnumerateSymbols(enum SymTagEnum symTag, const Func& callback) const {
+    TraceScope trace(TracePhase::Enumerate);
+    Tracer::Count(TraceCounter::Enumerations);
+
     CComPtr<IDiaEnumSymbols> pEnumSymbols;
-    if (FAILED(m_pGlobalScope->findChildren(symTag, nullptr, nsNone, &pEnumSymbols))) {
+    if (!EnsureDia() || FAILED(m_pGlobalScope->findChildren(symTag, nullptr, nsNone, &pEnumSymbols))) {
         return false;
     }
 
@@ -73,6 +157,7 @@ bool PdbParser::EnumerateSymbols(enum SymTagEnum symTag, const Func& callback) c
     ULONG celt = 0;
 
     while (SUCCEEDED(pEnumSymbols->Next(1, &pSymbol, &celt)) && celt == 1) {
+        Tracer::Count(TraceCounter::SymbolsVisited);
         try {
             if (!callback(pSymbol)) break;
         }
@@ -84,34 +169,119 @@ bool PdbParser::EnumerateSymbols(enum SymTagEnum symTag, const Func& callback) c
     return true;
 }
 
+// Functions and public symbols in RVA order, the order Breakpad and perf maps want, without holding
+// the symbol table. A public at the address of a function or inside one is dropped, as dump_syms
+// does; a public without a length extends to the next symbol.
+template<typename Func>
+bool PdbParser::ForEachAddressRange(const Func& callback) const {
+    TraceScope trace(TracePhase::Enumerate);
+    Tracer::Count(TraceCounter::Enumerations);
+
+    CComPtr<IDiaEnumSymbolsByAddr> pEnumByAddr;
+    CComPtr<IDiaSymbol> pSymbol;
+    if (!EnsureDia() || FAILED(m_pSession->getSymbolsByAddr(&pEnumByAddr)) ||
+        FAILED(pEnumByAddr->symbolByAddr(1, 0, &pSymbol)) || !pSymbol) {
+        return false;
+    }
+
+    IDiaEnumFrameData* pFrames = m_machineType == MachineType::x86 ? GetFrameData() : nullptr;
+    std::optional<AddressRange> pendingPublic;
+    DWORD64 coveredEnd = 0;
+    bool keepGoing = true;
+
+    auto flushPublic = [&](DWORD nextRva) {
+        if (!pendingPublic) return;
+        if (pendingPublic->length == 0 && nextRva > pendingPublic->rva) {
+            pendingPublic->length = nextRva - pendingPublic->rva;
+        }
+        keepGoing = keepGoing && callback(*pendingPublic);
+        pendingPublic.reset();
+    };
+
+    ULONG celt = 1;
+    do {
+        Tracer::Count(TraceCounter::SymbolsVisited);
+        try {
+            DWORD symTag = 0, rva = 0;
+            ULONGLONG length = 0;
+            CComBSTR bstrName;
+
+            if (SUCCEEDED(pSymbol->get_symTag(&symTag)) && (symTag == SymTagFunction || symTag == SymTagPublicSymbol) &&
+                SUCCEEDED(pSymbol->get_relativeVirtualAddress(&rva)) && SUCCEEDED(pSymbol->get_length(&length)) &&
+                SUCCEEDED(symTag == SymTagFunction ? pSymbol->get_name(&bstrName) : GetUndecoratedName(pSymbol, bstrName)) &&
+                bstrName && bstrName.Length() > 0) {
+                AddressRange range;
+                range.rva = rva;
+                range.length = static_cast<DWORD>(length);
+                range.name = WStringToString(bstrName.m_str, bstrName.Length());
+                range.isFunction = symTag == SymTagFunction;
+
+                if (range.isFunction) {
+                    if (pendingPublic && pendingPublic->rva == rva) pendingPublic.reset();
+                    flushPublic(rva);
+
+                    CComPtr<IDiaFrameData> pFrame;
+                    if (pFrames && SUCCEEDED(pFrames->frameByRVA(rva, &pFrame)) && pFrame) {
+                        pFrame->get_lengthParams(&range.parameterSize);
+                    }
+
+                    coveredEnd = (std::max)(coveredEnd, static_cast<DWORD64>(rva) + length);
+                    keepGoing = keepGoing && callback(range);
+                }
+                else if (rva >= coveredEnd && !(pendingPublic && pendingPublic->rva == rva)) {
+                    flushPublic(rva);
+                    pendingPublic = std::move(range);
+                }
+            }
+        }
+        catch (...) {
+        }
+        pSymbol.Release();
+    } while (keepGoing && SUCCEEDED(pEnumByAddr->Next(1, &pSymbol, &celt)) && celt == 1);
+
+    flushPublic(0);
+    return true;
+}
+
+HRESULT PdbParser::GetUndecoratedName(IDiaSymbol* pSymbol, CComBSTR& name) {
+    TraceScope trace(TracePhase::Undecorate);
+    Tracer::Count(TraceCounter::Undecorations);
+    return pSymbol->get_undecoratedNameEx(0x1000, &name);
+}
+
+bool PdbParser::DecodePublicSymbol(IDiaSymbol* pSymbol, SymbolInfo& symbol) {
+    TraceScope trace(TracePhase::DecodeSymbol);
+    CComBSTR bstrName;
+    DWORD rva = 0;
+    ULONGLONG length = 0;
+    DWORD typeId = 0;
+
+    if (SUCCEEDED(GetUndecoratedName(pSymbol, bstrName)) &&
+        bstrName && bstrName.Length() > 0 &&
+        SUCCEEDED(pSymbol->get_relativeVirtualAddress(&rva)) &&
+        SUCCEEDED(pSymbol->get_length(&length)) &&
+        SUCCEEDED(pSymbol->get_typeId(&typeId))) {
+
+        symbol.name = WStringToString(bstrName.m_str, bstrName.Length());
+        symbol.rva = static_cast<DWORD64>(rva);
+        symbol.size = static_cast<DWORD64>(length);
+        symbol.typeId = typeId;
+
+        return !symbol.name.empty();
+    }
+
+    return false;
+}
+
 std::vector<SymbolInfo> PdbParser::GetAllPublicSymbols() const {
     std::vector<SymbolInfo> symbols;
     symbols.reserve(2000);
 
     EnumerateSymbols(SymTagPublicSymbol, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
         try {
-            CComBSTR bstrName;
-            DWORD rva = 0;
-            ULONGLONG length = 0;
-            DWORD typeId = 0;
-
-            if (SUCCEEDED(pSymbol->get_undecoratedNameEx(0x1000, &bstrName)) &&
-                bstrName && bstrName.Length() > 0 &&
-                SUCCEEDED(pSymbol->get_relativeVirtualAddress(&rva)) &&
-                SUCCEEDED(pSymbol->get_length(&length)) &&
-                SUCCEEDED(pSymbol->get_typeId(&typeId))) {
-
-                std::wstring wname(bstrName.m_str, bstrName.Length());
-                std::string safeName = WStringToString(wname);
-
-                if (!safeName.empty()) {
-                    symbols.emplace_back(SymbolInfo{
-                        std::move(safeName),
-                        static_cast<DWORD64>(rva),
-                        static_cast<DWORD64>(length),
-                        typeId
-                        });
-                }
+            SymbolInfo symbol;
+            if (DecodePublicSymbol(pSymbol, symbol)) {
+                symbols.emplace_back(std::move(symbol));
             }
         }
         catch (...) {
@@ -126,19 +296,50 @@ std::vector<SymbolInfo> PdbParser::GetAllPublicSymbols() const {
     return symbols;
 }
 
+bool PdbParser::ForEachPublicSymbol(const std::function<bool(const SymbolInfo&)>& callback) const {
+    return EnumerateSymbols(SymTagPublicSymbol, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        SymbolInfo symbol;
+        if (DecodePublicSymbol(pSymbol, symbol)) {
+            return callback(symbol);
+        }
+        return true;
+        });
+}
+
 std::optional<DWORD64> PdbParser::GetSymbolRva(const std::wstring& symbolName) const {
     auto it = m_symbolCache.find(symbolName);
     if (it != m_symbolCache.end()) {
+        Tracer::Count(TraceCounter::SymbolCacheHits);
         return it->second;
     }
 
+    Tracer::Count(TraceCounter::SymbolCacheMisses);
+    TraceScope trace(TracePhase::SymbolLookup);
+
+    if (m_snapshot) {
+        if (const SnapshotSymbol* symbol = m_snapshot->FindSymbol(WStringToString(symbolName))) {
+            m_symbolCache[symbolName] = symbol->rva;
+            return symbol->rva;
+        }
+    }
+
+    // Exact public names resolve through the publics hash; undecorated C++ names still need DIA.
+    if (const SymbolStreams* streams = GetSymbolStreams()) {
+        if (auto symbol = streams->FindPublic(WStringToString(symbolName))) {
+            if (auto rva = streams->SectionOffsetToRva(symbol->section, symbol->offset)) {
+                m_symbolCache[symbolName] = *rva;
+                return rva;
+            }
+        }
+    }
+
     DWORD64 rva = 0;
     bool found = false;
 
     EnumerateSymbols(SymTagPublicSymbol, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
         try {
             CComBSTR bstrName;
-            if (SUCCEEDED(pSymbol->get_undecoratedNameEx(0x1000, &bstrName)) &&
+            if (SUCCEEDED(GetUndecoratedName(pSymbol, bstrName)) &&
                 bstrName && bstrName.Length() > 0) {
 
                 if (wcscmp(symbolName.c_str(), bstrName.m_str) == 0) {
@@ -165,124 +366,2045 @@ std::optional<DWORD64> PdbParser::GetSymbolRva(const std::wstring& symbolName) c
 }
 
 std::vector<SymbolInfo> PdbParser::FindSymbolsByPattern(const std::wstring& pattern) const {
-    std::vector<SymbolInfo> matches;
-    matches.reserve(100);
+    PublicsQuery query;
+    query.patterns.push_back(pattern);
+    ResolvePublics(query);
+    return std::move(query.matches.front());
+}
 
-    try {
-        std::wregex regex(pattern, std::regex_constants::icase);
+void PdbParser::ResolvePublics(PublicsQuery& query) const {
+    TraceScope trace(query.patterns.empty() ? TracePhase::SymbolLookup : TracePhase::PatternSearch);
+    query.rvas.assign(query.names.size(), std::nullopt);
+    query.matches.assign(query.patterns.size(), {});
+
+    const SymbolStreams* streams = query.names.empty() ? nullptr : GetSymbolStreams();
+    std::unordered_map<std::wstring_view, std::vector<size_t>> pending;
+
+    for (size_t i = 0; i < query.names.size(); ++i) {
+        const std::wstring& name = query.names[i];
+        auto it = m_symbolCache.find(name);
+        if (it != m_symbolCache.end()) {
+            Tracer::Count(TraceCounter::SymbolCacheHits);
+            query.rvas[i] = it->second;
+            continue;
+        }
 
-        EnumerateSymbols(SymTagPublicSymbol, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
-            try {
-                CComBSTR bstrName;
-                if (SUCCEEDED(pSymbol->get_undecoratedNameEx(0x1000, &bstrName)) &&
-                    bstrName && bstrName.Length() > 0) {
-
-                    std::wstring name(bstrName.m_str, bstrName.Length());
-                    if (std::regex_search(name, regex)) {
-                        DWORD rva = 0;
-                        ULONGLONG length = 0;
-                        DWORD typeId = 0;
-
-                        if (SUCCEEDED(pSymbol->get_relativeVirtualAddress(&rva)) &&
-                            SUCCEEDED(pSymbol->get_length(&length)) &&
-                            SUCCEEDED(pSymbol->get_typeId(&typeId))) {
-
-                            std::string safeName = WStringToString(name);
-                            if (!safeName.empty()) {
-                                matches.emplace_back(SymbolInfo{
-                                    std::move(safeName),
-                                    static_cast<DWORD64>(rva),
-                                    static_cast<DWORD64>(length),
-                                    typeId
-                                    });
-                            }
-                        }
+        Tracer::Count(TraceCounter::SymbolCacheMisses);
+        std::optional<DWORD64> rva;
+        if (m_snapshot) {
+            if (const SnapshotSymbol* symbol = m_snapshot->FindSymbol(WStringToString(name))) {
+                rva = symbol->rva;
+            }
+        }
+        if (!rva && streams) {
+            if (auto symbol = streams->FindPublic(WStringToString(name))) {
+                rva = streams->SectionOffsetToRva(symbol->section, symbol->offset);
+            }
+        }
+
+        if (rva) {
+            m_symbolCache[name] = *rva;
+            query.rvas[i] = rva;
+        }
+        else {
+            pending[name].push_back(i);
+        }
+    }
+
+    std::vector<std::optional<std::wregex>> regexes(query.patterns.size());
+    size_t openPatterns = 0;
+    for (size_t i = 0; i < query.patterns.size(); ++i) {
+        try {
+            regexes[i].emplace(query.patterns[i], std::regex_constants::icase);
+            ++openPatterns;
+        }
+        catch (const std::regex_error&) {
+        }
+    }
+
+    if (pending.empty() && openPatterns == 0) return;
+
+    // Undecorated C++ names and patterns need DIA; one pass serves all of them.
+    EnumerateSymbols(SymTagPublicSymbol, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        try {
+            CComBSTR bstrName;
+            if (FAILED(GetUndecoratedName(pSymbol, bstrName)) || !bstrName || bstrName.Length() == 0) {
+                return true;
+            }
+
+            std::wstring_view name(bstrName.m_str, bstrName.Length());
+            DWORD rva = 0;
+
+            auto it = pending.find(name);
+            if (it != pending.end() && SUCCEEDED(pSymbol->get_relativeVirtualAddress(&rva))) {
+                for (size_t index : it->second) {
+                    query.rvas[index] = static_cast<DWORD64>(rva);
+                }
+                m_symbolCache[query.names[it->second.front()]] = rva;
+                pending.erase(it);
+            }
+
+            for (size_t i = 0; i < regexes.size(); ++i) {
+                auto& matches = query.matches[i];
+                if (!regexes[i] || matches.size() >= query.maxMatches ||
+                    !std::regex_search(name.data(), name.data() + name.size(), *regexes[i])) {
+                    continue;
+                }
+
+                ULONGLONG length = 0;
+                DWORD typeId = 0;
+                if (SUCCEEDED(pSymbol->get_relativeVirtualAddress(&rva)) &&
+                    SUCCEEDED(pSymbol->get_length(&length)) &&
+                    SUCCEEDED(pSymbol->get_typeId(&typeId))) {
+
+                    std::string safeName = WStringToString(name.data(), name.size());
+                    if (!safeName.empty()) {
+                        matches.emplace_back(SymbolInfo{
+                            std::move(safeName),
+                            static_cast<DWORD64>(rva),
+                            static_cast<DWORD64>(length),
+                            typeId
+                            });
+                        if (matches.size() >= query.maxMatches) --openPatterns;
                     }
                 }
             }
-            catch (...) {
+        }
+        catch (...) {
+        }
+
+        return !pending.empty() || openPatterns > 0;
+        });
+}
+
+static uint32_t HashMemberName(std::string_view name) noexcept {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void StructInfo::BuildMemberIndex() {
+    memberSlots.clear();
+    if (members.empty()) return;
+
+    // At most half full, so every probe sequence reaches an empty slot.
+    size_t capacity = 2;
+    while (capacity < members.size() * 2) capacity <<= 1;
+    memberSlots.assign(capacity, 0);
+
+    const size_t mask = capacity - 1;
+    for (uint32_t i = 0; i < members.size(); ++i) {
+        size_t slot = HashMemberName(members[i].name) & mask;
+        bool duplicate = false;
+
+        // Like the linear scan it replaces, the first member of a given name wins.
+        while (memberSlots[slot] != 0 && !duplicate) {
+            duplicate = members[memberSlots[slot] - 1].name == members[i].name;
+            slot = (slot + 1) & mask;
+        }
+
+        if (!duplicate) memberSlots[slot] = i + 1;
+    }
+}
+
+const StructMember* StructInfo::FindMember(std::string_view memberName) const noexcept {
+    if (memberSlots.empty()) {
+        for (const auto& member : members) {
+            if (member.name == memberName) return &member;
+        }
+        return nullptr;
+    }
+
+    const size_t mask = memberSlots.size() - 1;
+    for (size_t slot = HashMemberName(memberName) & mask; memberSlots[slot] != 0; slot = (slot + 1) & mask) {
+        const StructMember& member = members[memberSlots[slot] - 1];
+        if (member.name == memberName) return &member;
+    }
+    return nullptr;
+}
+
+const EnumValue* EnumInfo::FindByValue(int64_t value) const {
+    auto it = std::lower_bound(sortedByValue.begin(), sortedByValue.end(), value,
+        [&](uint32_t index, int64_t target) { return values[index].value < target; });
+
+    if (it == sortedByValue.end() || values[*it].value != value) return nullptr;
+    return &values[*it];
+}
+
+std::vector<const EnumValue*> EnumInfo::DecomposeFlags(uint64_t value, uint64_t& remainder) const {
+    std::vector<const EnumValue*> flags;
+    uint64_t mask = size > 0 && size < 8 ? (1ULL << (size * 8)) - 1 : ~0ULL;
+    value &= mask;
+    remainder = value;
+
+    // Enumerators narrower than 64 bits are stored sign-extended, so negative constants only match
+    // once the value is widened the same way.
+    uint64_t signBit = (mask >> 1) + 1;
+    uint64_t widened = (value & signBit) != 0 ? value | ~mask : value;
+
+    const EnumValue* exact = FindByValue(static_cast<int64_t>(value));
+    if (!exact) exact = FindByValue(static_cast<int64_t>(widened));
+
+    if (exact) {
+        flags.push_back(exact);
+        remainder = 0;
+        return flags;
+    }
+
+    // Walk from the largest constant down so that named multi-bit masks win over their single bits.
+    for (auto it = sortedByValue.rbegin(); it != sortedByValue.rend() && remainder != 0; ++it) {
+        const EnumValue& candidate = values[*it];
+        uint64_t bits = static_cast<uint64_t>(candidate.value) & mask;
+
+        if (bits != 0 && (remainder & bits) == bits) {
+            flags.push_back(&candidate);
+            remainder &= ~bits;
+        }
+    }
+
+    std::reverse(flags.begin(), flags.end());
+    return flags;
+}
+
+bool PdbParser::DecodeEnum(IDiaSymbol* pSymbol, EnumInfo& enumInfo) {
+    CComBSTR bstrName;
+    if (FAILED(pSymbol->get_name(&bstrName)) || !bstrName || bstrName.Length() == 0) {
+        return false;
+    }
+
+    enumInfo.name = WStringToString(bstrName.m_str, bstrName.Length());
+
+    ULONGLONG enumSize = 0;
+    if (SUCCEEDED(pSymbol->get_length(&enumSize))) {
+        enumInfo.size = static_cast<DWORD64>(enumSize);
+    }
+
+    CComPtr<IDiaEnumSymbols> pEnumValues;
+    if (SUCCEEDED(pSymbol->findChildren(SymTagData, nullptr, nsNone, &pEnumValues))) {
+        LONG valueCount = 0;
+        if (SUCCEEDED(pEnumValues->get_Count(&valueCount)) && valueCount > 0) {
+            enumInfo.values.reserve(static_cast<size_t>(valueCount));
+        }
+
+        CComPtr<IDiaSymbol> pValue;
+        ULONG celt = 0;
+
+        while (SUCCEEDED(pEnumValues->Next(1, &pValue, &celt)) && celt == 1) {
+            CComBSTR valueName;
+            VARIANT variant;
+            VariantInit(&variant);
+
+            if (SUCCEEDED(pValue->get_name(&valueName)) && valueName && valueName.Length() > 0 &&
+                SUCCEEDED(pValue->get_value(&variant))) {
+
+                int64_t value = 0;
+                bool valid = true;
+
+                switch (variant.vt) {
+                case VT_I1: value = variant.cVal; break;
+                case VT_UI1: value = variant.bVal; break;
+                case VT_I2: value = variant.iVal; break;
+                case VT_UI2: value = variant.uiVal; break;
+                case VT_I4: value = variant.lVal; break;
+                case VT_UI4: value = variant.ulVal; break;
+                case VT_INT: value = variant.intVal; break;
+                case VT_UINT: value = variant.uintVal; break;
+                case VT_I8: value = variant.llVal; break;
+                case VT_UI8: value = static_cast<int64_t>(variant.ullVal); break;
+                default: valid = false; break;
+                }
+
+                if (valid) {
+                    enumInfo.values.push_back(EnumValue{
+                        WStringToString(valueName.m_str, valueName.Length()),
+                        value
+                        });
+                }
             }
 
-            return matches.size() < 200; // Limit
-            });
+            VariantClear(&variant);
+            pValue.Release();
+        }
+    }
+
+    IndexEnumValues(enumInfo);
+    return true;
+}
+
+const EnumInfo* PdbParser::LookupEnum(const std::wstring& enumName) const {
+    auto it = m_enumCache.find(enumName);
+    if (it != m_enumCache.end()) {
+        return &it->second;
+    }
+
+    if (m_snapshot) {
+        if (const SnapshotEnum* entry = m_snapshot->FindEnum(WStringToString(enumName))) {
+            size_t valueCount = 0;
+            const SnapshotEnumValue* values = m_snapshot->GetTable<SnapshotEnumValue>(SnapshotTable::EnumValues, valueCount);
+
+            if (entry->firstValue <= valueCount && entry->valueCount <= valueCount - entry->firstValue) {
+                EnumInfo enumInfo{};
+                enumInfo.name = std::string(m_snapshot->GetString(entry->name));
+                enumInfo.size = entry->size;
+                for (uint32_t i = 0; i < entry->valueCount; ++i) {
+                    const auto& value = values[entry->firstValue + i];
+                    enumInfo.values.push_back(EnumValue{ std::string(m_snapshot->GetString(value.name)), value.value });
+                }
+                IndexEnumValues(enumInfo);
+                return &m_enumCache.emplace(enumName, std::move(enumInfo)).first->second;
+            }
+        }
+    }
 
+    CComPtr<IDiaEnumSymbols> pEnumSymbols;
+    if (!EnsureDia() || FAILED(m_pGlobalScope->findChildren(SymTagEnum, enumName.c_str(), nsfCaseSensitive, &pEnumSymbols))) {
+        return nullptr;
     }
-    catch (const std::regex_error&) {
+
+    CComPtr<IDiaSymbol> pSymbol;
+    ULONG celt = 0;
+    if (FAILED(pEnumSymbols->Next(1, &pSymbol, &celt)) || celt != 1) {
+        return nullptr;
     }
 
-    return matches;
+    EnumInfo enumInfo{};
+    if (!DecodeEnum(pSymbol, enumInfo)) {
+        return nullptr;
+    }
+
+    return &m_enumCache.emplace(enumName, std::move(enumInfo)).first->second;
 }
 
-std::optional<StructInfo> PdbParser::GetStructInfo(const std::wstring& structName) const {
-    auto it = m_structCache.find(structName);
-    if (it != m_structCache.end()) {
-        return it->second;
+std::optional<EnumInfo> PdbParser::GetEnumInfo(const std::wstring& enumName) const {
+    try {
+        const EnumInfo* enumInfo = LookupEnum(enumName);
+        if (enumInfo) return *enumInfo;
+    }
+    catch (...) {
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> PdbParser::GetEnumValueName(const std::wstring& enumName, int64_t value) const {
+    const EnumInfo* enumInfo = LookupEnum(enumName);
+    if (!enumInfo) return std::nullopt;
+
+    const EnumValue* match = enumInfo->FindByValue(value);
+    return match ? std::optional<std::string>(match->name) : std::nullopt;
+}
+
+std::vector<std::string> PdbParser::DecomposeEnumFlags(const std::wstring& enumName, uint64_t value,
+    uint64_t* remainder) const {
+    std::vector<std::string> names;
+    uint64_t unmatched = value;
+
+    const EnumInfo* enumInfo = LookupEnum(enumName);
+    if (enumInfo) {
+        for (const EnumValue* flag : enumInfo->DecomposeFlags(value, unmatched)) {
+            names.push_back(flag->name);
+        }
+    }
+
+    if (remainder) *remainder = unmatched;
+    return names;
+}
+
+std::vector<std::wstring> PdbParser::GetAllEnumNames() const {
+    std::vector<std::wstring> names;
+
+    EnumerateSymbols(SymTagEnum, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        CComBSTR bstrName;
+        if (SUCCEEDED(pSymbol->get_name(&bstrName)) &&
+            bstrName && bstrName.Length() > 0) {
+            names.emplace_back(std::wstring(bstrName.m_str, bstrName.Length()));
+        }
+        return true;
+        });
+
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return names;
+}
+
+bool PdbParser::ForEachEnum(const std::function<bool(const EnumInfo&)>& callback) const {
+    std::unordered_set<std::wstring> seen;
+
+    return EnumerateSymbols(SymTagEnum, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        CComBSTR bstrName;
+        if (FAILED(pSymbol->get_name(&bstrName)) || !bstrName || bstrName.Length() == 0) {
+            return true;
+        }
+
+        // The same enum can be listed once per compiland that uses it; only the first is reported.
+        std::wstring key(bstrName.m_str, bstrName.Length());
+        if (!seen.insert(key).second) return true;
+
+        auto it = m_enumCache.find(key);
+        if (it == m_enumCache.end()) {
+            EnumInfo enumInfo{};
+            if (!DecodeEnum(pSymbol, enumInfo)) return true;
+            it = m_enumCache.emplace(std::move(key), std::move(enumInfo)).first;
+        }
+
+        return callback(it->second);
+        });
+}
+
+const char* PdbParser::DescribeCallingConvention(DWORD callingConvention) {
+    switch (callingConvention) {
+    case CV_CALL_NEAR_C: case CV_CALL_FAR_C: return "__cdecl";
+    case CV_CALL_NEAR_PASCAL: case CV_CALL_FAR_PASCAL: return "__pascal";
+    case CV_CALL_NEAR_FAST: case CV_CALL_FAR_FAST: return "__fastcall";
+    case CV_CALL_NEAR_STD: case CV_CALL_FAR_STD: return "__stdcall";
+    case CV_CALL_NEAR_SYS: case CV_CALL_FAR_SYS: return "__syscall";
+    case CV_CALL_THISCALL: return "__thiscall";
+    case CV_CALL_CLRCALL: return "__clrcall";
+    case CV_CALL_NEAR_VECTOR: return "__vectorcall";
+    case CV_CALL_INLINE: return "inline";
+    default: return "<unknown>";
+    }
+}
+
+void PdbParser::CollectVariables(IDiaSymbol* pScope, FunctionInfo& functionInfo) {
+    CComPtr<IDiaEnumSymbols> pChildren;
+    if (FAILED(pScope->findChildren(SymTagNull, nullptr, nsNone, &pChildren))) return;
+
+    CComPtr<IDiaSymbol> pChild;
+    ULONG celt = 0;
+
+    while (SUCCEEDED(pChildren->Next(1, &pChild, &celt)) && celt == 1) {
+        DWORD symTag = 0;
+        pChild->get_symTag(&symTag);
+
+        if (symTag == SymTagBlock) {
+            CollectVariables(pChild, functionInfo);
+        }
+        else if (symTag == SymTagData) {
+            DWORD dataKind = DataIsUnknown;
+            pChild->get_dataKind(&dataKind);
+
+            FunctionVariable variable{};
+            CComBSTR bstrName;
+            if (SUCCEEDED(pChild->get_name(&bstrName)) && bstrName) {
+                variable.name = WStringToString(bstrName.m_str, bstrName.Length());
+            }
+
+            CComPtr<IDiaSymbol> pType;
+            if (SUCCEEDED(pChild->get_type(&pType)) && pType) {
+                ULONGLONG length = 0;
+                variable.typeName = DescribeType(pType);
+                if (SUCCEEDED(pType->get_length(&length))) {
+                    variable.size = static_cast<DWORD64>(length);
+                }
+            }
+
+            pChild->get_locationType(&variable.locationType);
+            if (variable.locationType == LocIsRegRel || variable.locationType == LocIsEnregistered) {
+                pChild->get_registerId(&variable.registerId);
+            }
+            if (variable.locationType == LocIsRegRel) {
+                pChild->get_offset(&variable.offset);
+            }
+
+            if (dataKind == DataIsParam || dataKind == DataIsObjectPtr) {
+                functionInfo.parameters.push_back(std::move(variable));
+            }
+            else if (dataKind == DataIsLocal || dataKind == DataIsStaticLocal) {
+                functionInfo.locals.push_back(std::move(variable));
+            }
+        }
+
+        pChild.Release();
     }
+}
+
+IDiaEnumFrameData* PdbParser::GetFrameData() const {
+    if (!m_frameDataLoaded) {
+        m_frameDataLoaded = true;
+
+        CComPtr<IDiaEnumTables> pTables;
+        if (EnsureDia() && SUCCEEDED(m_pSession->getEnumTables(&pTables))) {
+            CComPtr<IDiaTable> pTable;
+            ULONG celt = 0;
+
+            while (SUCCEEDED(pTables->Next(1, &pTable, &celt)) && celt == 1) {
+                if (SUCCEEDED(pTable->QueryInterface(__uuidof(IDiaEnumFrameData),
+                    reinterpret_cast<void**>(&m_pFrameData))) && m_pFrameData) {
+                    break;
+                }
+                pTable.Release();
+            }
+        }
+    }
+
+    return m_pFrameData;
+}
+
+bool PdbParser::DecodeFunction(IDiaSymbol* pFunction, FunctionInfo& functionInfo) const {
+    TraceScope trace(TracePhase::DecodeFunction);
+
+    CComBSTR bstrName;
+    if (FAILED(pFunction->get_name(&bstrName)) || !bstrName || bstrName.Length() == 0) {
+        return false;
+    }
+
+    functionInfo.name = WStringToString(bstrName.m_str, bstrName.Length());
+
+    DWORD rva = 0;
+    ULONGLONG length = 0;
+    pFunction->get_relativeVirtualAddress(&rva);
+    pFunction->get_length(&length);
+    functionInfo.rva = static_cast<DWORD64>(rva);
+    functionInfo.length = static_cast<DWORD64>(length);
+
+    CComPtr<IDiaSymbol> pFunctionType;
+    if (SUCCEEDED(pFunction->get_type(&pFunctionType)) && pFunctionType) {
+        DWORD callingConvention = 0;
+        if (SUCCEEDED(pFunctionType->get_callingConvention(&callingConvention))) {
+            functionInfo.callingConvention = DescribeCallingConvention(callingConvention);
+        }
+
+        CComPtr<IDiaSymbol> pReturnType;
+        if (SUCCEEDED(pFunctionType->get_type(&pReturnType)) && pReturnType) {
+            functionInfo.returnType = DescribeType(pReturnType);
+        }
+    }
+
+    CollectVariables(pFunction, functionInfo);
+
+    // Without full symbols there are no parameter records, but the prototype still lists the types.
+    if (functionInfo.parameters.empty() && pFunctionType) {
+        CComPtr<IDiaEnumSymbols> pArgs;
+        if (SUCCEEDED(pFunctionType->findChildren(SymTagFunctionArgType, nullptr, nsNone, &pArgs))) {
+            CComPtr<IDiaSymbol> pArg;
+            ULONG celt = 0;
+
+            while (SUCCEEDED(pArgs->Next(1, &pArg, &celt)) && celt == 1) {
+                FunctionVariable parameter{};
+                CComPtr<IDiaSymbol> pArgType;
+                if (SUCCEEDED(pArg->get_type(&pArgType)) && pArgType) {
+                    ULONGLONG argLength = 0;
+                    parameter.typeName = DescribeType(pArgType);
+                    if (SUCCEEDED(pArgType->get_length(&argLength))) {
+                        parameter.size = static_cast<DWORD64>(argLength);
+                    }
+                }
+                functionInfo.parameters.push_back(std::move(parameter));
+                pArg.Release();
+            }
+        }
+    }
+
+    BOOL flag = FALSE;
+    FunctionFrame& frame = functionInfo.frame;
+    pFunction->get_frameSize(&frame.frameSize);
+    frame.framePointerPresent = SUCCEEDED(pFunction->get_framePointerPresent(&flag)) && flag;
+    frame.hasAlloca = SUCCEEDED(pFunction->get_hasAlloca(&flag)) && flag;
+    frame.hasSEH = SUCCEEDED(pFunction->get_hasSEH(&flag)) && flag;
+    frame.hasEH = SUCCEEDED(pFunction->get_hasEH(&flag)) && flag;
+    pFunction->get_localBasePointerRegisterId(&frame.localBaseRegister);
+    pFunction->get_paramBasePointerRegisterId(&frame.paramBaseRegister);
+
+    IDiaEnumFrameData* pFrames = GetFrameData();
+    CComPtr<IDiaFrameData> pFrame;
+    if (pFrames && rva != 0 && SUCCEEDED(pFrames->frameByRVA(rva, &pFrame)) && pFrame) {
+        frame.hasFrameData = true;
+        pFrame->get_lengthLocals(&frame.lengthLocals);
+        pFrame->get_lengthParams(&frame.lengthParams);
+        pFrame->get_lengthSavedRegisters(&frame.lengthSavedRegisters);
+        pFrame->get_lengthProlog(&frame.lengthProlog);
+        pFrame->get_maxStack(&frame.maxStack);
+    }
+
+    return true;
+}
+
+std::optional<FunctionInfo> PdbParser::GetFunctionInfo(const std::wstring& functionName) const {
+    auto it = m_functionCache.find(functionName);
+    if (it != m_functionCache.end()) {
+        return it->second;
+    }
+
+    try {
+        if (!EnsureDia()) return std::nullopt;
+
+        CComPtr<IDiaSymbol> pFunction;
+        CComPtr<IDiaEnumSymbols> pFunctions;
+        ULONG celt = 0;
+
+        if (SUCCEEDED(m_pGlobalScope->findChildren(SymTagFunction, functionName.c_str(), nsfCaseSensitive, &pFunctions))) {
+            pFunctions->Next(1, &pFunction, &celt);
+        }
+
+        // Decorated or public-only names resolve through the public symbol's address instead.
+        if (!pFunction) {
+            auto rva = GetSymbolRva(functionName);
+            if (rva) {
+                m_pSession->findSymbolByRVA(static_cast<DWORD>(*rva), SymTagFunction, &pFunction);
+            }
+        }
+
+        FunctionInfo functionInfo{};
+        if (pFunction && DecodeFunction(pFunction, functionInfo)) {
+            m_functionCache[functionName] = functionInfo;
+            return functionInfo;
+        }
+    }
+    catch (...) {
+    }
+
+    return std::nullopt;
+}
+
+bool PdbParser::ForEachFunction(const std::function<bool(const FunctionInfo&)>& callback,
+    size_t workerIndex, size_t workerCount) const {
+    size_t index = 0;
+
+    return EnumerateSymbols(SymTagFunction, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        if (index++ % workerCount != workerIndex) return true;
+
+        FunctionInfo functionInfo{};
+        if (DecodeFunction(pSymbol, functionInfo)) {
+            return callback(functionInfo);
+        }
+        return true;
+        });
+}
+
+std::vector<FunctionInfo> PdbParser::DecodeAllFunctions(const std::wstring& pdbPath, size_t maxThreads) {
+    size_t workerCount = maxThreads ? maxThreads : std::thread::hardware_concurrency();
+    workerCount = (std::max<size_t>)(1, workerCount);
+
+    // DIA sessions are not shared between threads, so every worker opens its own and takes every
+    // workerCount-th function of the (deterministic) enumeration.
+    std::vector<std::vector<FunctionInfo>> partitions(workerCount);
+
+    RunParallel(workerCount, workerCount, [&](size_t worker) {
+        try {
+            PdbParser parser(pdbPath);
+            parser.ForEachFunction([&](const FunctionInfo& functionInfo) -> bool {
+                partitions[worker].push_back(functionInfo);
+                return true;
+                }, worker, workerCount);
+        }
+        catch (...) {
+        }
+        });
+
+    std::vector<FunctionInfo> functions;
+    for (auto& partition : partitions) {
+        std::move(partition.begin(), partition.end(), std::back_inserter(functions));
+    }
+
+    std::sort(functions.begin(), functions.end(),
+        [](const FunctionInfo& a, const FunctionInfo& b) { return a.rva < b.rva; });
+
+    return functions;
+}
+
+std::string PdbParser::DescribeType(IDiaSymbol* pType) {
+    if (!pType) return "<unknown>";
+
+    DWORD symTag = 0;
+    if (FAILED(pType->get_symTag(&symTag))) return "<unknown>";
+
+    BOOL isConst = FALSE;
+    std::string qualifier = (SUCCEEDED(pType->get_constType(&isConst)) && isConst) ? "const " : "";
+
+    switch (symTag) {
+    case SymTagBaseType: {
+        DWORD baseType = 0;
+        ULONGLONG length = 0;
+        pType->get_baseType(&baseType);
+        pType->get_length(&length);
+
+        const char* name = "<base>";
+        switch (baseType) {
+        case btVoid: name = "void"; break;
+        case btChar: name = "char"; break;
+        case btWChar: name = "wchar_t"; break;
+        case btBool: name = "bool"; break;
+        case btLong: name = "long"; break;
+        case btULong: name = "unsigned long"; break;
+        case btHresult: name = "HRESULT"; break;
+        case btChar16: name = "char16_t"; break;
+        case btChar32: name = "char32_t"; break;
+        case btChar8: name = "char8_t"; break;
+        case btFloat: name = length == 4 ? "float" : length == 8 ? "double" : "long double"; break;
+        case btInt:
+            name = length == 1 ? "char" : length == 2 ? "short" : length == 4 ? "int" : "__int64";
+            break;
+        case btUInt:
+            name = length == 1 ? "unsigned char" : length == 2 ? "unsigned short" :
+                length == 4 ? "unsigned int" : "unsigned __int64";
+            break;
+        }
+        return qualifier + name;
+    }
+    case SymTagPointerType: {
+        CComPtr<IDiaSymbol> pPointee;
+        BOOL isReference = FALSE;
+        pType->get_reference(&isReference);
+        std::string pointee = SUCCEEDED(pType->get_type(&pPointee)) ? DescribeType(pPointee) : "<unknown>";
+        return pointee + (isReference ? "&" : "*") + (isConst ? " const" : "");
+    }
+    case SymTagArrayType: {
+        CComPtr<IDiaSymbol> pElement;
+        DWORD count = 0;
+        pType->get_count(&count);
+        std::string element = SUCCEEDED(pType->get_type(&pElement)) ? DescribeType(pElement) : "<unknown>";
+        return element + "[" + std::to_string(count) + "]";
+    }
+    case SymTagFunctionType:
+        return "<function>";
+    default: {
+        CComBSTR bstrName;
+        if (SUCCEEDED(pType->get_name(&bstrName)) && bstrName && bstrName.Length() > 0) {
+            return qualifier + WStringToString(bstrName.m_str, bstrName.Length());
+        }
+        return "<unknown>";
+    }
+    }
+}
+
+void PdbParser::DescribeMemberType(IDiaSymbol* pMember, StructMember& member) {
+    DWORD locationType = 0;
+    if (SUCCEEDED(pMember->get_locationType(&locationType)) && locationType == LocIsBitField) {
+        DWORD bitPosition = 0;
+        pMember->get_bitPosition(&bitPosition);
+        member.bitPosition = bitPosition;
+        member.bitLength = static_cast<DWORD>(member.size);
+    }
+
+    CComPtr<IDiaSymbol> pType;
+    if (FAILED(pMember->get_type(&pType)) || !pType) return;
+
+    bool indexed = false;
+    for (int depth = 0; depth < 8; ++depth) {
+        DWORD symTag = 0;
+        pType->get_symTag(&symTag);
+
+        if (symTag == SymTagUDT) {
+            CComBSTR bstrName;
+            if (SUCCEEDED(pType->get_name(&bstrName)) && bstrName && bstrName.Length() > 0) {
+                member.typeName = WStringToString(bstrName.m_str, bstrName.Length());
+            }
+            return;
+        }
+
+        // Only the outermost array dimension and one level of pointer are described.
+        if (symTag == SymTagArrayType && !indexed) {
+            DWORD count = 0;
+            ULONGLONG length = 0;
+            pType->get_count(&count);
+            pType->get_length(&length);
+            member.elementCount = count;
+            member.elementSize = count != 0 ? static_cast<DWORD64>(length / count) : 0;
+            indexed = true;
+        }
+        else if (symTag == SymTagPointerType && !member.isPointer) {
+            member.isPointer = true;
+        }
+        else {
+            return;
+        }
+
+        CComPtr<IDiaSymbol> pNext;
+        if (FAILED(pType->get_type(&pNext)) || !pNext) return;
+        pType = pNext;
+    }
+}
+
+std::shared_ptr<const MsfReader> PdbParser::GetMsf() const {
+    if (!m_msfLoaded) {
+        m_msfLoaded = true;
+        try {
+            m_msf = std::make_shared<MsfReader>(m_pdbPath);
+        }
+        catch (...) {
+            m_msf.reset();
+        }
+    }
+    return m_msf;
+}
+
+const SymbolStreams* PdbParser::GetSymbolStreams() const {
+    if (!m_symbolStreamsLoaded) {
+        m_symbolStreamsLoaded = true;
+        try {
+            if (auto msf = GetMsf()) {
+                m_symbolStreams = std::make_unique<SymbolStreams>(std::move(msf));
+            }
+        }
+        catch (...) {
+            m_symbolStreams.reset();
+        }
+    }
+    return m_symbolStreams.get();
+}
+
+const TypeStream* PdbParser::GetTypeStream() const {
+    if (!m_typeStreamLoaded) {
+        m_typeStreamLoaded = true;
+        try {
+            if (auto msf = GetMsf()) {
+                m_typeStream = std::make_unique<TypeStream>(*msf);
+            }
+        }
+        catch (...) {
+            m_typeStream.reset();
+        }
+    }
+    return m_typeStream.get();
+}
+
+bool PdbParser::DecodeClass(IDiaSymbol* pSymbol, ClassRecord& record, DWORD pointerSize) {
+    CComBSTR bstrName;
+    DWORD udtKind = 0;
+    if (FAILED(pSymbol->get_name(&bstrName)) || !bstrName || bstrName.Length() == 0 ||
+        (SUCCEEDED(pSymbol->get_udtKind(&udtKind)) && udtKind == UdtUnion)) {
+        return false;
+    }
+
+    record.name = WStringToString(bstrName.m_str, bstrName.Length());
+
+    ULONGLONG size = 0;
+    if (SUCCEEDED(pSymbol->get_length(&size))) {
+        record.size = static_cast<uint64_t>(size);
+    }
+
+    CComPtr<IDiaEnumSymbols> pEnumBases;
+    if (SUCCEEDED(pSymbol->findChildren(SymTagBaseClass, nullptr, nsNone, &pEnumBases))) {
+        CComPtr<IDiaSymbol> pBase;
+        ULONG celt = 0;
+
+        while (SUCCEEDED(pEnumBases->Next(1, &pBase, &celt)) && celt == 1) {
+            CComBSTR baseName;
+            if (SUCCEEDED(pBase->get_name(&baseName)) && baseName && baseName.Length() > 0) {
+                ClassBaseRecord base;
+                base.name = WStringToString(baseName.m_str, baseName.Length());
+
+                LONG offset = 0, vbptrOffset = 0;
+                BOOL isVirtual = FALSE, isIndirect = FALSE;
+                DWORD dispIndex = 0;
+                pBase->get_offset(&offset);
+                pBase->get_virtualBaseClass(&isVirtual);
+                pBase->get_indirectVirtualBaseClass(&isIndirect);
+
+                base.isVirtual = isVirtual || isIndirect;
+                base.isIndirect = isIndirect != FALSE;
+                if (base.isVirtual) {
+                    pBase->get_virtualBasePointerOffset(&vbptrOffset);
+                    pBase->get_virtualBaseDispIndex(&dispIndex);
+                    base.vbptrOffset = static_cast<uint64_t>(vbptrOffset >= 0 ? vbptrOffset : 0);
+                    base.vbtableIndex = dispIndex;
+                }
+                else {
+                    base.offset = static_cast<uint64_t>(offset >= 0 ? offset : 0);
+                }
+                record.bases.push_back(std::move(base));
+            }
+            pBase.Release();
+        }
+    }
+
+    // DIA reports the vftable offset for overrides as well, so every method arrives with its slot.
+    CComPtr<IDiaEnumSymbols> pEnumMethods;
+    if (SUCCEEDED(pSymbol->findChildren(SymTagFunction, nullptr, nsNone, &pEnumMethods))) {
+        CComPtr<IDiaSymbol> pMethod;
+        ULONG celt = 0;
+
+        while (SUCCEEDED(pEnumMethods->Next(1, &pMethod, &celt)) && celt == 1) {
+            BOOL isVirtual = FALSE;
+            CComBSTR methodName;
+            if (SUCCEEDED(pMethod->get_virtual(&isVirtual)) && isVirtual &&
+                SUCCEEDED(pMethod->get_name(&methodName)) && methodName) {
+                BOOL isIntroducing = FALSE, isPure = FALSE;
+                DWORD vtableOffset = 0;
+                pMethod->get_intro(&isIntroducing);
+                pMethod->get_pure(&isPure);
+
+                ClassMethodRecord method;
+                method.name = WStringToString(methodName.m_str, methodName.Length());
+                method.isIntroducing = isIntroducing != FALSE;
+                method.isPure = isPure != FALSE;
+                if (SUCCEEDED(pMethod->get_virtualBaseOffset(&vtableOffset)) && pointerSize != 0) {
+                    method.slot = vtableOffset / pointerSize;
+                }
+                record.virtualMethods.push_back(std::move(method));
+            }
+            pMethod.Release();
+        }
+    }
+
+    return true;
+}
+
+const ClassHierarchy* PdbParser::GetClassHierarchy() const {
+    if (m_classHierarchyLoaded) {
+        return m_classHierarchy.get();
+    }
+    m_classHierarchyLoaded = true;
+
+    TraceScope trace(TracePhase::ClassHierarchy);
+    const DWORD pointerSize = (m_machineType == MachineType::x86 || m_machineType == MachineType::ARM) ? 4 : 8;
+
+    try {
+        std::vector<ClassRecord> records;
+
+        if (const TypeStream* types = GetTypeStream()) {
+            auto typeIndices = types->GetUdtTypeIndices();
+            records.resize(typeIndices.size());
+
+            RunParallel(typeIndices.size(), 0, [&](size_t i) {
+                try {
+                    NativeClass cls;
+                    if (!types->DecodeClass(typeIndices[i], cls)) return;
+
+                    ClassRecord& record = records[i];
+                    record.name = std::string(cls.name);
+                    record.size = cls.size;
+                    for (const auto& base : cls.bases) {
+                        record.bases.push_back({ std::string(base.name), base.offset, base.isVirtual, base.isIndirect,
+                            base.vbptrOffset, static_cast<uint32_t>(base.vbtableIndex) });
+                    }
+                    for (const auto& method : cls.virtualMethods) {
+                        ClassMethodRecord methodRecord;
+                        methodRecord.name = std::string(method.name);
+                        methodRecord.signature = method.argumentList;
+                        methodRecord.isIntroducing = method.vtableOffset.has_value();
+                        methodRecord.isPure = method.isPure;
+                        if (method.vtableOffset) {
+                            methodRecord.slot = *method.vtableOffset / pointerSize;
+                        }
+                        record.virtualMethods.push_back(std::move(methodRecord));
+                    }
+                }
+                catch (...) {
+                    records[i] = ClassRecord{};
+                }
+                });
+        }
+        else {
+            EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+                try {
+                    ClassRecord record;
+                    if (DecodeClass(pSymbol, record, pointerSize)) {
+                        records.push_back(std::move(record));
+                    }
+                }
+                catch (...) {
+                }
+                return true;
+                });
+        }
+
+        m_classHierarchy = std::make_unique<ClassHierarchy>(std::move(records));
+    }
+    catch (...) {
+        m_classHierarchy.reset();
+    }
+
+    return m_classHierarchy.get();
+}
+
+GlobalSymbolInfo PdbParser::MakeGlobalSymbol(const NativeDataSymbol& symbol) const {
+    GlobalSymbolInfo global{};
+    global.name = std::string(symbol.name);
+    global.section = symbol.section;
+    global.offset = symbol.offset;
+    global.isStatic = symbol.kind == CodeViewSymbolKind::S_LDATA32 || symbol.kind == CodeViewSymbolKind::S_LTHREAD32;
+    global.isThreadLocal = symbol.kind == CodeViewSymbolKind::S_GTHREAD32 || symbol.kind == CodeViewSymbolKind::S_LTHREAD32;
+
+    // Thread-local offsets are relative to the TLS block, not the image.
+    if (!global.isThreadLocal) {
+        global.rva = m_symbolStreams->SectionOffsetToRva(symbol.section, symbol.offset).value_or(0);
+    }
+
+    // The type index is the same for every global of that type, so DIA is asked once per distinct type
+    // through whichever symbol first uses it.
+    auto it = m_globalTypeCache.find(symbol.typeIndex);
+    if (it == m_globalTypeCache.end()) {
+        GlobalTypeInfo typeInfo;
+        CComPtr<IDiaSymbol> pData;
+        bool hasDia = EnsureDia();
+
+        if (hasDia && global.rva != 0) {
+            CComPtr<IDiaSymbol> pCandidate;
+            CComBSTR bstrName;
+            if (SUCCEEDED(m_pSession->findSymbolByRVA(static_cast<DWORD>(global.rva), SymTagData, &pCandidate)) && pCandidate &&
+                SUCCEEDED(pCandidate->get_name(&bstrName)) && bstrName &&
+                WStringToString(bstrName.m_str, bstrName.Length()) == global.name) {
+                pData = pCandidate;
+            }
+        }
+
+        if (hasDia && !pData) {
+            std::wstring wname(global.name.begin(), global.name.end());
+            CComPtr<IDiaEnumSymbols> pEnum;
+            ULONG celt = 0;
+            if (SUCCEEDED(m_pGlobalScope->findChildren(SymTagData, wname.c_str(), nsfCaseSensitive, &pEnum))) {
+                pEnum->Next(1, &pData, &celt);
+            }
+        }
+
+        // A failed lookup is not cached, so a later global of the same type that DIA can find still
+        // gets its type.
+        CComPtr<IDiaSymbol> pType;
+        if (!pData || FAILED(pData->get_type(&pType)) || !pType) {
+            return global;
+        }
+
+        ULONGLONG length = 0;
+        typeInfo.name = DescribeType(pType);
+        if (SUCCEEDED(pType->get_length(&length))) {
+            typeInfo.size = static_cast<DWORD64>(length);
+        }
+        pData->get_typeId(&typeInfo.typeId);
+
+        it = m_globalTypeCache.emplace(symbol.typeIndex, std::move(typeInfo)).first;
+    }
+
+    global.typeName = it->second.name;
+    global.size = it->second.size;
+    global.typeId = it->second.typeId;
+    return global;
+}
+
+std::optional<GlobalSymbolInfo> PdbParser::FindGlobalSymbolDia(const std::wstring& name) const {
+    CComPtr<IDiaEnumSymbols> pEnum;
+    if (!EnsureDia() || FAILED(m_pGlobalScope->findChildren(SymTagData, name.c_str(), nsfCaseSensitive, &pEnum))) {
+        return std::nullopt;
+    }
+
+    CComPtr<IDiaSymbol> pData;
+    ULONG celt = 0;
+
+    while (SUCCEEDED(pEnum->Next(1, &pData, &celt)) && celt == 1) {
+        DWORD locationType = LocIsNull;
+        pData->get_locationType(&locationType);
+
+        if (locationType == LocIsStatic || locationType == LocIsTLS) {
+            GlobalSymbolInfo global{};
+            global.name = WStringToString(name);
+            global.isThreadLocal = locationType == LocIsTLS;
+
+            DWORD dataKind = DataIsUnknown, section = 0, offset = 0, rva = 0;
+            pData->get_dataKind(&dataKind);
+            pData->get_addressSection(&section);
+            pData->get_addressOffset(&offset);
+            pData->get_typeId(&global.typeId);
+            if (!global.isThreadLocal && SUCCEEDED(pData->get_relativeVirtualAddress(&rva))) {
+                global.rva = static_cast<DWORD64>(rva);
+            }
+
+            global.isStatic = dataKind == DataIsFileStatic;
+            global.section = static_cast<WORD>(section);
+            global.offset = offset;
+
+            CComPtr<IDiaSymbol> pType;
+            if (SUCCEEDED(pData->get_type(&pType)) && pType) {
+                ULONGLONG length = 0;
+                global.typeName = DescribeType(pType);
+                if (SUCCEEDED(pType->get_length(&length))) {
+                    global.size = static_cast<DWORD64>(length);
+                }
+            }
+
+            return global;
+        }
+
+        pData.Release();
+    }
+
+    return std::nullopt;
+}
+
+std::optional<GlobalSymbolInfo> PdbParser::GetGlobalSymbol(const std::wstring& name) const {
+    TraceScope trace(TracePhase::SymbolLookup);
+
+    try {
+        const SymbolStreams* streams = GetSymbolStreams();
+        if (!streams) {
+            return FindGlobalSymbolDia(name);
+        }
+
+        auto symbol = streams->FindGlobalData(WStringToString(name));
+        if (!symbol) return std::nullopt;
+
+        return MakeGlobalSymbol(*symbol);
+    }
+    catch (...) {
+        return std::nullopt;
+    }
+}
+
+bool PdbParser::ForEachGlobalSymbol(const std::function<bool(const GlobalSymbolInfo&)>& callback) const {
+    const SymbolStreams* streams = GetSymbolStreams();
+    if (!streams) return false;
+
+    streams->ForEachGlobalData([&](const NativeDataSymbol& symbol) -> bool {
+        Tracer::Count(TraceCounter::SymbolsVisited);
+        try {
+            return callback(MakeGlobalSymbol(symbol));
+        }
+        catch (...) {
+            return true;
+        }
+        });
+
+    return true;
+}
+
+std::vector<GlobalSymbolInfo> PdbParser::FindGlobalsByPattern(const std::wstring& pattern) const {
+    return std::move(FindGlobalsByPatterns({ pattern }).front());
+}
+
+std::vector<std::vector<GlobalSymbolInfo>> PdbParser::FindGlobalsByPatterns(const std::vector<std::wstring>& patterns) const {
+    TraceScope trace(TracePhase::PatternSearch);
+    std::vector<std::vector<GlobalSymbolInfo>> matches(patterns.size());
+
+    std::vector<std::optional<std::regex>> regexes(patterns.size());
+    size_t openPatterns = 0;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        try {
+            regexes[i].emplace(WStringToString(patterns[i]), std::regex_constants::icase);
+            ++openPatterns;
+        }
+        catch (const std::regex_error&) {
+        }
+    }
+
+    const SymbolStreams* streams = openPatterns > 0 ? GetSymbolStreams() : nullptr;
+    if (streams) {
+        streams->ForEachGlobalData([&](const NativeDataSymbol& symbol) -> bool {
+            for (size_t i = 0; i < regexes.size(); ++i) {
+                if (!regexes[i] || matches[i].size() >= 200) continue;
+                try {
+                    if (std::regex_search(symbol.name.begin(), symbol.name.end(), *regexes[i])) {
+                        matches[i].push_back(MakeGlobalSymbol(symbol));
+                        if (matches[i].size() >= 200) --openPatterns;
+                    }
+                }
+                catch (...) {
+                }
+            }
+            return openPatterns > 0;
+            });
+    }
+
+    for (auto& list : matches) {
+        std::sort(list.begin(), list.end(),
+            [](const GlobalSymbolInfo& a, const GlobalSymbolInfo& b) { return a.rva < b.rva; });
+    }
+
+    return matches;
+}
+
+const StructInfo* PdbParser::LookupStruct(const std::wstring& structName) const {
+    auto it = m_structCache.find(structName);
+    if (it != m_structCache.end()) {
+        Tracer::Count(TraceCounter::StructCacheHits);
+        return &it->second;
+    }
+
+    Tracer::Count(TraceCounter::StructCacheMisses);
+    return ParseStructInternal(structName);
+}
+
+std::optional<StructInfo> PdbParser::GetStructInfo(const std::wstring& structName) const {
+    const StructInfo* structInfo = LookupStruct(structName);
+    if (structInfo) return *structInfo;
+    return std::nullopt;
+}
+
+std::vector<std::optional<StructInfo>> PdbParser::GetStructInfos(const std::vector<std::wstring>& structNames) const {
+    std::vector<std::optional<StructInfo>> structs(structNames.size());
+    std::unordered_map<std::wstring_view, std::vector<size_t>> pending;
+
+    for (size_t i = 0; i < structNames.size(); ++i) {
+        auto it = m_structCache.find(structNames[i]);
+        if (it != m_structCache.end()) {
+            Tracer::Count(TraceCounter::StructCacheHits);
+            structs[i] = it->second;
+            continue;
+        }
+
+        Tracer::Count(TraceCounter::StructCacheMisses);
+        if (const StructInfo* structInfo = ParseStructInternal(structNames[i], false)) {
+            structs[i] = *structInfo;
+        }
+        else {
+            pending[structNames[i]].push_back(i);
+        }
+    }
+
+    if (pending.empty()) return structs;
+
+    TraceScope trace(TracePhase::StructLookup);
+    EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        try {
+            CComBSTR bstrName;
+            if (FAILED(pSymbol->get_name(&bstrName)) || !bstrName || bstrName.Length() == 0) {
+                return true;
+            }
+
+            auto it = pending.find(std::wstring_view(bstrName.m_str, bstrName.Length()));
+            if (it == pending.end()) return true;
+
+            StructInfo structInfo;
+            if (DecodeStruct(pSymbol, structInfo)) {
+                structInfo.BuildMemberIndex();
+                const StructInfo& cached = m_structCache[std::wstring(it->first)] = std::move(structInfo);
+                for (size_t index : it->second) {
+                    structs[index] = cached;
+                }
+            }
+            pending.erase(it);
+        }
+        catch (...) {
+        }
+        return !pending.empty();
+        });
+
+    return structs;
+}
+
+bool PdbParser::DecodeStruct(IDiaSymbol* pSymbol, StructInfo& structInfo) {
+    TraceScope trace(TracePhase::DecodeStruct);
+    Tracer::Count(TraceCounter::StructsDecoded);
+
+    CComBSTR bstrName;
+    if (FAILED(pSymbol->get_name(&bstrName)) || !bstrName || bstrName.Length() == 0) {
+        return false;
+    }
+
+    structInfo.name = WStringToString(bstrName.m_str, bstrName.Length());
+
+    ULONGLONG structSize = 0;
+    if (SUCCEEDED(pSymbol->get_length(&structSize))) {
+        structInfo.size = static_cast<DWORD64>(structSize);
+    }
+
+    DWORD udtKind = 0;
+    structInfo.isUnion = SUCCEEDED(pSymbol->get_udtKind(&udtKind)) && udtKind == UdtUnion;
+
+    CComPtr<IDiaEnumSymbols> pEnumMembers;
+    if (SUCCEEDED(pSymbol->findChildren(SymTagData, nullptr, nsNone, &pEnumMembers))) {
+        LONG memberCount = 0;
+        if (SUCCEEDED(pEnumMembers->get_Count(&memberCount)) && memberCount > 0) {
+            structInfo.members.reserve(static_cast<size_t>(memberCount));
+        }
+
+        CComPtr<IDiaSymbol> pMember;
+        ULONG celt = 0;
+
+        while (SUCCEEDED(pEnumMembers->Next(1, &pMember, &celt)) && celt == 1) {
+
+            try {
+                CComBSTR memberName;
+                LONG offset = 0;
+                ULONGLONG memberSize = 0;
+                DWORD typeId = 0;
+                DWORD dataKind = 0;
+
+                // Static members are data children too, but they occupy no space in the instance.
+                if (!(SUCCEEDED(pMember->get_dataKind(&dataKind)) && dataKind == DataIsStaticMember) &&
+                    SUCCEEDED(pMember->get_name(&memberName)) &&
+                    memberName && memberName.Length() > 0 &&
+                    SUCCEEDED(pMember->get_offset(&offset)) &&
+                    SUCCEEDED(pMember->get_length(&memberSize)) &&
+                    SUCCEEDED(pMember->get_typeId(&typeId))) {
+
+                    std::string safeMemberName = WStringToString(memberName.m_str, memberName.Length());
+
+                    if (!safeMemberName.empty()) {
+                        structInfo.members.emplace_back(StructMember{
+                            std::move(safeMemberName),
+                            static_cast<DWORD64>(offset >= 0 ? offset : 0),
+                            static_cast<DWORD64>(memberSize),
+                            typeId,
+                            std::string(),
+                            0,
+                            0,
+                            0,
+                            0,
+                            false
+                            });
+                        DescribeMemberType(pMember, structInfo.members.back());
+                    }
+                }
+            }
+            catch (...) {
+            }
+
+            pMember.Release();
+        }
+    }
+
+    std::sort(structInfo.members.begin(), structInfo.members.end(),
+        [](const StructMember& a, const StructMember& b) { return a.offset < b.offset; });
+
+    return true;
+}
+
+bool PdbParser::DecodeNativeStruct(const TypeStream& types, uint32_t typeIndex, StructInfo& structInfo) const {
+    TraceScope trace(TracePhase::DecodeStruct);
+    Tracer::Count(TraceCounter::StructsDecoded);
+
+    try {
+        NativeUdt udt;
+        if (!types.DecodeUdt(typeIndex, udt) || udt.name.empty()) return false;
+
+        structInfo.name = std::string(udt.name);
+        structInfo.size = udt.size;
+        structInfo.isUnion = udt.isUnion;
+        structInfo.members.reserve(udt.members.size());
+        for (const auto& member : udt.members) {
+            structInfo.members.emplace_back(StructMember{
+                std::string(member.name),
+                member.offset,
+                member.size,
+                member.typeIndex,
+                std::string(member.typeName),
+                member.elementSize,
+                member.elementCount,
+                member.bitPosition,
+                member.bitLength,
+                member.isPointer
+                });
+        }
+        return true;
+    }
+    catch (...) {
+        structInfo = StructInfo{};
+        return false;
+    }
+}
+
+const StructInfo* PdbParser::ParseStructInternal(const std::wstring& structName, bool useDia) const {
+    TraceScope trace(TracePhase::StructLookup);
+    StructInfo structInfo;
+    bool found = false;
+
+    if (m_snapshot) {
+        if (const SnapshotStruct* entry = m_snapshot->FindStruct(WStringToString(structName))) {
+            size_t memberCount = 0;
+            const SnapshotMember* members = m_snapshot->GetTable<SnapshotMember>(SnapshotTable::Members, memberCount);
+
+            if (entry->firstMember <= memberCount && entry->memberCount <= memberCount - entry->firstMember) {
+                structInfo.name = std::string(m_snapshot->GetString(entry->name));
+                structInfo.size = entry->size;
+                structInfo.isUnion = (entry->flags & SnapshotStructUnion) != 0;
+                structInfo.members.reserve(entry->memberCount);
+                for (uint32_t i = 0; i < entry->memberCount; ++i) {
+                    const auto& member = members[entry->firstMember + i];
+                    structInfo.members.emplace_back(StructMember{
+                        std::string(m_snapshot->GetString(member.name)),
+                        member.offset,
+                        member.size,
+                        member.typeId,
+                        std::string(m_snapshot->GetString(member.typeName)),
+                        member.elementSize,
+                        member.elementCount,
+                        member.bitPosition,
+                        member.bitLength,
+                        (member.flags & SnapshotMemberPointer) != 0
+                        });
+                }
+                structInfo.BuildMemberIndex();
+                return &(m_structCache[structName] = std::move(structInfo));
+            }
+        }
+    }
+
+    if (const TypeStream* types = GetTypeStream()) {
+        auto typeIndex = types->FindUdt(WStringToString(structName));
+        if (typeIndex && DecodeNativeStruct(*types, *typeIndex, structInfo)) {
+            structInfo.BuildMemberIndex();
+            return &(m_structCache[structName] = std::move(structInfo));
+        }
+    }
+
+    if (!useDia) return nullptr;
+
+    EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        try {
+            CComBSTR bstrName;
+            if (SUCCEEDED(pSymbol->get_name(&bstrName)) &&
+                bstrName && bstrName.Length() > 0) {
+
+                if (wcscmp(structName.c_str(), bstrName.m_str) == 0) {
+                    found = DecodeStruct(pSymbol, structInfo);
+                    return false;
+                }
+            }
+        }
+        catch (...) {
+        }
+        return true;
+        });
+
+    if (found) {
+        structInfo.BuildMemberIndex();
+        return &(m_structCache[structName] = std::move(structInfo));
+    }
+
+    return nullptr;
+}
+
+std::optional<DWORD64> PdbParser::GetStructMemberOffset(const std::wstring& structName,
+    const std::wstring& memberName) const {
+    const StructInfo* structInfo = LookupStruct(structName);
+    if (!structInfo) return std::nullopt;
+
+    const StructMember* member = structInfo->FindMember(ConvertToUtf8(memberName.data(), memberName.size()));
+    return member ? std::optional<DWORD64>(member->offset) : std::nullopt;
+}
+
+uint64_t FieldPath::ExtractBits(uint64_t raw) const noexcept {
+    if (!IsBitfield()) return raw;
+    uint64_t mask = bitLength >= 64 ? ~0ull : ((1ull << bitLength) - 1);
+    return (raw >> bitPosition) & mask;
+}
+
+std::optional<DWORD64> FieldPath::Resolve(DWORD64 base, const PointerReader& readPointer) const {
+    if (offsets.empty()) return std::nullopt;
+
+    DWORD64 address = base + offsets.front();
+    for (size_t i = 1; i < offsets.size(); ++i) {
+        DWORD64 pointer = 0;
+        if (!readPointer || !readPointer(address, pointer) || pointer == 0) return std::nullopt;
+        address = pointer + offsets[i];
+    }
+    return address;
+}
+
+void FieldPath::ResolveBatch(const std::vector<DWORD64>& bases, std::vector<DWORD64>& addresses,
+    const PointerReader& readPointer) const {
+    addresses.resize(bases.size());
+
+    if (IsDirect()) {
+        const DWORD64 offset = offsets.front();
+        for (size_t i = 0; i < bases.size(); ++i) {
+            addresses[i] = bases[i] + offset;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < bases.size(); ++i) {
+        addresses[i] = Resolve(bases[i], readPointer).value_or(INVALID_OFFSET);
+    }
+}
+
+namespace {
+    // Bytes lying entirely inside the bit range [begin, end); the partial bytes at either end are
+    // reported as bit holes instead.
+    DWORD64 WholeBytesBetween(DWORD64 beginBit, DWORD64 endBit) noexcept {
+        DWORD64 firstByte = (beginBit + 7) / 8;
+        DWORD64 lastByte = endBit / 8;
+        return lastByte > firstByte ? lastByte - firstByte : 0;
+    }
+}
+
+StructLayoutReport StructLayoutReport::Analyze(const StructInfo& structInfo, DWORD64 cacheLineSize) {
+    if (cacheLineSize == 0) cacheLineSize = 64;
+
+    StructLayoutReport report;
+    report.name = structInfo.name;
+    report.size = structInfo.size;
+    report.isUnion = structInfo.isUnion;
+    report.memberCount = structInfo.members.size();
+
+    struct Span {
+        DWORD64 begin;
+        DWORD64 end;
+        const StructMember* member;
+    };
+
+    std::vector<Span> spans;
+    spans.reserve(structInfo.members.size());
+
+    for (const auto& member : structInfo.members) {
+        DWORD64 begin = member.offset * 8 + (member.bitLength ? member.bitPosition : 0);
+        DWORD64 bits = member.bitLength ? member.bitLength : member.size * 8;
+        if (bits == 0) continue;
+
+        spans.push_back({ begin, begin + bits, &member });
+
+        // Members wider than a line always span several; only the ones that would fit are flagged.
+        DWORD64 firstByte = begin / 8;
+        DWORD64 lastByte = (begin + bits - 1) / 8;
+        if (lastByte - firstByte < cacheLineSize && firstByte / cacheLineSize != lastByte / cacheLineSize) {
+            report.straddlers.push_back({ member.name, firstByte, lastByte - firstByte + 1 });
+        }
+    }
+
+    std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) { return a.begin < b.begin; });
+
+    DWORD64 sizeBits = structInfo.size * 8;
+    DWORD64 coveredEnd = spans.empty() ? sizeBits : spans.front().begin;
+    const StructMember* previous = nullptr;
+
+    for (const auto& span : spans) {
+        if (span.begin > coveredEnd) {
+            DWORD64 wholeBytes = WholeBytesBetween(coveredEnd, span.begin);
+            report.holes.push_back({ previous ? previous->name : std::string(), coveredEnd, span.begin - coveredEnd });
+            report.holeBytes += wholeBytes;
+            report.bitHoleBits += span.begin - coveredEnd - wholeBytes * 8;
+        }
+
+        if (span.end > coveredEnd) {
+            coveredEnd = span.end;
+            previous = span.member;
+        }
+    }
+
+    if (sizeBits > coveredEnd) {
+        DWORD64 wholeBytes = WholeBytesBetween(coveredEnd, sizeBits);
+        report.tailPadding = wholeBytes;
+        report.bitHoleBits += sizeBits - coveredEnd - wholeBytes * 8;
+    }
+
+    report.wastedBytes = report.holeBytes + report.tailPadding + report.bitHoleBits / 8;
+    report.cacheLines = (report.size + cacheLineSize - 1) / cacheLineSize;
+    report.packedCacheLines = (report.size - (std::min)(report.size, report.wastedBytes) + cacheLineSize - 1) / cacheLineSize;
+    return report;
+}
+
+std::vector<StructLayoutReport> PdbParser::AnalyzeLayouts(size_t maxThreads, DWORD64 cacheLineSize) const {
+    TraceScope trace(TracePhase::LayoutReport);
+    std::vector<StructLayoutReport> reports;
+
+    try {
+        if (const TypeStream* types = GetTypeStream()) {
+            auto typeIndices = types->GetUdtTypeIndices();
+            std::vector<std::optional<StructLayoutReport>> results(typeIndices.size());
+
+            RunParallel(typeIndices.size(), maxThreads, [&](size_t i) {
+                StructInfo structInfo;
+                if (DecodeNativeStruct(*types, typeIndices[i], structInfo)) {
+                    results[i] = StructLayoutReport::Analyze(structInfo, cacheLineSize);
+                }
+                });
+
+            reports.reserve(results.size());
+            for (auto& result : results) {
+                if (result) reports.push_back(std::move(*result));
+            }
+        }
+        else {
+            // A DIA session is not shared across threads, so decoding stays serial and only the
+            // analysis fans out.
+            std::vector<StructInfo> structs;
+            std::unordered_set<std::string> seen;
+            EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+                try {
+                    StructInfo structInfo;
+                    if (DecodeStruct(pSymbol, structInfo) && seen.insert(structInfo.name).second) {
+                        structs.push_back(std::move(structInfo));
+                    }
+                }
+                catch (...) {
+                }
+                return true;
+                });
+
+            reports.resize(structs.size());
+            RunParallel(structs.size(), maxThreads, [&](size_t i) {
+                reports[i] = StructLayoutReport::Analyze(structs[i], cacheLineSize);
+                });
+        }
+    }
+    catch (...) {
+    }
+
+    std::sort(reports.begin(), reports.end(), [](const StructLayoutReport& a, const StructLayoutReport& b) {
+        if (a.wastedBytes != b.wastedBytes) return a.wastedBytes > b.wastedBytes;
+        if (a.straddlers.size() != b.straddlers.size()) return a.straddlers.size() > b.straddlers.size();
+        return a.name < b.name;
+        });
+
+    return reports;
+}
+
+std::optional<FieldPath> PdbParser::CompileFieldPath(const std::wstring& path) const {
+    TraceScope trace(TracePhase::StructLookup);
+
+    try {
+        std::string expression = WStringToString(path);
+        auto isSeparator = [&](size_t position) {
+            return expression[position] == '.' || expression[position] == '[' ||
+                expression.compare(position, 2, "->") == 0;
+        };
+
+        size_t position = 0;
+        auto readName = [&]() {
+            size_t start = position;
+            while (position < expression.size() && !isSeparator(position)) ++position;
+            return expression.substr(start, position - start);
+        };
+
+        FieldPath fieldPath;
+        fieldPath.rootType = readName();
+        fieldPath.offsets.push_back(0);
+        if (fieldPath.rootType.empty()) return std::nullopt;
+
+        const StructInfo* root = LookupStruct(std::wstring(fieldPath.rootType.begin(), fieldPath.rootType.end()));
+        if (!root) return std::nullopt;
+
+        // State of the value the path currently points at.
+        std::string typeName = fieldPath.rootType;
+        DWORD64 size = root->size;
+        DWORD64 elementSize = 0;
+        DWORD elementCount = 0;
+        bool arrayPending = false;
+        bool isPointer = false;
+
+        auto selectMember = [&](const std::string& memberName) -> bool {
+            const StructInfo* structInfo = LookupStruct(std::wstring(typeName.begin(), typeName.end()));
+            if (!structInfo) return false;
+
+            const StructMember* member = structInfo->FindMember(memberName);
+            if (!member) return false;
+
+            fieldPath.offsets.back() += member->offset;
+            typeName = member->typeName;
+            size = member->size;
+            elementSize = member->elementSize;
+            elementCount = member->elementCount;
+            arrayPending = member->elementSize != 0;
+            isPointer = member->isPointer;
+            fieldPath.bitPosition = member->bitPosition;
+            fieldPath.bitLength = member->bitLength;
+            return true;
+        };
+
+        while (position < expression.size()) {
+            if (fieldPath.IsBitfield()) return std::nullopt;
+
+            if (expression[position] == '.') {
+                ++position;
+                if (arrayPending || isPointer || typeName.empty() || !selectMember(readName())) return std::nullopt;
+            }
+            else if (expression.compare(position, 2, "->") == 0) {
+                position += 2;
+                if (arrayPending || !isPointer || typeName.empty()) return std::nullopt;
+
+                fieldPath.pointerSize = static_cast<DWORD>(size);
+                fieldPath.offsets.push_back(0);
+                isPointer = false;
+                if (!selectMember(readName())) return std::nullopt;
+            }
+            else {
+                size_t close = expression.find(']', position);
+                if (!arrayPending || close == std::string::npos) return std::nullopt;
+
+                std::string indexText = expression.substr(position + 1, close - position - 1);
+                size_t parsed = 0;
+                DWORD64 index = std::stoull(indexText, &parsed, 0);
+                if (parsed != indexText.size() || (elementCount != 0 && index >= elementCount)) return std::nullopt;
+
+                fieldPath.offsets.back() += index * elementSize;
+                size = elementSize;
+                arrayPending = false;
+                position = close + 1;
+            }
+        }
+
+        fieldPath.size = fieldPath.IsBitfield() ? (fieldPath.bitPosition + fieldPath.bitLength + 7) / 8 : size;
+        fieldPath.typeName = typeName;
+        return fieldPath;
+    }
+    catch (...) {
+        return std::nullopt;
+    }
+}
+
+void PdbParser::PreloadSymbols() {
+    TraceScope trace(TracePhase::PreloadSymbols);
+    auto symbols = GetAllPublicSymbols();
+    for (const auto& symbol : symbols) {
+        std::wstring wname = std::wstring(symbol.name.begin(), symbol.name.end());
+        m_symbolCache[wname] = symbol.rva;
+    }
+}
+
+void PdbParser::PreloadStructures() {
+    TraceScope trace(TracePhase::PreloadStructures);
+    EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        try {
+            CComBSTR bstrName;
+            if (FAILED(pSymbol->get_name(&bstrName)) || !bstrName || bstrName.Length() == 0) {
+                return true;
+            }
+
+            std::wstring key(bstrName.m_str, bstrName.Length());
+            if (m_structCache.find(key) != m_structCache.end()) {
+                return true;
+            }
+
+            StructInfo structInfo;
+            if (DecodeStruct(pSymbol, structInfo)) {
+                structInfo.BuildMemberIndex();
+                m_structCache.emplace(std::move(key), std::move(structInfo));
+            }
+        }
+        catch (...) {
+        }
+        return true;
+        });
+}
+
+void PdbParser::ClearCaches() noexcept {
+    m_symbolCache.clear();
+    m_structCache.clear();
+    m_enumCache.clear();
+    m_functionCache.clear();
+    m_layoutHashCache.clear();
+    m_layoutHashesComputed = false;
+    m_globalTypeCache.clear();
+    m_addressTable.clear();
+    m_addressTableLoaded = false;
+}
+
+bool PdbParser::SaveSnapshot(const std::wstring& snapshotPath) {
+    TraceScope trace(TracePhase::SaveSnapshot);
+
+    try {
+        auto msf = GetMsf();
+        std::optional<PdbSignature> signature = msf ? PdbSignature::Read(*msf) : std::nullopt;
+        if (!signature) return false;
+
+        SnapshotBuilder builder;
+
+        ForEachPublicSymbol([&](const SymbolInfo& symbol) -> bool {
+            builder.AddSymbol(symbol.name, symbol.rva);
+            return true;
+            });
+
+        PreloadStructures();
+        for (const auto& [name, structInfo] : m_structCache) {
+            builder.AddStruct(WStringToString(name), structInfo.size, structInfo.isUnion);
+            for (const auto& member : structInfo.members) {
+                builder.AddMember(member.name, member.offset, member.size, member.typeId, member.typeName,
+                    member.elementSize, member.elementCount, member.bitPosition, member.bitLength, member.isPointer);
+            }
+        }
+
+        ForEachEnum([&](const EnumInfo& enumInfo) -> bool {
+            builder.AddEnum(enumInfo.name, enumInfo.size);
+            for (const auto& value : enumInfo.values) {
+                builder.AddEnumValue(value.name, value.value);
+            }
+            return true;
+            });
+
+        for (const auto& [name, hash] : ComputeLayoutHashes()) {
+            builder.AddLayoutHash(name, hash.high, hash.low);
+        }
+
+        return builder.Write(snapshotPath, *signature);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+bool PdbParser::LoadSnapshot(const std::wstring& snapshotPath) {
+    TraceScope trace(TracePhase::LoadSnapshot);
+
+    try {
+        auto msf = GetMsf();
+        std::optional<PdbSignature> signature = msf ? PdbSignature::Read(*msf) : std::nullopt;
+
+        // A snapshot taken from any other build of the PDB would answer with stale offsets.
+        auto snapshot = std::make_unique<Snapshot>(snapshotPath);
+        if (!signature || snapshot->GetSignature() != *signature) return false;
+
+        m_snapshot = std::move(snapshot);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+std::vector<std::wstring> PdbParser::GetAllStructNames() const {
+    std::vector<std::wstring> names;
+    names.reserve(500);
+
+    EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        try {
+            CComBSTR bstrName;
+            if (SUCCEEDED(pSymbol->get_name(&bstrName)) &&
+                bstrName && bstrName.Length() > 0) {
+                names.emplace_back(std::wstring(bstrName.m_str, bstrName.Length()));
+            }
+        }
+        catch (...) {
+        }
+
+        return names.size() < 1000; // Limit
+        });
+
+    return names;
+}
+
+bool PdbParser::ForEachStruct(const std::function<bool(const StructInfo&)>& callback) const {
+    if (const TypeStream* types = GetTypeStream()) {
+        for (uint32_t typeIndex : types->GetUdtTypeIndices()) {
+            StructInfo structInfo;
+            if (DecodeNativeStruct(*types, typeIndex, structInfo) && !callback(structInfo)) break;
+        }
+        return true;
+    }
+
+    std::unordered_set<std::string> seen;
+    return EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        StructInfo structInfo;
+        if (!DecodeStruct(pSymbol, structInfo) || !seen.insert(structInfo.name).second) return true;
+        return callback(structInfo);
+        });
+}
+
+namespace {
+    // FNV-1a over 128 bits; the prime is 2^88 + 0x13B so the multiply splits into a shift and a small product.
+    class LayoutHasher {
+    public:
+        void Update(const void* data, size_t size) {
+            const BYTE* bytes = static_cast<const BYTE*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                m_low ^= bytes[i];
+                Multiply();
+            }
+        }
+
+        void Update(uint64_t value) {
+            BYTE bytes[8];
+            for (int i = 0; i < 8; ++i) {
+                bytes[i] = static_cast<BYTE>(value >> (i * 8));
+            }
+            Update(bytes, sizeof(bytes));
+        }
+
+        void Update(std::string_view value) {
+            Update(value.data(), value.size());
+            Update(static_cast<uint64_t>(value.size()));
+        }
+
+        void Update(const LayoutHash& value) {
+            Update(value.high);
+            Update(value.low);
+        }
+
+        LayoutHash Finish() const { return LayoutHash{ m_high, m_low }; }
+
+    private:
+        uint64_t m_high = 0x6c62272e07bb0142ull;
+        uint64_t m_low = 0x62b821756295c58dull;
+
+        void Multiply() {
+            const uint64_t prime = 0x13B;
+            uint64_t lo32 = m_low & 0xffffffffull;
+            uint64_t hi32 = m_low >> 32;
+            uint64_t p0 = lo32 * prime;
+            uint64_t p1 = hi32 * prime;
+            uint64_t carry = (p1 + (p0 >> 32)) >> 32;
+
+            uint64_t newLow = m_low * prime;
+            uint64_t newHigh = m_high * prime + carry + (m_low << 24);
+
+            m_low = newLow;
+            m_high = newHigh;
+        }
+    };
+
+    struct LayoutField {
+        std::pmr::string name;
+        DWORD64 offset = 0;
+        DWORD64 size = 0;
+        const std::pmr::string* typeKey = nullptr;
+        DWORD nestedId = 0;
+        bool isBitField = false;
+        DWORD bitPosition = 0;
+    };
+
+    struct LayoutNode {
+        explicit LayoutNode(std::pmr::memory_resource* resource) : name(resource), fields(resource) {}
+
+        std::pmr::string name;
+        DWORD64 size = 0;
+        std::pmr::vector<LayoutField> fields;
+        int level = -1;
+        LayoutHash hash;
+    };
+}
+
+std::string LayoutHash::ToString() const {
+    char buffer[33];
+    snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+        static_cast<unsigned long long>(high), static_cast<unsigned long long>(low));
+    return buffer;
+}
+
+const std::unordered_map<std::string, LayoutHash>& PdbParser::ComputeLayoutHashes() const {
+    if (m_layoutHashesComputed) {
+        return m_layoutHashCache;
+    }
+
+    size_t snapshotHashCount = 0;
+    if (m_snapshot) {
+        m_snapshot->GetTable<SnapshotLayoutHash>(SnapshotTable::LayoutHashes, snapshotHashCount);
+    }
+
+    if (snapshotHashCount > 0) {
+        const SnapshotLayoutHash* hashes = m_snapshot->GetTable<SnapshotLayoutHash>(SnapshotTable::LayoutHashes, snapshotHashCount);
+        for (size_t i = 0; i < snapshotHashCount; ++i) {
+            m_layoutHashCache.emplace(std::string(m_snapshot->GetString(hashes[i].name)),
+                LayoutHash{ hashes[i].high, hashes[i].low });
+        }
+        m_layoutHashesComputed = true;
+        return m_layoutHashCache;
+    }
+
+    TraceScope trace(TracePhase::LayoutHashes);
+
+    ParseArena arena;
+    std::pmr::memory_resource* resource = arena.GetResource();
+    std::pmr::unordered_map<DWORD, LayoutNode> nodes(resource);
+    std::pmr::unordered_map<DWORD, std::pair<std::pmr::string, DWORD>> typeKeys(resource);
+    std::vector<const LayoutNode*> enumerationOrder;
+
+    auto resolveType = [&](DWORD typeId) -> const std::pair<std::pmr::string, DWORD>& {
+        auto it = typeKeys.find(typeId);
+        if (it != typeKeys.end()) return it->second;
+
+        std::pmr::string key(resource);
+        DWORD nestedId = 0;
+
+        CComPtr<IDiaSymbol> pType;
+        if (SUCCEEDED(m_pSession->symbolById(typeId, &pType)) && pType) {
+            DWORD symTag = 0;
+            pType->get_symTag(&symTag);
+
+            while (symTag == SymTagArrayType) {
+                DWORD count = 0;
+                pType->get_count(&count);
+                key += "[";
+                key += std::to_string(count);
+                key += "]";
+
+                CComPtr<IDiaSymbol> pElement;
+                if (FAILED(pType->get_type(&pElement)) || !pElement) break;
+                pType = pElement;
+                pType->get_symTag(&symTag);
+            }
+
+            key += "tag";
+            key += std::to_string(symTag);
+
+            if (symTag == SymTagBaseType) {
+                DWORD baseType = 0;
+                pType->get_baseType(&baseType);
+                key += ":";
+                key += std::to_string(baseType);
+            }
+            else if (symTag == SymTagUDT || symTag == SymTagEnum) {
+                CComBSTR bstrName;
+                if (SUCCEEDED(pType->get_name(&bstrName)) && bstrName) {
+                    key += ":";
+                    key += WStringToString(bstrName.m_str, bstrName.Length(), resource);
+                }
+                if (symTag == SymTagUDT) {
+                    pType->get_symIndexId(&nestedId);
+                }
+            }
+        }
+
+        return typeKeys.emplace(typeId, std::make_pair(std::move(key), nestedId)).first->second;
+    };
+
+    auto decodeNode = [&](IDiaSymbol* pSymbol, LayoutNode& node) -> bool {
+        CComBSTR bstrName;
+        if (FAILED(pSymbol->get_name(&bstrName)) || !bstrName || bstrName.Length() == 0) {
+            return false;
+        }
+
+        node.name = WStringToString(bstrName.m_str, bstrName.Length(), resource);
+
+        ULONGLONG structSize = 0;
+        if (SUCCEEDED(pSymbol->get_length(&structSize))) {
+            node.size = static_cast<DWORD64>(structSize);
+        }
+
+        CComPtr<IDiaEnumSymbols> pEnumMembers;
+        if (FAILED(pSymbol->findChildren(SymTagData, nullptr, nsNone, &pEnumMembers))) {
+            return true;
+        }
 
-    return ParseStructInternal(structName);
-}
+        LONG memberCount = 0;
+        if (SUCCEEDED(pEnumMembers->get_Count(&memberCount)) && memberCount > 0) {
+            node.fields.reserve(static_cast<size_t>(memberCount));
+        }
 
-std::optional<StructInfo> PdbParser::ParseStructInternal(const std::wstring& structName) const {
-    StructInfo structInfo;
-    bool found = false;
+        CComPtr<IDiaSymbol> pMember;
+        ULONG celt = 0;
 
-    EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
-        try {
-            CComBSTR bstrName;
-            if (SUCCEEDED(pSymbol->get_name(&bstrName)) &&
-                bstrName && bstrName.Length() > 0) {
+        while (SUCCEEDED(pEnumMembers->Next(1, &pMember, &celt)) && celt == 1) {
+            CComBSTR memberName;
+            LONG offset = 0;
+            ULONGLONG memberSize = 0;
+            DWORD typeId = 0;
+            DWORD dataKind = 0;
+            DWORD locationType = LocIsNull;
+            pMember->get_name(&memberName);
+            bool isBitField = SUCCEEDED(pMember->get_locationType(&locationType)) && locationType == LocIsBitField;
+
+            // Unnamed bitfields are padding that still moves the named ones, so only they may lack a name.
+            if (!(SUCCEEDED(pMember->get_dataKind(&dataKind)) && dataKind == DataIsStaticMember) &&
+                (isBitField || (memberName && memberName.Length() > 0)) &&
+                SUCCEEDED(pMember->get_offset(&offset)) &&
+                SUCCEEDED(pMember->get_length(&memberSize)) &&
+                SUCCEEDED(pMember->get_typeId(&typeId))) {
+
+                const auto& type = resolveType(typeId);
+                LayoutField field{
+                    memberName ? WStringToString(memberName.m_str, memberName.Length(), resource) : std::pmr::string(resource),
+                    static_cast<DWORD64>(offset >= 0 ? offset : 0),
+                    static_cast<DWORD64>(memberSize),
+                    &type.first,
+                    type.second,
+                    isBitField,
+                    0
+                };
+                if (isBitField) pMember->get_bitPosition(&field.bitPosition);
+                node.fields.push_back(std::move(field));
+            }
 
-                if (wcscmp(structName.c_str(), bstrName.m_str) == 0) {
-                    std::wstring wStructName(bstrName.m_str, bstrName.Length());
-                    structInfo.name = WStringToString(wStructName);
+            pMember.Release();
+        }
 
-                    ULONGLONG structSize = 0;
-                    if (SUCCEEDED(pSymbol->get_length(&structSize))) {
-                        structInfo.size = static_cast<DWORD64>(structSize);
-                    }
+        std::stable_sort(node.fields.begin(), node.fields.end(), [](const LayoutField& a, const LayoutField& b) {
+            return a.offset != b.offset ? a.offset < b.offset : a.bitPosition < b.bitPosition;
+            });
 
-                    CComPtr<IDiaEnumSymbols> pEnumMembers;
-                    if (SUCCEEDED(pSymbol->findChildren(SymTagData, nullptr, nsNone, &pEnumMembers))) {
-                        CComPtr<IDiaSymbol> pMember;
-                        ULONG celt = 0;
-
-                        while (SUCCEEDED(pEnumMembers->Next(1, &pMember, &celt)) &&
-                            celt == 1 && structInfo.members.size() < 100) {
-
-                            try {
-                                CComBSTR memberName;
-                                LONG offset = 0;
-                                ULONGLONG memberSize = 0;
-                                DWORD typeId = 0;
-
-                                if (SUCCEEDED(pMember->get_name(&memberName)) &&
-                                    memberName && memberName.Length() > 0 &&
-                                    SUCCEEDED(pMember->get_offset(&offset)) &&
-                                    SUCCEEDED(pMember->get_length(&memberSize)) &&
-                                    SUCCEEDED(pMember->get_typeId(&typeId))) {
-
-                                    std::wstring wMemberName(memberName.m_str, memberName.Length());
-                                    std::string safeMemberName = WStringToString(wMemberName);
-
-                                    if (!safeMemberName.empty()) {
-                                        structInfo.members.emplace_back(StructMember{
-                                            std::move(safeMemberName),
-                                            static_cast<DWORD64>(offset >= 0 ? offset : 0),
-                                            static_cast<DWORD64>(memberSize),
-                                            typeId
-                                            });
-                                    }
-                                }
-                            }
-                            catch (...) {
-                            }
-
-                            pMember.Release();
-                        }
-                    }
+        return true;
+    };
 
-                    found = true;
-                    return false;
+    EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        try {
+            DWORD symIndexId = 0;
+            if (SUCCEEDED(pSymbol->get_symIndexId(&symIndexId))) {
+                auto [it, inserted] = nodes.emplace(std::piecewise_construct,
+                    std::forward_as_tuple(symIndexId), std::forward_as_tuple(resource));
+
+                if (inserted) {
+                    if (decodeNode(pSymbol, it->second)) enumerationOrder.push_back(&it->second);
+                    else nodes.erase(it);
                 }
             }
         }
@@ -291,97 +2413,143 @@ std::optional<StructInfo> PdbParser::ParseStructInternal(const std::wstring& str
         return true;
         });
 
-    if (found) {
-        std::sort(structInfo.members.begin(), structInfo.members.end(),
-            [](const StructMember& a, const StructMember& b) { return a.offset < b.offset; });
+    std::function<int(LayoutNode&)> computeLevel = [&](LayoutNode& node) -> int {
+        if (node.level >= 0) return node.level;
 
-        m_structCache[structName] = structInfo;
-        return structInfo;
+        node.level = 0;
+        int level = 0;
+        for (const auto& field : node.fields) {
+            auto it = field.nestedId ? nodes.find(field.nestedId) : nodes.end();
+            if (it != nodes.end() && &it->second != &node) {
+                level = (std::max)(level, computeLevel(it->second) + 1);
+            }
+        }
+        node.level = level;
+        return level;
+    };
+
+    std::vector<std::vector<LayoutNode*>> levels;
+    for (auto& [id, node] : nodes) {
+        int level = computeLevel(node);
+        if (levels.size() <= static_cast<size_t>(level)) {
+            levels.resize(level + 1);
+        }
+        levels[level].push_back(&node);
     }
 
-    return std::nullopt;
-}
-
-std::optional<DWORD64> PdbParser::GetStructMemberOffset(const std::wstring& structName,
-    const std::wstring& memberName) const {
-    auto structInfo = GetStructInfo(structName);
-    if (!structInfo) return std::nullopt;
-
-    std::string memberNameStr = WStringToString(memberName);
-    auto it = std::find_if(structInfo->members.begin(), structInfo->members.end(),
-        [&](const StructMember& member) { return member.name == memberNameStr; });
+    for (auto& level : levels) {
+        RunParallel(level.size(), 0, [&](size_t i) {
+            LayoutNode& node = *level[i];
+            LayoutHasher hasher;
+            hasher.Update(node.name);
+            hasher.Update(node.size);
+            hasher.Update(static_cast<uint64_t>(node.fields.size()));
+
+            for (const auto& field : node.fields) {
+                hasher.Update(field.name);
+                hasher.Update(field.offset);
+                hasher.Update(field.size);
+                if (field.isBitField) hasher.Update(static_cast<uint64_t>(field.bitPosition));
+                hasher.Update(*field.typeKey);
+
+                auto it = field.nestedId ? nodes.find(field.nestedId) : nodes.end();
+                if (it != nodes.end() && &it->second != &node) {
+                    hasher.Update(it->second.hash);
+                }
+            }
 
-    return (it != structInfo->members.end()) ? std::optional<DWORD64>(it->offset) : std::nullopt;
-}
+            node.hash = hasher.Finish();
+            });
+    }
 
-void PdbParser::PreloadSymbols() {
-    auto symbols = GetAllPublicSymbols();
-    for (const auto& symbol : symbols) {
-        std::wstring wname = std::wstring(symbol.name.begin(), symbol.name.end());
-        m_symbolCache[wname] = symbol.rva;
+    // A name can have several UDT records: one per compiland, or a forward reference beside the
+    // definition. The first record with a size, in DIA's enumeration order (which follows the TPI
+    // stream), gives the name its hash, so the result does not depend on the order of nodes.
+    for (const LayoutNode* node : enumerationOrder) {
+        if (node->size > 0) m_layoutHashCache.emplace(std::string(node->name), node->hash);
     }
+    for (const LayoutNode* node : enumerationOrder) {
+        m_layoutHashCache.emplace(std::string(node->name), node->hash);
+    }
+
+    Tracer::Count(TraceCounter::ArenaBytesReserved, arena.GetBytesReserved());
+    m_layoutHashesComputed = true;
+    return m_layoutHashCache;
 }
 
-void PdbParser::PreloadStructures() {
-    std::vector<std::wstring> structNames = GetAllStructNames();
-    for (const auto& name : structNames) {
-        ParseStructInternal(name);
+std::optional<LayoutHash> PdbParser::GetLayoutHash(const std::wstring& structName) const {
+    if (m_snapshot && !m_layoutHashesComputed) {
+        if (const SnapshotLayoutHash* hash = m_snapshot->FindLayoutHash(WStringToString(structName))) {
+            return LayoutHash{ hash->high, hash->low };
+        }
     }
-}
 
-void PdbParser::ClearCaches() noexcept {
-    m_symbolCache.clear();
-    m_structCache.clear();
+    const auto& hashes = ComputeLayoutHashes();
+    auto it = hashes.find(WStringToString(structName));
+    if (it == hashes.end()) return std::nullopt;
+    return it->second;
 }
 
-std::vector<std::wstring> PdbParser::GetAllStructNames() const {
-    std::vector<std::wstring> names;
-    names.reserve(500);
-
-    EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
-        try {
-            CComBSTR bstrName;
-            if (SUCCEEDED(pSymbol->get_name(&bstrName)) &&
-                bstrName && bstrName.Length() > 0) {
-                names.emplace_back(std::wstring(bstrName.m_str, bstrName.Length()));
+namespace {
+    // UTF-8 bytes go to a wide stream one per character, as the JSON dump has always written them.
+    template<typename Char>
+    void WriteJsonStringTo(std::basic_ostream<Char>& out, const std::string& value) {
+        out << Char('"');
+        for (char c : value) {
+            switch (c) {
+            case '"': out << Char('\\') << Char('"'); break;
+            case '\\': out << Char('\\') << Char('\\'); break;
+            case '\n': out << Char('\\') << Char('n'); break;
+            case '\r': out << Char('\\') << Char('r'); break;
+            case '\t': out << Char('\\') << Char('t'); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    for (const char* p = escaped; *p; ++p) out << Char(*p);
+                }
+                else {
+                    out << static_cast<Char>(static_cast<unsigned char>(c));
+                }
             }
         }
-        catch (...) {
-        }
+        out << Char('"');
+    }
+}
 
-        return names.size() < 1000; // Limit
-        });
+void WriteJsonString(std::ostream& out, const std::string& value) {
+    WriteJsonStringTo(out, value);
+}
 
-    return names;
+void WriteJsonString(std::wostream& out, const std::string& value) {
+    WriteJsonStringTo(out, value);
 }
 
 bool PdbParser::DumpToJson(const std::wstring& outputPath) const {
+    TraceScope trace(TracePhase::ExportJson);
     try {
         std::wofstream file(outputPath);
         if (!file.is_open()) return false;
 
         file << L"{\n";
         file << L"  \"pdb_info\": {\n";
-        file << L"    \"path\": \"" << m_pdbPath << L"\",\n";
+        file << L"    \"path\": ";
+        WriteJsonString(file, WStringToString(m_pdbPath));
+        file << L",\n";
         file << L"    \"machine_type\": " << static_cast<DWORD>(m_machineType) << L"\n";
         file << L"  },\n";
 
         auto symbols = GetAllPublicSymbols();
+        Tracer::Count(TraceCounter::RecordsExported, symbols.size());
         file << L"  \"symbols\": [\n";
 
         for (size_t i = 0; i < symbols.size(); ++i) {
             const auto& symbol = symbols[i];
-            std::wstring wname = std::wstring(symbol.name.begin(), symbol.name.end());
-
-            std::wstring escaped_name;
-            for (wchar_t c : wname) {
-                if (c == L'"') escaped_name += L"\\\"";
-                else if (c == L'\\') escaped_name += L"\\\\";
-                else escaped_name += c;
-            }
 
             file << L"    {\n";
-            file << L"      \"name\": \"" << escaped_name << L"\",\n";
+            file << L"      \"name\": ";
+            WriteJsonString(file, symbol.name);
+            file << L",\n";
             file << L"      \"rva\": \"0x" << std::hex << symbol.rva << L"\",\n";
             file << L"      \"size\": " << std::dec << symbol.size << L",\n";
             file << L"      \"type_id\": " << symbol.typeId << L"\n";
@@ -400,17 +2568,28 @@ bool PdbParser::DumpToJson(const std::wstring& outputPath) const {
             auto structInfo = GetStructInfo(structNames[i]);
             if (!structInfo) continue;
 
+            Tracer::Count(TraceCounter::RecordsExported);
             file << L"    {\n";
-            file << L"      \"name\": \"" << structNames[i] << L"\",\n";
+            file << L"      \"name\": ";
+            WriteJsonString(file, WStringToString(structNames[i]));
+            file << L",\n";
             file << L"      \"size\": " << structInfo->size << L",\n";
+
+            auto layoutHash = GetLayoutHash(structNames[i]);
+            if (layoutHash) {
+                std::string hashText = layoutHash->ToString();
+                file << L"      \"layout_hash\": \"" << std::wstring(hashText.begin(), hashText.end()) << L"\",\n";
+            }
+
             file << L"      \"members\": [\n";
 
             for (size_t j = 0; j < structInfo->members.size(); ++j) {
                 const auto& member = structInfo->members[j];
-                std::wstring wmemberName(member.name.begin(), member.name.end());
 
                 file << L"        {\n";
-                file << L"          \"name\": \"" << wmemberName << L"\",\n";
+                file << L"          \"name\": ";
+                WriteJsonString(file, member.name);
+                file << L",\n";
                 file << L"          \"offset\": " << member.offset << L",\n";
                 file << L"          \"size\": " << member.size << L",\n";
                 file << L"          \"type_id\": " << member.typeId << L"\n";
@@ -428,9 +2607,37 @@ bool PdbParser::DumpToJson(const std::wstring& outputPath) const {
         }
 
         file << L"  ],\n";
+        file << L"  \"enums\": [\n";
+
+        size_t enumCount = 0;
+        ForEachEnum([&](const EnumInfo& enumInfo) -> bool {
+            Tracer::Count(TraceCounter::RecordsExported);
+            if (enumCount++ > 0) file << L",\n";
+
+            file << L"    {\n";
+            file << L"      \"name\": ";
+            WriteJsonString(file, enumInfo.name);
+            file << L",\n";
+            file << L"      \"size\": " << std::dec << enumInfo.size << L",\n";
+            file << L"      \"values\": [";
+
+            for (size_t j = 0; j < enumInfo.values.size(); ++j) {
+                const auto& value = enumInfo.values[j];
+                file << (j > 0 ? L", " : L"") << L"{\"name\": ";
+                WriteJsonString(file, value.name);
+                file << L", \"value\": " << value.value << L"}";
+            }
+
+            file << L"]\n";
+            file << L"    }";
+            return true;
+            });
+
+        file << L"\n  ],\n";
         file << L"  \"statistics\": {\n";
         file << L"    \"total_symbols\": " << symbols.size() << L",\n";
-        file << L"    \"total_structures\": " << structNames.size() << L"\n";
+        file << L"    \"total_structures\": " << structNames.size() << L",\n";
+        file << L"    \"total_enums\": " << enumCount << L"\n";
         file << L"  }\n";
         file << L"}\n";
 
@@ -442,6 +2649,354 @@ bool PdbParser::DumpToJson(const std::wstring& outputPath) const {
     }
 }
 
+bool PdbParser::StreamToNdjson(std::ostream& out, size_t flushInterval) const {
+    TraceScope trace(TracePhase::ExportNdjson);
+
+    size_t records = 0;
+    auto recordWritten = [&]() {
+        Tracer::Count(TraceCounter::RecordsExported);
+        if (flushInterval > 0 && ++records % flushInterval == 0) {
+            out.flush();
+        }
+    };
+
+    out << "{\"kind\":\"pdb_info\",\"path\":";
+    WriteJsonString(out, WStringToString(m_pdbPath));
+    out << ",\"machine_type\":" << static_cast<DWORD>(m_machineType) << "}\n";
+    recordWritten();
+
+    EnumerateSymbols(SymTagPublicSymbol, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        try {
+            SymbolInfo symbol;
+            if (DecodePublicSymbol(pSymbol, symbol)) {
+                out << "{\"kind\":\"symbol\",\"name\":";
+                WriteJsonString(out, symbol.name);
+                out << ",\"rva\":" << symbol.rva
+                    << ",\"size\":" << symbol.size
+                    << ",\"type_id\":" << symbol.typeId << "}\n";
+                recordWritten();
+            }
+        }
+        catch (...) {
+        }
+
+        return out.good();
+        });
+
+    EnumerateSymbols(SymTagUDT, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        try {
+            StructInfo structInfo;
+            if (DecodeStruct(pSymbol, structInfo)) {
+                out << "{\"kind\":\"struct\",\"name\":";
+                WriteJsonString(out, structInfo.name);
+                out << ",\"size\":" << structInfo.size << ",\"members\":[";
+
+                for (size_t i = 0; i < structInfo.members.size(); ++i) {
+                    const auto& member = structInfo.members[i];
+                    if (i > 0) out << ",";
+                    out << "{\"name\":";
+                    WriteJsonString(out, member.name);
+                    out << ",\"offset\":" << member.offset
+                        << ",\"size\":" << member.size
+                        << ",\"type_id\":" << member.typeId << "}";
+                }
+
+                out << "]}\n";
+                recordWritten();
+            }
+        }
+        catch (...) {
+        }
+
+        return out.good();
+        });
+
+    // Like symbols and structs, enums are decoded, written and dropped one at a time; nothing goes
+    // into m_enumCache, so memory stays flat however many enums the PDB holds.
+    EnumerateSymbols(SymTagEnum, [&](CComPtr<IDiaSymbol>& pSymbol) -> bool {
+        try {
+            EnumInfo enumInfo{};
+            if (DecodeEnum(pSymbol, enumInfo)) {
+                out << "{\"kind\":\"enum\",\"name\":";
+                WriteJsonString(out, enumInfo.name);
+                out << ",\"size\":" << enumInfo.size << ",\"values\":[";
+
+                for (size_t i = 0; i < enumInfo.values.size(); ++i) {
+                    if (i > 0) out << ",";
+                    out << "{\"name\":";
+                    WriteJsonString(out, enumInfo.values[i].name);
+                    out << ",\"value\":" << enumInfo.values[i].value << "}";
+                }
+
+                out << "]}\n";
+                recordWritten();
+            }
+        }
+        catch (...) {
+        }
+
+        return out.good();
+        });
+
+    out.flush();
+    return out.good();
+}
+
+// Every "-" export goes through here: text-mode stdout would turn each \n into \r\n and make the
+// output differ from the same export written to a file.
+static std::ostream& BinaryStdout() {
+    std::cout.flush();
+    _setmode(_fileno(stdout), _O_BINARY);
+    return std::cout;
+}
+
+bool PdbParser::ExportNdjson(const std::wstring& outputPath, size_t flushInterval) const {
+    try {
+        if (outputPath == L"-") {
+            return StreamToNdjson(BinaryStdout(), flushInterval);
+        }
+
+        std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        return StreamToNdjson(file, flushInterval);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+namespace {
+    void WriteFunctionVariables(std::ostream& out, const std::vector<FunctionVariable>& variables) {
+        out << "[";
+        for (size_t i = 0; i < variables.size(); ++i) {
+            const auto& variable = variables[i];
+            if (i > 0) out << ",";
+            out << "{\"name\":";
+            WriteJsonString(out, variable.name);
+            out << ",\"type\":";
+            WriteJsonString(out, variable.typeName);
+            out << ",\"size\":" << variable.size
+                << ",\"location\":" << variable.locationType
+                << ",\"register\":" << variable.registerId
+                << ",\"offset\":" << variable.offset << "}";
+        }
+        out << "]";
+    }
+}
+
+bool PdbParser::ExportFunctions(const std::wstring& outputPath, size_t maxThreads) const {
+    try {
+        auto functions = DecodeAllFunctions(m_pdbPath, maxThreads);
+
+        std::ofstream file;
+        if (outputPath != L"-") {
+            file.open(outputPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+        }
+        std::ostream& out = outputPath == L"-" ? BinaryStdout() : file;
+
+        for (const auto& function : functions) {
+            const auto& frame = function.frame;
+
+            out << "{\"kind\":\"function\",\"name\":";
+            WriteJsonString(out, function.name);
+            out << ",\"rva\":" << function.rva
+                << ",\"length\":" << function.length
+                << ",\"calling_convention\":\"" << function.callingConvention << "\""
+                << ",\"return_type\":";
+            WriteJsonString(out, function.returnType);
+            out << ",\"parameters\":";
+            WriteFunctionVariables(out, function.parameters);
+            out << ",\"locals\":";
+            WriteFunctionVariables(out, function.locals);
+            out << ",\"frame\":{\"frame_size\":" << frame.frameSize
+                << ",\"frame_pointer\":" << (frame.framePointerPresent ? "true" : "false")
+                << ",\"alloca\":" << (frame.hasAlloca ? "true" : "false")
+                << ",\"seh\":" << (frame.hasSEH ? "true" : "false")
+                << ",\"eh\":" << (frame.hasEH ? "true" : "false")
+                << ",\"local_base_register\":" << frame.localBaseRegister
+                << ",\"param_base_register\":" << frame.paramBaseRegister;
+            if (frame.hasFrameData) {
+                out << ",\"locals_length\":" << frame.lengthLocals
+                    << ",\"params_length\":" << frame.lengthParams
+                    << ",\"saved_registers_length\":" << frame.lengthSavedRegisters
+                    << ",\"prolog_length\":" << frame.lengthProlog
+                    << ",\"max_stack\":" << frame.maxStack;
+            }
+            out << "}}\n";
+            Tracer::Count(TraceCounter::RecordsExported);
+        }
+
+        out.flush();
+        return out.good();
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+std::optional<PdbIdentity> PdbParser::GetIdentity() const {
+    GUID guid{};
+    DWORD age = 0;
+    if (!EnsureDia() || FAILED(m_pGlobalScope->get_guid(&guid)) || FAILED(m_pGlobalScope->get_age(&age))) {
+        return std::nullopt;
+    }
+
+    PdbIdentity identity;
+    identity.pdbName = WStringToString(std::filesystem::path(m_pdbPath).filename().wstring());
+    identity.guidAge = FormatGuidAge(guid, age);
+    return identity;
+}
+
+std::optional<DWORD64> PdbParser::GetImageSize() const {
+    const SymbolStreams* streams = GetSymbolStreams();
+    if (!streams || streams->GetImageSize() == 0) return std::nullopt;
+    return streams->GetImageSize();
+}
+
+namespace {
+    const char* BreakpadArchitecture(MachineType machineType) {
+        switch (machineType) {
+        case MachineType::x86: return "x86";
+        case MachineType::x64: return "x86_64";
+        case MachineType::ARM: return "arm";
+        case MachineType::ARM64: return "arm64";
+        case MachineType::IA64: return "ia64";
+        default: return "unknown";
+        }
+    }
+}
+
+// Breakpad text format: MODULE, then every source file as FILE, then FUNC records with their line
+// records and PUBLIC records in address order. Records go straight to the stream as DIA yields them.
+bool PdbParser::StreamToBreakpad(std::ostream& out) const {
+    TraceScope trace(TracePhase::ExportSymbolFile);
+
+    auto identity = GetIdentity();
+    if (!identity) return false;
+
+    out << "MODULE windows " << BreakpadArchitecture(m_machineType) << " " << identity->guidAge
+        << " " << identity->pdbName << "\n";
+
+    CComPtr<IDiaEnumSourceFiles> pFiles;
+    if (SUCCEEDED(m_pSession->findFile(nullptr, nullptr, nsNone, &pFiles))) {
+        std::unordered_set<DWORD> written;
+        CComPtr<IDiaSourceFile> pFile;
+        ULONG celt = 0;
+
+        while (SUCCEEDED(pFiles->Next(1, &pFile, &celt)) && celt == 1) {
+            DWORD fileId = 0;
+            CComBSTR bstrName;
+            if (SUCCEEDED(pFile->get_uniqueId(&fileId)) && SUCCEEDED(pFile->get_fileName(&bstrName)) &&
+                bstrName && written.insert(fileId).second) {
+                out << "FILE " << fileId << " " << WStringToString(bstrName.m_str, bstrName.Length()) << "\n";
+                Tracer::Count(TraceCounter::RecordsExported);
+            }
+            pFile.Release();
+        }
+    }
+
+    bool walked = ForEachAddressRange([&](const AddressRange& range) -> bool {
+        if (!range.isFunction) {
+            out << "PUBLIC " << std::hex << range.rva << " " << range.parameterSize << std::dec
+                << " " << range.name << "\n";
+            Tracer::Count(TraceCounter::RecordsExported);
+            return out.good();
+        }
+
+        out << "FUNC " << std::hex << range.rva << " " << range.length << " " << range.parameterSize << std::dec
+            << " " << range.name << "\n";
+        Tracer::Count(TraceCounter::RecordsExported);
+
+        CComPtr<IDiaEnumLineNumbers> pLines;
+        if (range.length > 0 && SUCCEEDED(m_pSession->findLinesByRVA(range.rva, range.length, &pLines))) {
+            CComPtr<IDiaLineNumber> pLine;
+            ULONG celt = 0;
+
+            while (SUCCEEDED(pLines->Next(1, &pLine, &celt)) && celt == 1) {
+                DWORD lineRva = 0, lineLength = 0, lineNumber = 0, fileId = 0;
+                if (SUCCEEDED(pLine->get_relativeVirtualAddress(&lineRva)) && SUCCEEDED(pLine->get_length(&lineLength)) &&
+                    SUCCEEDED(pLine->get_lineNumber(&lineNumber)) && SUCCEEDED(pLine->get_sourceFileId(&fileId)) &&
+                    lineLength > 0) {
+                    out << std::hex << lineRva << " " << lineLength << std::dec << " " << lineNumber << " " << fileId << "\n";
+                }
+                pLine.Release();
+            }
+        }
+
+        return out.good();
+        });
+
+    out.flush();
+    return walked && out.good();
+}
+
+bool PdbParser::ExportBreakpad(const std::wstring& outputPath) const {
+    try {
+        if (outputPath == L"-") {
+            return StreamToBreakpad(BinaryStdout());
+        }
+
+        std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        return StreamToBreakpad(file);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+// perf map format: "<start> <size> <name>" in hex, one line per range with a known size, addresses
+// relative to the image base the module was loaded at.
+bool PdbParser::StreamToPerfMap(std::ostream& out, DWORD64 imageBase) const {
+    TraceScope trace(TracePhase::ExportSymbolFile);
+
+    bool walked = ForEachAddressRange([&](const AddressRange& range) -> bool {
+        if (range.length == 0) return true;
+
+        out << std::hex << imageBase + range.rva << " " << range.length << std::dec << " " << range.name << "\n";
+        Tracer::Count(TraceCounter::RecordsExported);
+        return out.good();
+        });
+
+    out.flush();
+    return walked && out.good();
+}
+
+bool PdbParser::ExportPerfMap(const std::wstring& outputPath, DWORD64 imageBase) const {
+    try {
+        if (outputPath == L"-") {
+            return StreamToPerfMap(BinaryStdout(), imageBase);
+        }
+
+        std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        return StreamToPerfMap(file, imageBase);
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+// Functions and publics sorted by RVA, built once, for address-to-symbol lookups in bulk.
+const std::vector<SymbolInfo>& PdbParser::GetAddressTable() const {
+    if (m_addressTableLoaded) {
+        return m_addressTable;
+    }
+    m_addressTableLoaded = true;
+
+    ForEachAddressRange([&](const AddressRange& range) -> bool {
+        m_addressTable.push_back({ range.name, range.rva, range.length, 0 });
+        return true;
+        });
+
+    m_addressTable.shrink_to_fit();
+    return m_addressTable;
+}
+
 std::vector<SymbolDiff> PdbComparer::ComparePdbs(const PdbParser& oldPdb, const PdbParser& newPdb) {
     std::vector<SymbolDiff> diffs;
 
@@ -480,6 +3035,34 @@ std::vector<SymbolDiff> PdbComparer::ComparePdbs(const PdbParser& oldPdb, const
     return diffs;
 }
 
+std::vector<LayoutDiff> PdbComparer::CompareLayouts(const PdbParser& oldPdb, const PdbParser& newPdb) {
+    std::vector<LayoutDiff> diffs;
+
+    const auto& oldHashes = oldPdb.ComputeLayoutHashes();
+    const auto& newHashes = newPdb.ComputeLayoutHashes();
+
+    for (const auto& [name, hash] : oldHashes) {
+        if (newHashes.find(name) == newHashes.end()) {
+            diffs.push_back({ name, hash, {}, false, true, false });
+        }
+    }
+
+    for (const auto& [name, newHash] : newHashes) {
+        auto oldIt = oldHashes.find(name);
+        if (oldIt == oldHashes.end()) {
+            diffs.push_back({ name, {}, newHash, true, false, false });
+        }
+        else if (oldIt->second != newHash) {
+            diffs.push_back({ name, oldIt->second, newHash, false, false, true });
+        }
+    }
+
+    std::sort(diffs.begin(), diffs.end(),
+        [](const LayoutDiff& a, const LayoutDiff& b) { return a.name < b.name; });
+
+    return diffs;
+}
+
 void PdbComparer::PrintDifferences(const std::vector<SymbolDiff>& diffs) {
     std::cout << "\nPDB Comparison Results:\n";
     std::cout << std::string(60, '=') << "\n";
@@ -506,6 +3089,32 @@ void PdbComparer::PrintDifferences(const std::vector<SymbolDiff>& diffs) {
         << removed << " removed, " << changed << " changed\n";
 }
 
+void PdbComparer::PrintLayoutDifferences(const std::vector<LayoutDiff>& diffs) {
+    std::cout << "\nLayout Comparison Results:\n";
+    std::cout << std::string(60, '=') << "\n";
+
+    int added = 0, removed = 0, changed = 0;
+
+    for (const auto& diff : diffs) {
+        if (diff.added) {
+            std::cout << "[+] ADDED: " << diff.name << " " << diff.newHash.ToString() << "\n";
+            added++;
+        }
+        else if (diff.removed) {
+            std::cout << "[-] REMOVED: " << diff.name << " (was " << diff.oldHash.ToString() << ")\n";
+            removed++;
+        }
+        else if (diff.changed) {
+            std::cout << "[~] CHANGED: " << diff.name << " " << diff.oldHash.ToString()
+                << " -> " << diff.newHash.ToString() << "\n";
+            changed++;
+        }
+    }
+
+    std::cout << "\nSummary: " << added << " added, "
+        << removed << " removed, " << changed << " changed layouts\n";
+}
+
 bool PdbComparer::ExportDifferencesToJson(const std::vector<SymbolDiff>& diffs, const std::wstring& outputPath) {
     try {
         std::wofstream file(outputPath);
@@ -559,28 +3168,34 @@ void BatchProcessor::ProcessMultiplePdbs(const std::vector<std::wstring>& pdbFil
     std::filesystem::create_directories(outputDir);
 
     for (const auto& pdbFile : pdbFiles) {
-        try {
-            std::wcout << L"Processing: " << pdbFile << L"\n";
+        ProcessPdb(pdbFile, outputDir);
+    }
+}
 
-            PdbParser parser(pdbFile);
-            if (!parser.IsInitialized()) {
-                std::wcout << L"Failed to initialize: " << pdbFile << L"\n";
-                continue;
-            }
+bool BatchProcessor::ProcessPdb(const std::wstring& pdbFile, const std::wstring& outputDir) {
+    try {
+        std::wcout << L"Processing: " << pdbFile << L"\n";
 
-            auto filename = std::filesystem::path(pdbFile).stem().wstring();
-            auto outputFile = outputDir + L"\\" + filename + L"_analysis.json";
+        PdbParser parser(pdbFile);
+        if (!parser.IsInitialized()) {
+            std::wcout << L"Failed to initialize: " << pdbFile << L"\n";
+            return false;
+        }
 
-            if (parser.DumpToJson(outputFile)) {
-                std::wcout << L"Exported: " << outputFile << L"\n";
-            }
+        auto filename = std::filesystem::path(pdbFile).stem().wstring();
+        auto outputFile = outputDir + L"\\" + filename + L"_analysis.json";
 
+        if (parser.DumpToJson(outputFile)) {
+            std::wcout << L"Exported: " << outputFile << L"\n";
+            return true;
         }
-        catch (const std::exception& e) {
-            std::cerr << "Error processing " << std::string(pdbFile.begin(), pdbFile.end())
-                << ": " << e.what() << std::endl;
-        }
     }
+    catch (const std::exception& e) {
+        std::cerr << "Error processing " << std::string(pdbFile.begin(), pdbFile.end())
+            << ": " << e.what() << std::endl;
+    }
+
+    return false;
 }
 
 void BatchProcessor::GenerateSummaryReport(const std::vector<std::wstring>& pdbFiles, const std::wstring& outputPath) {
@@ -2,15 +2,30 @@
 #include <combaseapi.h>
 #include <atlcomcli.h>
 #include <string>
+#include <string_view>
+#include <memory_resource>
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <memory>
 #include <optional>
 #include <functional>
+#include <ostream>
 #include "dia2.h"
+#include "SymbolStreams.h"
+#include "TypeStream.h"
+#include "Snapshot.h"
+#include "ClassHierarchy.h"
 
 #define INVALID_OFFSET static_cast<DWORD64>(-1)
 
+std::string WStringToString(const std::wstring& wstr);
+std::string WStringToString(const wchar_t* data, size_t length);
+std::pmr::string WStringToString(const wchar_t* data, size_t length, std::pmr::memory_resource* resource);
+void WriteJsonString(std::ostream& out, const std::string& value);
+void WriteJsonString(std::wostream& out, const std::string& value);
+std::string FormatGuidAge(const GUID& guid, DWORD age);
+
 struct SymbolInfo {
     std::string name;
     DWORD64 rva;
@@ -18,17 +33,174 @@ struct SymbolInfo {
     DWORD typeId;
 };
 
+// Bitfield members report size in bits. typeName is the UDT the member is, holds (arrays) or points
+// to, and is empty for base types; elementSize/elementCount describe the outermost array dimension.
 struct StructMember {
     std::string name;
     DWORD64 offset;
     DWORD64 size;
     DWORD typeId;
+    std::string typeName;
+    DWORD64 elementSize = 0;
+    DWORD elementCount = 0;
+    DWORD bitPosition = 0;
+    DWORD bitLength = 0;
+    bool isPointer = false;
 };
 
+// memberSlots is an open-addressed hash over member names (index + 1, 0 = empty), built once when
+// the struct is cached; it must be rebuilt after members change.
 struct StructInfo {
     std::string name;
     DWORD64 size;
     std::vector<StructMember> members;
+    std::vector<uint32_t> memberSlots;
+    bool isUnion = false;
+
+    void BuildMemberIndex();
+    const StructMember* FindMember(std::string_view memberName) const noexcept;
+};
+
+// A field access path ("_EPROCESS.Pcb.DirectoryTableBase", "_KPRCB.WaitListHead.Flink->Blink",
+// "_PEB.Ldr->InLoadOrderModuleList") compiled to flat offsets. offsets[0] is relative to the root
+// struct and every further entry applies after reading the pointer at the previous address, so a path
+// without "->" is a single constant offset.
+struct FieldPath {
+    std::string rootType;
+    std::vector<DWORD64> offsets;
+    DWORD64 size = 0;
+    DWORD bitPosition = 0;
+    DWORD bitLength = 0;
+    DWORD pointerSize = 0;
+    std::string typeName;
+
+    using PointerReader = std::function<bool(DWORD64 address, DWORD64& value)>;
+
+    bool IsDirect() const noexcept { return offsets.size() == 1; }
+    bool IsBitfield() const noexcept { return bitLength != 0; }
+    uint64_t ExtractBits(uint64_t raw) const noexcept;
+
+    std::optional<DWORD64> Resolve(DWORD64 base, const PointerReader& readPointer = {}) const;
+    void ResolveBatch(const std::vector<DWORD64>& bases, std::vector<DWORD64>& addresses,
+        const PointerReader& readPointer = {}) const;
+};
+
+// A span of a UDT no member covers, in bits from the start of the UDT. after names the member whose
+// storage ends where the gap begins.
+struct LayoutGap {
+    std::string after;
+    DWORD64 bitOffset;
+    DWORD64 bitSize;
+};
+
+struct LayoutStraddler {
+    std::string member;
+    DWORD64 offset;
+    DWORD64 size;
+};
+
+// pahole-style efficiency figures for one UDT. Coverage is tracked in bits and overlapping members
+// are merged, so union arms and bitfields sharing a storage unit are not reported as holes. Space
+// before the first data member belongs to base classes or the vtable pointer and is not counted.
+struct StructLayoutReport {
+    std::string name;
+    DWORD64 size = 0;
+    bool isUnion = false;
+    size_t memberCount = 0;
+    std::vector<LayoutGap> holes;
+    DWORD64 holeBytes = 0;
+    DWORD64 bitHoleBits = 0;
+    DWORD64 tailPadding = 0;
+    DWORD64 wastedBytes = 0;
+    DWORD64 cacheLines = 0;
+    DWORD64 packedCacheLines = 0;
+    std::vector<LayoutStraddler> straddlers;
+
+    static StructLayoutReport Analyze(const StructInfo& structInfo, DWORD64 cacheLineSize = 64);
+};
+
+struct EnumValue {
+    std::string name;
+    int64_t value;
+};
+
+struct EnumInfo {
+    std::string name;
+    DWORD64 size;
+    std::vector<EnumValue> values;
+    std::vector<uint32_t> sortedByValue;
+
+    const EnumValue* FindByValue(int64_t value) const;
+    std::vector<const EnumValue*> DecomposeFlags(uint64_t value, uint64_t& remainder) const;
+};
+
+struct FunctionVariable {
+    std::string name;
+    std::string typeName;
+    DWORD64 size;
+    DWORD locationType;
+    DWORD registerId;
+    LONG offset;
+};
+
+struct FunctionFrame {
+    DWORD frameSize;
+    bool framePointerPresent;
+    bool hasAlloca;
+    bool hasSEH;
+    bool hasEH;
+    DWORD localBaseRegister;
+    DWORD paramBaseRegister;
+    bool hasFrameData;
+    DWORD lengthLocals;
+    DWORD lengthParams;
+    DWORD lengthSavedRegisters;
+    DWORD lengthProlog;
+    DWORD maxStack;
+};
+
+struct FunctionInfo {
+    std::string name;
+    DWORD64 rva;
+    DWORD64 length;
+    std::string callingConvention;
+    std::string returnType;
+    std::vector<FunctionVariable> parameters;
+    std::vector<FunctionVariable> locals;
+    FunctionFrame frame;
+};
+
+struct GlobalSymbolInfo {
+    std::string name;
+    std::string typeName;
+    DWORD64 rva;
+    DWORD64 size;
+    DWORD typeId;
+    WORD section;
+    DWORD offset;
+    bool isStatic;
+    bool isThreadLocal;
+};
+
+// Public-symbol queries answered together: exact names go through the cache, snapshot and publics
+// hash first, and the names they miss share one DIA pass over the publics with every pattern. rvas
+// and matches are filled in the order of names and patterns; a pattern that is not a valid regex
+// matches nothing.
+struct PublicsQuery {
+    std::vector<std::wstring> names;
+    std::vector<std::wstring> patterns;
+    size_t maxMatches = 200;
+    std::vector<std::optional<DWORD64>> rvas;
+    std::vector<std::vector<SymbolInfo>> matches;
+};
+
+struct LayoutHash {
+    uint64_t high = 0;
+    uint64_t low = 0;
+
+    bool operator==(const LayoutHash& other) const noexcept { return high == other.high && low == other.low; }
+    bool operator!=(const LayoutHash& other) const noexcept { return !(*this == other); }
+    std::string ToString() const;
 };
 
 enum class MachineType : DWORD {
@@ -39,26 +211,101 @@ enum class MachineType : DWORD {
     ARM64 = IMAGE_FILE_MACHINE_ARM64
 };
 
+// The CodeView (RSDS) record of an image: the PDB file name and the GUID+age key the symbol server
+// files it under.
+struct PdbIdentity {
+    std::string pdbName;
+    std::string guidAge;
+};
+
+// Full brings DIA up in the constructor. PublicsOnly and TypesOnly open only what that mode answers
+// from natively (the publics hash and section headers, or the TPI stream) and defer DIA until a query
+// needs it, so resolving a handful of names or structs never pays for a DIA session.
+enum class OpenMode {
+    Full,
+    PublicsOnly,
+    TypesOnly
+};
+
 class PdbParser {
 private:
-    CComPtr<IDiaDataSource> m_pDataSource;
-    CComPtr<IDiaSession> m_pSession;
-    CComPtr<IDiaSymbol> m_pGlobalScope;
+    mutable CComPtr<IDiaDataSource> m_pDataSource;
+    mutable CComPtr<IDiaSession> m_pSession;
+    mutable CComPtr<IDiaSymbol> m_pGlobalScope;
+    mutable bool m_diaLoaded = false;
     MachineType m_machineType;
+    OpenMode m_openMode;
     std::wstring m_pdbPath;
 
     mutable std::unordered_map<std::wstring, DWORD64> m_symbolCache;
     mutable std::unordered_map<std::wstring, StructInfo> m_structCache;
+    mutable std::unordered_map<std::wstring, EnumInfo> m_enumCache;
+    mutable std::unordered_map<std::wstring, FunctionInfo> m_functionCache;
+    mutable CComPtr<IDiaEnumFrameData> m_pFrameData;
+    mutable bool m_frameDataLoaded = false;
+    mutable std::unordered_map<std::string, LayoutHash> m_layoutHashCache;
+    mutable bool m_layoutHashesComputed = false;
+    mutable std::vector<SymbolInfo> m_addressTable;
+    mutable bool m_addressTableLoaded = false;
 
-    bool InitializeDia() noexcept;
+    struct GlobalTypeInfo {
+        std::string name;
+        DWORD64 size = 0;
+        DWORD typeId = 0;
+    };
+
+    mutable std::shared_ptr<const MsfReader> m_msf;
+    mutable bool m_msfLoaded = false;
+    mutable std::unique_ptr<SymbolStreams> m_symbolStreams;
+    mutable bool m_symbolStreamsLoaded = false;
+    mutable std::unique_ptr<TypeStream> m_typeStream;
+    mutable bool m_typeStreamLoaded = false;
+    mutable std::unique_ptr<ClassHierarchy> m_classHierarchy;
+    mutable bool m_classHierarchyLoaded = false;
+    std::unique_ptr<Snapshot> m_snapshot;
+    mutable std::unordered_map<uint32_t, GlobalTypeInfo> m_globalTypeCache;
+
+    bool InitializeDia() const noexcept;
+    bool EnsureDia() const noexcept;
+    std::shared_ptr<const MsfReader> GetMsf() const;
     void CleanupCom() noexcept;
-    std::optional<StructInfo> ParseStructInternal(const std::wstring& structName) const;
+    const StructInfo* ParseStructInternal(const std::wstring& structName, bool useDia = true) const;
+    const StructInfo* LookupStruct(const std::wstring& structName) const;
+    const EnumInfo* LookupEnum(const std::wstring& enumName) const;
+    bool DecodeFunction(IDiaSymbol* pFunction, FunctionInfo& functionInfo) const;
+    IDiaEnumFrameData* GetFrameData() const;
+    const SymbolStreams* GetSymbolStreams() const;
+    const TypeStream* GetTypeStream() const;
+    bool DecodeNativeStruct(const TypeStream& types, uint32_t typeIndex, StructInfo& structInfo) const;
+    GlobalSymbolInfo MakeGlobalSymbol(const NativeDataSymbol& symbol) const;
+    std::optional<GlobalSymbolInfo> FindGlobalSymbolDia(const std::wstring& name) const;
+
+    static HRESULT GetUndecoratedName(IDiaSymbol* pSymbol, CComBSTR& name);
+    static bool DecodePublicSymbol(IDiaSymbol* pSymbol, SymbolInfo& symbol);
+    static bool DecodeStruct(IDiaSymbol* pSymbol, StructInfo& structInfo);
+    static bool DecodeEnum(IDiaSymbol* pSymbol, EnumInfo& enumInfo);
+    static bool DecodeClass(IDiaSymbol* pSymbol, ClassRecord& record, DWORD pointerSize);
+    static std::string DescribeType(IDiaSymbol* pType);
+    static void DescribeMemberType(IDiaSymbol* pMember, StructMember& member);
+    static const char* DescribeCallingConvention(DWORD callingConvention);
+    static void CollectVariables(IDiaSymbol* pScope, FunctionInfo& functionInfo);
 
     template<typename Func>
     bool EnumerateSymbols(enum SymTagEnum symTag, const Func& callback) const;
 
+    struct AddressRange {
+        DWORD rva = 0;
+        DWORD length = 0;
+        DWORD parameterSize = 0;
+        std::string name;
+        bool isFunction = false;
+    };
+
+    template<typename Func>
+    bool ForEachAddressRange(const Func& callback) const;
+
 public:
-    explicit PdbParser(const std::wstring& pdbPath);
+    explicit PdbParser(const std::wstring& pdbPath, OpenMode openMode = OpenMode::Full);
     ~PdbParser() = default;
 
     PdbParser(const PdbParser&) = delete;
@@ -66,33 +313,98 @@ public:
     PdbParser(PdbParser&&) = default;
     PdbParser& operator=(PdbParser&&) = default;
 
-    bool IsInitialized() const noexcept { return m_pGlobalScope != nullptr; }
+    // A lightweight mode only counts as open once the stream it serves from was read natively.
+    bool IsInitialized() const noexcept {
+        switch (m_openMode) {
+        case OpenMode::PublicsOnly: return m_symbolStreams != nullptr;
+        case OpenMode::TypesOnly: return m_typeStream != nullptr;
+        default: return m_pGlobalScope != nullptr;
+        }
+    }
     MachineType GetMachineType() const noexcept { return m_machineType; }
+    OpenMode GetOpenMode() const noexcept { return m_openMode; }
     const std::wstring& GetPdbPath() const noexcept { return m_pdbPath; }
 
     std::vector<SymbolInfo> GetAllPublicSymbols() const;
+    bool ForEachPublicSymbol(const std::function<bool(const SymbolInfo&)>& callback) const;
     std::optional<DWORD64> GetSymbolRva(const std::wstring& symbolName) const;
 
     std::optional<StructInfo> GetStructInfo(const std::wstring& structName) const;
+    // Looks every name up through the cache, snapshot and TPI, then finds the rest in one DIA pass.
+    std::vector<std::optional<StructInfo>> GetStructInfos(const std::vector<std::wstring>& structNames) const;
     std::optional<DWORD64> GetStructMemberOffset(const std::wstring& structName,
         const std::wstring& memberName) const;
     std::vector<std::wstring> GetAllStructNames() const;
+    // Every UDT once per name, uncapped: the TPI stream in type index order, or DIA's UDT enumeration
+    // when the stream cannot be read. Structs are decoded on the fly and not cached.
+    bool ForEachStruct(const std::function<bool(const StructInfo&)>& callback) const;
+    std::optional<FieldPath> CompileFieldPath(const std::wstring& path) const;
+    const ClassHierarchy* GetClassHierarchy() const;
+    std::vector<StructLayoutReport> AnalyzeLayouts(size_t maxThreads = 0, DWORD64 cacheLineSize = 64) const;
+
+    std::optional<EnumInfo> GetEnumInfo(const std::wstring& enumName) const;
+    std::optional<std::string> GetEnumValueName(const std::wstring& enumName, int64_t value) const;
+    std::vector<std::string> DecomposeEnumFlags(const std::wstring& enumName, uint64_t value,
+        uint64_t* remainder = nullptr) const;
+    std::vector<std::wstring> GetAllEnumNames() const;
+    bool ForEachEnum(const std::function<bool(const EnumInfo&)>& callback) const;
+
+    std::optional<FunctionInfo> GetFunctionInfo(const std::wstring& functionName) const;
+    bool ForEachFunction(const std::function<bool(const FunctionInfo&)>& callback,
+        size_t workerIndex = 0, size_t workerCount = 1) const;
+    static std::vector<FunctionInfo> DecodeAllFunctions(const std::wstring& pdbPath, size_t maxThreads = 0);
+    bool ExportFunctions(const std::wstring& outputPath, size_t maxThreads = 0) const;
+
+    std::optional<LayoutHash> GetLayoutHash(const std::wstring& structName) const;
+    const std::unordered_map<std::string, LayoutHash>& ComputeLayoutHashes() const;
 
     std::vector<SymbolInfo> FindSymbolsByPattern(const std::wstring& pattern) const;
+    void ResolvePublics(PublicsQuery& query) const;
+
+    std::optional<GlobalSymbolInfo> GetGlobalSymbol(const std::wstring& name) const;
+    bool ForEachGlobalSymbol(const std::function<bool(const GlobalSymbolInfo&)>& callback) const;
+    std::vector<GlobalSymbolInfo> FindGlobalsByPattern(const std::wstring& pattern) const;
+    // One walk of the global symbols tested against every pattern.
+    std::vector<std::vector<GlobalSymbolInfo>> FindGlobalsByPatterns(const std::vector<std::wstring>& patterns) const;
+
     bool DumpToJson(const std::wstring& outputPath) const;
+    bool StreamToNdjson(std::ostream& out, size_t flushInterval = 1000) const;
+    bool ExportNdjson(const std::wstring& outputPath, size_t flushInterval = 1000) const;
+
+    std::optional<PdbIdentity> GetIdentity() const;
+    // Extent of the image's sections from the PDB's section headers.
+    std::optional<DWORD64> GetImageSize() const;
+    bool StreamToBreakpad(std::ostream& out) const;
+    bool ExportBreakpad(const std::wstring& outputPath) const;
+    bool StreamToPerfMap(std::ostream& out, DWORD64 imageBase) const;
+    bool ExportPerfMap(const std::wstring& outputPath, DWORD64 imageBase) const;
+    const std::vector<SymbolInfo>& GetAddressTable() const;
 
     void PreloadSymbols();
     void PreloadStructures();
     void ClearCaches() noexcept;
+
+    bool SaveSnapshot(const std::wstring& snapshotPath);
+    bool LoadSnapshot(const std::wstring& snapshotPath);
+    bool HasSnapshot() const noexcept { return m_snapshot != nullptr; }
+};
+
+struct SymbolServerConfig {
+    std::string serverUrl = "https://msdl.microsoft.com/download/symbols";
+    std::wstring storeDirectory = L"C:\\Symbols";
 };
 
 class PdbDownloader {
 private:
-    static std::string ExtractPdbInfo(const std::wstring& exePath);
     static bool DownloadFile(const std::string& url, const std::wstring& outputPath);
 
 public:
-    static std::optional<std::wstring> DownloadPdbForExecutable(const std::wstring& exePath);
+    static std::optional<PdbIdentity> ReadPdbIdentity(const std::wstring& exePath);
+    static std::wstring GetStorePath(const PdbIdentity& identity, const SymbolServerConfig& config);
+    static std::string GetDownloadUrl(const PdbIdentity& identity, const SymbolServerConfig& config);
+    static std::optional<std::wstring> FetchPdb(const PdbIdentity& identity, const SymbolServerConfig& config);
+    static std::optional<std::wstring> DownloadPdbForExecutable(const std::wstring& exePath,
+        const SymbolServerConfig& config = {});
 };
 
 struct SymbolDiff {
@@ -104,10 +416,21 @@ struct SymbolDiff {
     bool changed = false;
 };
 
+struct LayoutDiff {
+    std::string name;
+    LayoutHash oldHash;
+    LayoutHash newHash;
+    bool added = false;
+    bool removed = false;
+    bool changed = false;
+};
+
 class PdbComparer {
 public:
     static std::vector<SymbolDiff> ComparePdbs(const PdbParser& oldPdb, const PdbParser& newPdb);
+    static std::vector<LayoutDiff> CompareLayouts(const PdbParser& oldPdb, const PdbParser& newPdb);
     static void PrintDifferences(const std::vector<SymbolDiff>& diffs);
+    static void PrintLayoutDifferences(const std::vector<LayoutDiff>& diffs);
     static bool ExportDifferencesToJson(const std::vector<SymbolDiff>& diffs, const std::wstring& outputPath);
 };
 
@@ -115,5 +438,7 @@ class BatchProcessor {
 public:
     static void ProcessDirectory(const std::wstring& directory, const std::wstring& outputDir);
     static void ProcessMultiplePdbs(const std::vector<std::wstring>& pdbFiles, const std::wstring& outputDir);
+    // Writes <outputDir>\<stem>_analysis.json for one PDB; false if it cannot be parsed or written.
+    static bool ProcessPdb(const std::wstring& pdbFile, const std::wstring& outputDir);
     static void GenerateSummaryReport(const std::vector<std::wstring>& pdbFiles, const std::wstring& outputPath);
 };
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "PdbSet.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <regex>
+#include <filesystem>
+#include <iostream>
+#include <cctype>
+
+static bool EqualsIgnoreCase(const std::string& a, const std::string& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+        [](char x, char y) { return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y)); });
+}
+
+void PdbSet::AddModule(const std::wstring& pdbPath, DWORD64 baseAddress, const std::wstring& moduleName) {
+    auto module = std::make_unique<Module>();
+    module->pdbPath = pdbPath;
+    module->base = baseAddress;
+    module->name = WStringToString(moduleName.empty() ?
+        std::filesystem::path(pdbPath).stem().wstring() : moduleName);
+    m_modules.push_back(std::move(module));
+}
+
+size_t PdbSet::Load(size_t maxThreads) {
+    std::atomic<size_t> loaded{ 0 };
+
+    RunParallel(m_modules.size(), maxThreads, [&](size_t i) {
+        auto& module = *m_modules[i];
+        if (module.loaded) {
+            ++loaded;
+            return;
+        }
+
+        try {
+            PdbParser parser(module.pdbPath);
+            if (parser.IsInitialized()) {
+                module.imageSize = parser.GetImageSize().value_or(0);
+                Index(i, parser);
+                module.loaded = true;
+                ++loaded;
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to load " << module.name << ": " << e.what() << std::endl;
+        }
+        });
+
+    m_modulesByBase.clear();
+    for (size_t i = 0; i < m_modules.size(); ++i) {
+        if (m_modules[i]->loaded) {
+            m_modulesByBase.push_back(i);
+        }
+    }
+
+    std::sort(m_modulesByBase.begin(), m_modulesByBase.end(),
+        [&](size_t a, size_t b) { return m_modules[a]->base < m_modules[b]->base; });
+
+    return loaded;
+}
+
+bool PdbSet::IsModuleLoaded(size_t moduleIndex) const noexcept {
+    return moduleIndex < m_modules.size() && m_modules[moduleIndex]->loaded;
+}
+
+PdbSet::Shard& PdbSet::GetShard(const std::string& name) {
+    return m_shards[std::hash<std::string>{}(name) % ShardCount];
+}
+
+const PdbSet::Shard& PdbSet::GetShard(const std::string& name) const {
+    return m_shards[std::hash<std::string>{}(name) % ShardCount];
+}
+
+void PdbSet::Index(size_t moduleIndex, const PdbParser& parser) {
+    auto& module = *m_modules[moduleIndex];
+
+    parser.ForEachPublicSymbol([&](const SymbolInfo& symbol) -> bool {
+        module.symbolsByRva.push_back(symbol);
+        return true;
+        });
+
+    std::sort(module.symbolsByRva.begin(), module.symbolsByRva.end(),
+        [](const SymbolInfo& a, const SymbolInfo& b) { return a.rva < b.rva; });
+
+    std::array<std::vector<uint32_t>, ShardCount> buckets;
+    for (size_t i = 0; i < module.symbolsByRva.size(); ++i) {
+        buckets[std::hash<std::string>{}(module.symbolsByRva[i].name) % ShardCount].push_back(static_cast<uint32_t>(i));
+    }
+
+    for (size_t shardIndex = 0; shardIndex < ShardCount; ++shardIndex) {
+        if (buckets[shardIndex].empty()) continue;
+
+        auto& shard = m_shards[shardIndex];
+        std::lock_guard<std::mutex> guard(shard.lock);
+        for (uint32_t symbolIndex : buckets[shardIndex]) {
+            shard.names[module.symbolsByRva[symbolIndex].name].push_back(
+                SymbolRef{ static_cast<uint32_t>(moduleIndex), symbolIndex });
+        }
+    }
+}
+
+ModuleSymbol PdbSet::MakeModuleSymbol(size_t moduleIndex, size_t symbolIndex) const {
+    const auto& module = *m_modules[moduleIndex];
+    const auto& symbol = module.symbolsByRva[symbolIndex];
+    return ModuleSymbol{ module.name, symbol.name, symbol.rva, module.base + symbol.rva, symbol.size };
+}
+
+std::optional<size_t> PdbSet::FindModule(const std::string& moduleName) const {
+    for (size_t i = 0; i < m_modules.size(); ++i) {
+        if (EqualsIgnoreCase(m_modules[i]->name, moduleName)) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<ModuleSymbol> PdbSet::FindSymbol(const std::wstring& name) const {
+    std::vector<ModuleSymbol> results;
+
+    std::string symbolName = WStringToString(name);
+    std::optional<size_t> moduleFilter;
+
+    size_t bang = symbolName.find('!');
+    if (bang != std::string::npos) {
+        moduleFilter = FindModule(symbolName.substr(0, bang));
+        if (!moduleFilter) return results;
+
+        symbolName = symbolName.substr(bang + 1);
+    }
+
+    // Shards are only written during Load, so lookups read them without taking the lock.
+    const auto& shard = GetShard(symbolName);
+    auto it = shard.names.find(symbolName);
+    if (it == shard.names.end()) return results;
+
+    for (const auto& ref : it->second) {
+        if (!moduleFilter || *moduleFilter == ref.module) {
+            results.push_back(MakeModuleSymbol(ref.module, ref.symbol));
+        }
+    }
+
+    return results;
+}
+
+std::optional<DWORD64> PdbSet::GetSymbolAddress(const std::wstring& name) const {
+    auto matches = FindSymbol(name);
+    if (matches.empty()) return std::nullopt;
+    return matches.front().address;
+}
+
+std::vector<ModuleSymbol> PdbSet::FindSymbolsByPattern(const std::wstring& pattern) const {
+    std::vector<ModuleSymbol> matches;
+
+    try {
+        std::regex regex(WStringToString(pattern), std::regex_constants::icase);
+
+        for (size_t moduleIndex = 0; moduleIndex < m_modules.size(); ++moduleIndex) {
+            const auto& symbols = m_modules[moduleIndex]->symbolsByRva;
+            for (size_t i = 0; i < symbols.size() && matches.size() < 200; ++i) {
+                if (std::regex_search(symbols[i].name, regex)) {
+                    matches.push_back(MakeModuleSymbol(moduleIndex, i));
+                }
+            }
+        }
+    }
+    catch (const std::regex_error&) {
+    }
+
+    return matches;
+}
+
+std::optional<ResolvedAddress> PdbSet::ResolveAddress(DWORD64 address) const {
+    auto moduleIt = std::upper_bound(m_modulesByBase.begin(), m_modulesByBase.end(), address,
+        [&](DWORD64 value, size_t index) { return value < m_modules[index]->base; });
+
+    if (moduleIt == m_modulesByBase.begin()) return std::nullopt;
+
+    const auto& module = *m_modules[*(moduleIt - 1)];
+    DWORD64 rva = address - module.base;
+
+    // Without section headers the image size is unknown and only the next module's base bounds it.
+    if (module.imageSize != 0 && rva >= module.imageSize) return std::nullopt;
+
+    ResolvedAddress resolved{ module.name, std::string(), address, rva };
+
+    auto symbolIt = std::upper_bound(module.symbolsByRva.begin(), module.symbolsByRva.end(), rva,
+        [](DWORD64 value, const SymbolInfo& symbol) { return value < symbol.rva; });
+
+    if (symbolIt != module.symbolsByRva.begin()) {
+        const auto& symbol = *(symbolIt - 1);
+        // Publics often carry no length; those cover everything up to the next symbol.
+        if (symbol.size == 0 || rva - symbol.rva < symbol.size) {
+            resolved.symbolName = symbol.name;
+            resolved.displacement = rva - symbol.rva;
+        }
+    }
+
+    return resolved;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "PdbParser.h"
+#include <array>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+struct ModuleSymbol {
+    std::string moduleName;
+    std::string name;
+    DWORD64 rva;
+    DWORD64 address;
+    DWORD64 size;
+};
+
+struct ResolvedAddress {
+    std::string moduleName;
+    std::string symbolName;
+    DWORD64 address;
+    DWORD64 displacement;
+};
+
+class PdbSet {
+private:
+    struct Module {
+        std::wstring pdbPath;
+        std::string name;
+        DWORD64 base = 0;
+        DWORD64 imageSize = 0;
+        bool loaded = false;
+        std::vector<SymbolInfo> symbolsByRva;
+    };
+
+    struct SymbolRef {
+        uint32_t module;
+        uint32_t symbol;
+    };
+
+    struct Shard {
+        std::mutex lock;
+        std::unordered_map<std::string, std::vector<SymbolRef>> names;
+    };
+
+    static constexpr size_t ShardCount = 16;
+
+    std::vector<std::unique_ptr<Module>> m_modules;
+    std::vector<size_t> m_modulesByBase;
+    std::array<Shard, ShardCount> m_shards;
+
+    Shard& GetShard(const std::string& name);
+    const Shard& GetShard(const std::string& name) const;
+    void Index(size_t moduleIndex, const PdbParser& parser);
+    ModuleSymbol MakeModuleSymbol(size_t moduleIndex, size_t symbolIndex) const;
+    std::optional<size_t> FindModule(const std::string& moduleName) const;
+
+public:
+    PdbSet() = default;
+    ~PdbSet() = default;
+
+    PdbSet(const PdbSet&) = delete;
+    PdbSet& operator=(const PdbSet&) = delete;
+
+    void AddModule(const std::wstring& pdbPath, DWORD64 baseAddress, const std::wstring& moduleName = L"");
+    // Each module is opened and indexed on one worker, and its parser closed there before Load
+    // returns: a DIA session is not shared across threads, so queries only read the indexes.
+    size_t Load(size_t maxThreads = 0);
+
+    size_t GetModuleCount() const noexcept { return m_modules.size(); }
+    bool IsModuleLoaded(size_t moduleIndex) const noexcept;
+
+    std::vector<ModuleSymbol> FindSymbol(const std::wstring& name) const;
+    std::optional<DWORD64> GetSymbolAddress(const std::wstring& name) const;
+    std::vector<ModuleSymbol> FindSymbolsByPattern(const std::wstring& pattern) const;
+    // nullopt outside every module's image; an address inside a module but not inside a symbol
+    // comes back with an empty symbolName and its offset from the module base.
+    std::optional<ResolvedAddress> ResolveAddress(DWORD64 address) const;
+};
@@ -0,0 +1,167 @@
+#include "QueryScript.h"
+#include "BatchUtil.h"
+#include <chrono>
+#include <iostream>
+
+namespace {
+    struct ScriptOption {
+        const wchar_t* name;
+        ScriptOp op;
+        size_t argumentCount;
+    };
+
+    const ScriptOption ScriptOptions[] = {
+        { L"-s", ScriptOp::Symbol, 1 },
+        { L"-p", ScriptOp::Pattern, 1 },
+        { L"-g", ScriptOp::Global, 1 },
+        { L"-gp", ScriptOp::GlobalPattern, 1 },
+        { L"-t", ScriptOp::Struct, 1 },
+        { L"-m", ScriptOp::Member, 2 },
+        { L"-path", ScriptOp::FieldPath, 1 },
+        { L"-f", ScriptOp::Function, 1 },
+        { L"-e", ScriptOp::Enum, 1 },
+        { L"-ev", ScriptOp::EnumValue, 2 },
+        { L"-hash", ScriptOp::LayoutHash, 1 },
+        { L"-class", ScriptOp::Class, 1 },
+        { L"-subclasses", ScriptOp::Subclasses, 1 },
+        { L"-overrides", ScriptOp::Overrides, 2 },
+    };
+}
+
+std::vector<std::wstring> QueryScript::SplitLine(const std::string& line) {
+    std::vector<std::wstring> tokens;
+    size_t position = 0;
+
+    while (position < line.size()) {
+        while (position < line.size() && (line[position] == ' ' || line[position] == '\t' || line[position] == '\r')) {
+            ++position;
+        }
+        if (position >= line.size()) break;
+
+        std::string token;
+        bool quoted = false;
+        for (; position < line.size(); ++position) {
+            char c = line[position];
+            if (c == '"') {
+                quoted = !quoted;
+            }
+            else if (!quoted && (c == ' ' || c == '\t' || c == '\r')) {
+                break;
+            }
+            else {
+                token.push_back(c);
+            }
+        }
+        tokens.emplace_back(token.begin(), token.end());
+    }
+
+    return tokens;
+}
+
+std::wstring QueryScript::GetPathRoot(const std::wstring& path) {
+    size_t end = 0;
+    while (end < path.size() && path[end] != L'.' && path[end] != L'[' && path.compare(end, 2, L"->") != 0) {
+        ++end;
+    }
+    return path.substr(0, end);
+}
+
+size_t QueryScript::Plan(std::unordered_map<std::wstring, size_t>& slots, std::vector<std::wstring>& keys,
+    const std::wstring& key) {
+    auto [it, inserted] = slots.emplace(key, keys.size());
+    if (inserted) keys.push_back(key);
+    return it->second;
+}
+
+void QueryScript::Plan(ScriptQuery& query) {
+    switch (query.op) {
+    case ScriptOp::Symbol:
+        query.slot = Plan(m_nameSlots, m_publics.names, query.args[0]);
+        break;
+    case ScriptOp::Pattern:
+        query.slot = Plan(m_patternSlots, m_publics.patterns, query.args[0]);
+        break;
+    case ScriptOp::GlobalPattern:
+        query.slot = Plan(m_globalPatternSlots, m_globalPatterns, query.args[0]);
+        break;
+    case ScriptOp::Struct:
+    case ScriptOp::Member:
+        query.slot = Plan(m_structSlots, m_structNames, query.args[0]);
+        break;
+    case ScriptOp::FieldPath:
+        query.slot = Plan(m_structSlots, m_structNames, GetPathRoot(query.args[0]));
+        break;
+    default:
+        ++m_stats.direct;
+        break;
+    }
+}
+
+void QueryScript::Load(std::istream& in) {
+    std::string line;
+    size_t lineNumber = 0;
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        auto tokens = SplitLine(line);
+        const ScriptOption* option = nullptr;
+        for (const auto& candidate : ScriptOptions) {
+            if (tokens[0] == candidate.name) {
+                option = &candidate;
+                break;
+            }
+        }
+
+        if (!option) {
+            m_errors.push_back("line " + std::to_string(lineNumber) + ": unsupported query " + WStringToString(tokens[0]));
+            ++m_stats.skippedLines;
+            continue;
+        }
+        if (tokens.size() - 1 != option->argumentCount) {
+            m_errors.push_back("line " + std::to_string(lineNumber) + ": " + WStringToString(tokens[0]) + " expects " +
+                std::to_string(option->argumentCount) + (option->argumentCount == 1 ? " argument" : " arguments"));
+            ++m_stats.skippedLines;
+            continue;
+        }
+
+        ScriptQuery query;
+        query.op = option->op;
+        query.args.assign(tokens.begin() + 1, tokens.end());
+        query.line = lineNumber;
+        Plan(query);
+        m_queries.push_back(std::move(query));
+    }
+
+    m_stats.queries = m_queries.size();
+}
+
+void QueryScript::Execute(const PdbParser& parser) {
+    m_stats.publicNames = m_publics.names.size();
+    m_stats.publicPatterns = m_publics.patterns.size();
+    m_stats.structs = m_structNames.size();
+    m_stats.globalPatterns = m_globalPatterns.size();
+
+    auto start = std::chrono::steady_clock::now();
+    parser.ResolvePublics(m_publics);
+    m_stats.publicsUs = ElapsedUs(start);
+
+    start = std::chrono::steady_clock::now();
+    m_structs = parser.GetStructInfos(m_structNames);
+    m_stats.typesUs = ElapsedUs(start);
+
+    start = std::chrono::steady_clock::now();
+    m_globalMatches = parser.FindGlobalsByPatterns(m_globalPatterns);
+    m_stats.globalsUs = ElapsedUs(start);
+}
+
+void QueryScript::PrintStats(const QueryScriptStats& stats) {
+    std::cout << "Queries:         " << stats.queries << " (" << stats.skippedLines << " lines skipped)\n";
+    std::cout << "Publics:         " << stats.publicNames << " names, " << stats.publicPatterns << " patterns in "
+        << stats.publicsUs / 1000 << "ms\n";
+    std::cout << "Types:           " << stats.structs << " structs in " << stats.typesUs / 1000 << "ms\n";
+    std::cout << "Globals:         " << stats.globalPatterns << " patterns in " << stats.globalsUs / 1000 << "ms\n";
+    std::cout << "Direct lookups:  " << stats.direct << "\n";
+}
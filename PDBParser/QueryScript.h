@@ -0,0 +1,94 @@
+#pragma once
+#include "PdbParser.h"
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class ScriptOp {
+    Symbol,
+    Pattern,
+    Global,
+    GlobalPattern,
+    Struct,
+    Member,
+    FieldPath,
+    Function,
+    Enum,
+    EnumValue,
+    LayoutHash,
+    Class,
+    Subclasses,
+    Overrides
+};
+
+// One script line. slot indexes the answer in the batch the query was planned into; queries that
+// resolve through a per-name hash or index (-g, -f, -e, -class, ...) are not batched and have none.
+struct ScriptQuery {
+    ScriptOp op;
+    std::vector<std::wstring> args;
+    size_t line = 0;
+    size_t slot = 0;
+};
+
+struct QueryScriptStats {
+    size_t queries = 0;
+    size_t skippedLines = 0;
+    size_t publicNames = 0;
+    size_t publicPatterns = 0;
+    size_t structs = 0;
+    size_t globalPatterns = 0;
+    size_t direct = 0;
+    uint64_t publicsUs = 0;
+    uint64_t typesUs = 0;
+    uint64_t globalsUs = 0;
+};
+
+// A file of queries in command line syntax, one per line ("-s NtCreateFile", "-m _EPROCESS Pcb").
+// Every line is parsed before anything runs and the queries are grouped by the index they read:
+// symbol names and patterns go to one PublicsQuery, struct names (of -t, -m and the roots of -path)
+// to one GetStructInfos call and global patterns to one walk of the globals, each name asked once
+// however often it appears. Results are then read back in script order.
+class QueryScript {
+private:
+    std::vector<ScriptQuery> m_queries;
+    std::vector<std::string> m_errors;
+    QueryScriptStats m_stats;
+
+    PublicsQuery m_publics;
+    std::unordered_map<std::wstring, size_t> m_nameSlots;
+    std::unordered_map<std::wstring, size_t> m_patternSlots;
+    std::vector<std::wstring> m_structNames;
+    std::unordered_map<std::wstring, size_t> m_structSlots;
+    std::vector<std::optional<StructInfo>> m_structs;
+    std::vector<std::wstring> m_globalPatterns;
+    std::unordered_map<std::wstring, size_t> m_globalPatternSlots;
+    std::vector<std::vector<GlobalSymbolInfo>> m_globalMatches;
+
+    static size_t Plan(std::unordered_map<std::wstring, size_t>& slots, std::vector<std::wstring>& keys,
+        const std::wstring& key);
+    void Plan(ScriptQuery& query);
+
+public:
+    // Blank lines and lines starting with '#' are skipped; unknown options and missing arguments are
+    // collected in GetErrors and the line is skipped.
+    void Load(std::istream& in);
+    void Execute(const PdbParser& parser);
+
+    static std::vector<std::wstring> SplitLine(const std::string& line);
+    // The struct a field path starts from: everything before the first '.', '[' or "->".
+    static std::wstring GetPathRoot(const std::wstring& path);
+
+    const std::vector<ScriptQuery>& GetQueries() const noexcept { return m_queries; }
+    const std::vector<std::string>& GetErrors() const noexcept { return m_errors; }
+    const QueryScriptStats& GetStats() const noexcept { return m_stats; }
+
+    const std::optional<DWORD64>& GetSymbolRva(const ScriptQuery& query) const { return m_publics.rvas[query.slot]; }
+    const std::vector<SymbolInfo>& GetSymbolMatches(const ScriptQuery& query) const { return m_publics.matches[query.slot]; }
+    const std::optional<StructInfo>& GetStruct(const ScriptQuery& query) const { return m_structs[query.slot]; }
+    const std::vector<GlobalSymbolInfo>& GetGlobalMatches(const ScriptQuery& query) const { return m_globalMatches[query.slot]; }
+
+    static void PrintStats(const QueryScriptStats& stats);
+};
@@ -0,0 +1,848 @@
+#include "ReducedPdb.h"
+#include "BatchUtil.h"
+#include "MsfWriter.h"
+#include "SymbolStreams.h"
+#include "TypeStream.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <unordered_set>
+
+namespace {
+    constexpr uint32_t PdbInfoStream = 1;
+    constexpr size_t PdbInfoHeaderSize = 28;
+    constexpr size_t PdbInfoAgeOffset = 8;
+    constexpr uint32_t PdbImplVC140 = 20140508;
+    constexpr uint32_t NamedStreamMapCapacity = 8;
+
+    constexpr uint32_t TpiVersion = 20040203;
+    constexpr uint32_t TpiHashBuckets = 0x3FFFF;
+    constexpr uint32_t TpiIndexOffsetInterval = 8192;
+    constexpr uint32_t FirstTypeIndex = 0x1000;
+
+    constexpr uint32_t DbiVersion = 19990903;
+    constexpr uint16_t DbiBuildNumber = 0x8E00;
+    constexpr uint32_t SectionContributionVersion = 0xEFFE0000 + 19970605;
+
+    constexpr uint32_t GsiSignature = 0xFFFFFFFF;
+    constexpr uint32_t GsiVersion = 0xEFFE0000 + 19990810;
+    constexpr uint32_t GsiBucketCount = 4096;
+    constexpr uint32_t GsiBucketOffsetUnit = 12;
+
+    constexpr uint32_t StringTableSignature = 0xEFFEEFFE;
+
+    constexpr size_t SectionHeaderSize = 40;
+    constexpr size_t SectionVirtualSizeOffset = 8;
+    constexpr size_t SectionCharacteristicsOffset = 36;
+
+    constexpr uint16_t PropertyScoped = 0x0100;
+    constexpr uint16_t PropertyHasUniqueName = 0x0200;
+
+#pragma pack(push, 1)
+    struct TpiHeader {
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t typeIndexBegin;
+        uint32_t typeIndexEnd;
+        uint32_t typeRecordBytes;
+        uint16_t hashStreamIndex;
+        uint16_t hashAuxStreamIndex;
+        uint32_t hashKeySize;
+        uint32_t hashBucketCount;
+        int32_t hashValueBufferOffset;
+        uint32_t hashValueBufferLength;
+        int32_t indexOffsetBufferOffset;
+        uint32_t indexOffsetBufferLength;
+        int32_t hashAdjBufferOffset;
+        uint32_t hashAdjBufferLength;
+    };
+
+    struct DbiHeader {
+        int32_t versionSignature;
+        uint32_t versionHeader;
+        uint32_t age;
+        uint16_t globalStreamIndex;
+        uint16_t buildNumber;
+        uint16_t publicStreamIndex;
+        uint16_t pdbDllVersion;
+        uint16_t symbolRecordStream;
+        uint16_t pdbDllRebuild;
+        int32_t moduleInfoSize;
+        int32_t sectionContributionSize;
+        int32_t sectionMapSize;
+        int32_t sourceInfoSize;
+        int32_t typeServerMapSize;
+        uint32_t mfcTypeServerIndex;
+        int32_t optionalDbgHeaderSize;
+        int32_t ecSubstreamSize;
+        uint16_t flags;
+        uint16_t machine;
+        uint32_t padding;
+    };
+
+    struct ModuleInfoHeader {
+        uint32_t unused1;
+        uint16_t section;
+        uint16_t padding1;
+        int32_t offset;
+        int32_t size;
+        uint32_t characteristics;
+        uint16_t moduleIndex;
+        uint16_t padding2;
+        uint32_t dataCrc;
+        uint32_t relocCrc;
+        uint16_t flags;
+        uint16_t moduleSymbolStream;
+        uint32_t symbolByteSize;
+        uint32_t c11ByteSize;
+        uint32_t c13ByteSize;
+        uint16_t sourceFileCount;
+        uint16_t padding3;
+        uint32_t unused2;
+        uint32_t sourceFileNameIndex;
+        uint32_t pdbFilePathNameIndex;
+    };
+
+    struct SectionMapEntry {
+        uint16_t flags;
+        uint16_t overlay;
+        uint16_t group;
+        uint16_t frame;
+        uint16_t sectionName;
+        uint16_t className;
+        uint32_t offset;
+        uint32_t sectionLength;
+    };
+
+    struct GsiHeader {
+        uint32_t signature;
+        uint32_t version;
+        uint32_t hashRecordBytes;
+        uint32_t bucketBytes;
+    };
+
+    struct PublicsHeader {
+        uint32_t symbolHashBytes;
+        uint32_t addressMapBytes;
+        uint32_t thunkCount;
+        uint32_t thunkSize;
+        uint16_t thunkTableSection;
+        uint16_t padding;
+        uint32_t thunkTableOffset;
+        uint32_t sectionCount;
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(TpiHeader) == 56, "TPI header layout");
+    static_assert(sizeof(DbiHeader) == 64, "DBI header layout");
+    static_assert(sizeof(ModuleInfoHeader) == 64, "module info layout");
+    static_assert(sizeof(PublicsHeader) == 28, "publics header layout");
+
+    template<typename T>
+    void Append(std::vector<uint8_t>& out, const T& value) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    void AppendString(std::vector<uint8_t>& out, std::string_view value) {
+        out.insert(out.end(), value.begin(), value.end());
+        out.push_back(0);
+    }
+
+    void AlignTo4(std::vector<uint8_t>& out) {
+        out.resize((out.size() + 3) & ~size_t{ 3 }, 0);
+    }
+
+    // How a record uses a type it references. Layout references are part of the referrer's storage
+    // (members, bases, array elements), so a forward reference reached through them needs its
+    // definition; a UDT's own field list is always laid out.
+    enum class TypeUse {
+        Reference,
+        Layout,
+        Definition
+    };
+
+    template<typename Record>
+    constexpr TypeUse GetTypeUse() {
+        if constexpr (std::is_base_of_v<CodeViewRecord::Structure, Record> ||
+            std::is_same_v<CodeViewRecord::Union, Record> || std::is_same_v<CodeViewRecord::Enum, Record>) {
+            return TypeUse::Definition;
+        }
+        else if constexpr (std::is_same_v<CodeViewRecord::Modifier, Record> || std::is_same_v<CodeViewRecord::Array, Record> ||
+            std::is_same_v<CodeViewRecord::Bitfield, Record> || std::is_same_v<CodeViewRecord::Member, Record> ||
+            std::is_same_v<CodeViewRecord::BaseClass, Record> || std::is_base_of_v<CodeViewRecord::VirtualBaseClass, Record> ||
+            std::is_same_v<CodeViewRecord::Index, Record>) {
+            return TypeUse::Layout;
+        }
+        else {
+            return TypeUse::Reference;
+        }
+    }
+
+    // Calls func(field, use) for every type index in a type record body. Byte is uint8_t when the
+    // indices are rewritten in place. Returns false for kinds whose layout is not known, including
+    // field lists holding such members.
+    template<typename Byte, typename Func>
+    bool ForEachTypeReference(uint16_t kind, Byte* body, size_t size, const Func& func) {
+        switch (static_cast<CodeViewLeafKind>(kind)) {
+        case CodeViewLeafKind::LF_VTSHAPE:
+        case CodeViewLeafKind::LF_LABEL:
+            return true;
+
+        case CodeViewLeafKind::LF_ARGLIST: {
+            uint32_t count = 0;
+            if (size < sizeof(count)) return false;
+            memcpy(&count, body, sizeof(count));
+            if (count > (size - sizeof(count)) / sizeof(uint32_t)) return false;
+
+            for (uint32_t i = 0; i < count; ++i) {
+                func(body + sizeof(count) + i * sizeof(uint32_t), TypeUse::Reference);
+            }
+            return true;
+        }
+
+        case CodeViewLeafKind::LF_METHODLIST:
+            for (size_t position = 0; position < size;) {
+                CodeViewRecord::MethodListEntry entry{};
+                size_t consumed = CodeView::Decode(body + position, size - position, entry);
+                if (consumed == 0) return false;
+
+                CodeView::ForEachTypeIndex<CodeViewRecord::MethodListEntry>(body + position, consumed,
+                    [&](Byte* field) { func(field, TypeUse::Reference); });
+                position += consumed;
+            }
+            return true;
+
+        case CodeViewLeafKind::LF_FIELDLIST:
+            for (size_t position = 0; position + sizeof(uint16_t) <= size;) {
+                uint16_t memberKind = 0;
+                memcpy(&memberKind, body + position, sizeof(memberKind));
+                position += sizeof(memberKind);
+
+                Byte* member = body + position;
+                size_t remaining = size - position;
+                auto visitor = [&](const auto& record) {
+                    using Record = std::decay_t<decltype(record)>;
+                    CodeView::ForEachTypeIndex<Record>(member, remaining,
+                        [&](Byte* field) { func(field, GetTypeUse<Record>()); });
+                };
+
+                size_t consumed = 0;
+                if (!CodeViewFieldDispatcher::Dispatch(memberKind, member, remaining, visitor, consumed)) return false;
+                position = CodeView::SkipPadding(body, size, position + consumed);
+            }
+            return true;
+
+        default: {
+            auto visitor = [&](const auto& record) {
+                using Record = std::decay_t<decltype(record)>;
+                CodeView::ForEachTypeIndex<Record>(body, size, [&](Byte* field) { func(field, GetTypeUse<Record>()); });
+
+                // Pointers to members name the containing class right after the attributes.
+                if constexpr (std::is_same_v<CodeViewRecord::Pointer, Record>) {
+                    uint32_t mode = (record.attributes >> 5) & 7;
+                    if ((mode == 2 || mode == 3) && size >= 3 * sizeof(uint32_t)) {
+                        func(body + 2 * sizeof(uint32_t), TypeUse::Reference);
+                    }
+                }
+            };
+
+            size_t consumed = 0;
+            return CodeViewTypeDispatcher::Dispatch(kind, body, size, visitor, consumed);
+        }
+        }
+    }
+
+    struct UdtHeader {
+        bool isUdt = false;
+        bool isForwardRef = false;
+        uint16_t property = 0;
+        std::string_view name;
+        std::string_view uniqueName;
+    };
+
+    UdtHeader ReadUdtHeader(uint16_t kind, const uint8_t* body, size_t size) {
+        UdtHeader header;
+        auto visitor = [&](const auto& record) {
+            using Record = std::decay_t<decltype(record)>;
+            if constexpr (std::is_base_of_v<CodeViewRecord::Structure, Record> ||
+                std::is_same_v<CodeViewRecord::Union, Record> || std::is_same_v<CodeViewRecord::Enum, Record>) {
+                header.isUdt = true;
+                header.isForwardRef = (record.property & CodeView::PropertyForwardRef) != 0;
+                header.property = record.property;
+                header.name = record.name;
+            }
+        };
+
+        size_t consumed = 0;
+        if (CodeViewTypeDispatcher::Dispatch(kind, body, size, visitor, consumed) && header.isUdt &&
+            (header.property & PropertyHasUniqueName) && consumed < size) {
+            const char* begin = reinterpret_cast<const char*>(body + consumed);
+            if (const void* terminator = memchr(begin, 0, size - consumed)) {
+                header.uniqueName = std::string_view(begin, static_cast<const char*>(terminator) - begin);
+            }
+        }
+        return header;
+    }
+
+    bool IsAnonymous(std::string_view name) {
+        auto endsWith = [&](std::string_view suffix) {
+            return name.size() >= suffix.size() && name.substr(name.size() - suffix.size()) == suffix;
+        };
+        return name == "<unnamed-tag>" || name == "__unnamed" || endsWith("::<unnamed-tag>") || endsWith("::__unnamed");
+    }
+
+    uint32_t JamCrc(const uint8_t* data, size_t size) {
+        uint32_t crc = 0;
+        for (size_t i = 0; i < size; ++i) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+            }
+        }
+        return crc;
+    }
+
+    // TPI hash of a record: named UDT definitions hash their (unique) name so lookups by name land in
+    // one bucket; everything else hashes the record bytes.
+    uint32_t HashTypeRecord(uint16_t kind, const uint8_t* record, size_t size) {
+        UdtHeader header = ReadUdtHeader(kind, record + 2 * sizeof(uint16_t), size - 2 * sizeof(uint16_t));
+        if (header.isUdt && !header.isForwardRef) {
+            bool hasUniqueName = (header.property & PropertyHasUniqueName) != 0;
+            bool anonymous = hasUniqueName && IsAnonymous(header.name);
+
+            if (!(header.property & PropertyScoped) && !anonymous) {
+                return GsiHashTable::HashName(header.name) % TpiHashBuckets;
+            }
+            if (hasUniqueName && !anonymous) {
+                return GsiHashTable::HashName(header.uniqueName) % TpiHashBuckets;
+            }
+        }
+        return JamCrc(record, size) % TpiHashBuckets;
+    }
+
+    // Order of records within a GSI bucket: shorter names first, then case-insensitively for ASCII.
+    bool GsiNameLess(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return a.size() < b.size();
+
+        bool ascii = std::all_of(a.begin(), a.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; }) &&
+            std::all_of(b.begin(), b.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+        if (!ascii) return memcmp(a.data(), b.data(), a.size()) < 0;
+
+        for (size_t i = 0; i < a.size(); ++i) {
+            char lowerA = static_cast<char>(tolower(static_cast<unsigned char>(a[i])));
+            char lowerB = static_cast<char>(tolower(static_cast<unsigned char>(b[i])));
+            if (lowerA != lowerB) return lowerA < lowerB;
+        }
+        return false;
+    }
+
+    struct GsiEntry {
+        std::string_view name;
+        uint32_t recordOffset;
+        uint32_t bucket;
+    };
+
+    // The on-disk Globals Symbol Index hash: one hash record per symbol grouped by bucket, the
+    // occupied-bucket bitmap and the first hash record of every occupied bucket.
+    std::vector<uint8_t> BuildGsiHash(std::vector<GsiEntry> entries) {
+        for (auto& entry : entries) {
+            entry.bucket = GsiHashTable::HashName(entry.name) % GsiBucketCount;
+        }
+        std::stable_sort(entries.begin(), entries.end(), [](const GsiEntry& a, const GsiEntry& b) {
+            return a.bucket != b.bucket ? a.bucket < b.bucket : GsiNameLess(a.name, b.name);
+            });
+
+        std::vector<uint32_t> bitmap((GsiBucketCount + 1 + 31) / 32, 0);
+        std::vector<uint32_t> bucketStarts;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (i == 0 || entries[i].bucket != entries[i - 1].bucket) {
+                bitmap[entries[i].bucket / 32] |= 1u << (entries[i].bucket % 32);
+                bucketStarts.push_back(static_cast<uint32_t>(i) * GsiBucketOffsetUnit);
+            }
+        }
+
+        GsiHeader header{ GsiSignature, GsiVersion, static_cast<uint32_t>(entries.size() * 2 * sizeof(int32_t)),
+            static_cast<uint32_t>((bitmap.size() + bucketStarts.size()) * sizeof(uint32_t)) };
+
+        std::vector<uint8_t> hash;
+        Append(hash, header);
+        for (const auto& entry : entries) {
+            Append(hash, static_cast<int32_t>(entry.recordOffset + 1));
+            Append(hash, int32_t{ 1 });
+        }
+        for (uint32_t word : bitmap) Append(hash, word);
+        for (uint32_t start : bucketStarts) Append(hash, start);
+        return hash;
+    }
+
+    // An empty PDB string table, the layout of both the /names stream and the DBI EC substream.
+    std::vector<uint8_t> BuildEmptyStringTable() {
+        std::vector<uint8_t> table;
+        Append(table, StringTableSignature);
+        Append(table, uint32_t{ 1 });
+        Append(table, uint32_t{ 4 });
+        Append(table, uint32_t{ 0 });
+        Append(table, uint32_t{ 1 });
+        Append(table, uint32_t{ 0 });
+        Append(table, uint32_t{ 0 });
+        return table;
+    }
+
+    TpiHeader MakeTpiHeader(uint32_t typeCount, uint32_t recordBytes, uint32_t hashStream, uint32_t indexOffsetCount) {
+        TpiHeader header{};
+        header.version = TpiVersion;
+        header.headerSize = sizeof(TpiHeader);
+        header.typeIndexBegin = FirstTypeIndex;
+        header.typeIndexEnd = FirstTypeIndex + typeCount;
+        header.typeRecordBytes = recordBytes;
+        header.hashStreamIndex = static_cast<uint16_t>(hashStream);
+        header.hashAuxStreamIndex = MsfReader::InvalidStream;
+        header.hashKeySize = sizeof(uint32_t);
+        header.hashBucketCount = TpiHashBuckets;
+        header.hashValueBufferLength = typeCount * sizeof(uint32_t);
+        header.indexOffsetBufferOffset = static_cast<int32_t>(header.hashValueBufferLength);
+        header.indexOffsetBufferLength = indexOffsetCount * 2 * sizeof(uint32_t);
+        header.hashAdjBufferOffset = header.indexOffsetBufferOffset + static_cast<int32_t>(header.indexOffsetBufferLength);
+        return header;
+    }
+}
+
+bool ReducedPdbWriter::Write(const std::wstring& sourcePath, const std::wstring& outputPath,
+    const std::vector<std::string>& names, ReducedPdbStats& stats) {
+    TraceScope trace(TracePhase::ReducePdb);
+    auto start = std::chrono::steady_clock::now();
+    stats = ReducedPdbStats{};
+    std::wstring tempPath = outputPath + L".tmp";
+
+    try {
+        auto msf = std::make_shared<MsfReader>(sourcePath);
+        SymbolStreams symbols(msf);
+        TypeStream types(*msf);
+
+        std::vector<uint8_t> info;
+        if (!msf->ReadStream(PdbInfoStream, info) || info.size() < PdbInfoHeaderSize) return false;
+        uint32_t age = 0;
+        memcpy(&age, info.data() + PdbInfoAgeOffset, sizeof(age));
+
+        struct PublicEntry {
+            std::string name;
+            uint32_t flags;
+            uint16_t section;
+            uint32_t offset;
+        };
+
+        struct GlobalEntry {
+            std::string name;
+            CodeViewSymbolKind kind;
+            uint32_t type;
+            uint16_t section;
+            uint32_t offset;
+        };
+
+        std::vector<PublicEntry> publics;
+        std::vector<GlobalEntry> globals;
+        std::vector<uint32_t> roots;
+        std::unordered_set<std::string> seen;
+
+        for (const auto& name : names) {
+            if (name.empty() || !seen.insert(name).second) continue;
+            bool found = false;
+
+            if (auto symbol = symbols.FindPublic(name)) {
+                publics.push_back({ name, symbol->flags, symbol->section, symbol->offset });
+                found = true;
+            }
+            if (auto symbol = symbols.FindGlobalData(name)) {
+                globals.push_back({ name, symbol->kind, symbol->typeIndex, symbol->section, symbol->offset });
+                roots.push_back(symbol->typeIndex);
+                found = true;
+            }
+            if (auto typeIndex = types.FindUdt(name)) {
+                roots.push_back(*typeIndex);
+                stats.udts++;
+                found = true;
+            }
+
+            if (!found) stats.missing.push_back(name);
+        }
+
+        // Type closure. A type reached only by reference is copied as is; one reached by value also
+        // pulls in what its own layout references by value, and a forward reference its definition.
+        const uint32_t typeBegin = types.GetTypeIndexBegin();
+        const uint32_t typeEnd = typeBegin + static_cast<uint32_t>(types.GetTypeCount());
+        constexpr uint8_t Included = 1, ExpandedByValue = 2, UnknownLayout = 4;
+
+        std::vector<uint8_t> state(typeEnd - typeBegin, 0);
+        std::vector<std::pair<uint32_t, bool>> pending;
+
+        auto require = [&](uint32_t typeIndex, bool byValue) {
+            if (typeIndex < typeBegin || typeIndex >= typeEnd) return;
+            uint8_t& flags = state[typeIndex - typeBegin];
+            uint8_t wanted = byValue ? (Included | ExpandedByValue) : Included;
+            if ((flags & wanted) == wanted) return;
+            flags |= wanted;
+            pending.push_back({ typeIndex, byValue });
+        };
+
+        for (uint32_t root : roots) {
+            require(root, true);
+        }
+
+        while (!pending.empty()) {
+            auto [typeIndex, byValue] = pending.back();
+            pending.pop_back();
+
+            const uint8_t* record = nullptr;
+            size_t size = 0;
+            uint16_t kind = 0;
+            if (!types.GetRecord(typeIndex, record, size)) {
+                state[typeIndex - typeBegin] |= UnknownLayout;
+                continue;
+            }
+            memcpy(&kind, record + sizeof(uint16_t), sizeof(kind));
+
+            const uint8_t* body = record + 2 * sizeof(uint16_t);
+            size_t bodySize = size - 2 * sizeof(uint16_t);
+            bool known = ForEachTypeReference(kind, body, bodySize, [&](const uint8_t* field, TypeUse use) {
+                uint32_t reference = 0;
+                memcpy(&reference, field, sizeof(reference));
+                require(reference, use == TypeUse::Definition || (use == TypeUse::Layout && byValue));
+                });
+
+            if (!known) {
+                state[typeIndex - typeBegin] |= UnknownLayout;
+                continue;
+            }
+
+            if (byValue) {
+                UdtHeader header = ReadUdtHeader(kind, body, bodySize);
+                if (header.isUdt && header.isForwardRef) {
+                    if (auto definition = types.FindUdt(header.name)) {
+                        require(*definition, true);
+                    }
+                }
+            }
+        }
+
+        // Kept records stay in source order, so every record still only refers back to earlier ones;
+        // references to records of unknown layout become T_NOTYPE.
+        std::vector<uint32_t> ordered;
+        std::vector<uint32_t> renumbered(state.size(), 0);
+        for (uint32_t i = 0; i < state.size(); ++i) {
+            if (state[i] & UnknownLayout) {
+                stats.unknownTypes++;
+            }
+            else if (state[i] & Included) {
+                renumbered[i] = FirstTypeIndex + static_cast<uint32_t>(ordered.size());
+                ordered.push_back(typeBegin + i);
+            }
+        }
+
+        auto renumber = [&](uint32_t typeIndex) -> uint32_t {
+            if (typeIndex < typeBegin) return typeIndex;
+            return typeIndex < typeEnd ? renumbered[typeIndex - typeBegin] : 0;
+        };
+
+        uint32_t recordBytes = 0;
+        std::vector<std::pair<uint32_t, uint32_t>> indexOffsets;
+        for (size_t i = 0; i < ordered.size(); ++i) {
+            const uint8_t* record = nullptr;
+            size_t size = 0;
+            types.GetRecord(ordered[i], record, size);
+
+            if (indexOffsets.empty() || recordBytes - indexOffsets.back().second >= TpiIndexOffsetInterval) {
+                indexOffsets.push_back({ FirstTypeIndex + static_cast<uint32_t>(i), recordBytes });
+            }
+            recordBytes += static_cast<uint32_t>(size);
+        }
+
+        {
+            MsfWriter writer(tempPath);
+            const uint32_t oldDirectoryStream = writer.ReserveStream();
+            const uint32_t infoStream = writer.ReserveStream();
+            const uint32_t tpiStream = writer.ReserveStream();
+            const uint32_t dbiStream = writer.ReserveStream();
+            const uint32_t ipiStream = writer.ReserveStream();
+            const uint32_t tpiHashStream = writer.ReserveStream();
+            const uint32_t ipiHashStream = writer.ReserveStream();
+            const uint32_t namesStream = writer.ReserveStream();
+            const uint32_t symbolRecordStream = writer.ReserveStream();
+            const uint32_t globalsStream = writer.ReserveStream();
+            const uint32_t publicsStream = writer.ReserveStream();
+            (void)oldDirectoryStream;
+
+            // Records are copied, renumbered and hashed in one pass as they are streamed out.
+            writer.BeginStream(tpiStream);
+            writer.WriteValue(MakeTpiHeader(static_cast<uint32_t>(ordered.size()), recordBytes, tpiHashStream,
+                static_cast<uint32_t>(indexOffsets.size())));
+
+            std::vector<uint32_t> hashes;
+            hashes.reserve(ordered.size());
+            std::vector<uint8_t> copy;
+
+            for (uint32_t typeIndex : ordered) {
+                const uint8_t* record = nullptr;
+                size_t size = 0;
+                uint16_t kind = 0;
+                types.GetRecord(typeIndex, record, size);
+                memcpy(&kind, record + sizeof(uint16_t), sizeof(kind));
+
+                copy.assign(record, record + size);
+                ForEachTypeReference(kind, copy.data() + 2 * sizeof(uint16_t), size - 2 * sizeof(uint16_t),
+                    [&](uint8_t* field, TypeUse) {
+                        uint32_t reference = 0;
+                        memcpy(&reference, field, sizeof(reference));
+                        reference = renumber(reference);
+                        memcpy(field, &reference, sizeof(reference));
+                    });
+
+                hashes.push_back(HashTypeRecord(kind, copy.data(), copy.size()));
+                writer.Write(copy.data(), copy.size());
+            }
+            writer.EndStream();
+
+            writer.BeginStream(tpiHashStream);
+            writer.Write(hashes.data(), hashes.size() * sizeof(uint32_t));
+            for (const auto& [indexOffset, byteOffset] : indexOffsets) {
+                writer.WriteValue(indexOffset);
+                writer.WriteValue(byteOffset);
+            }
+            writer.EndStream();
+
+            writer.BeginStream(ipiStream);
+            writer.WriteValue(MakeTpiHeader(0, 0, ipiHashStream, 0));
+            writer.EndStream();
+
+            // Symbol records: publics first, then globals with their types renumbered.
+            std::vector<uint8_t> records;
+            std::vector<GsiEntry> publicEntries, globalEntries;
+            std::vector<std::pair<std::pair<uint16_t, uint32_t>, uint32_t>> addressMap;
+
+            auto beginRecord = [&](CodeViewSymbolKind kind) {
+                size_t offset = records.size();
+                Append(records, uint16_t{ 0 });
+                Append(records, static_cast<uint16_t>(kind));
+                return offset;
+            };
+            auto endRecord = [&](size_t offset) {
+                AlignTo4(records);
+                uint16_t length = static_cast<uint16_t>(records.size() - offset - sizeof(uint16_t));
+                memcpy(records.data() + offset, &length, sizeof(length));
+            };
+
+            for (const auto& symbol : publics) {
+                size_t offset = beginRecord(CodeViewSymbolKind::S_PUB32);
+                Append(records, symbol.flags);
+                Append(records, symbol.offset);
+                Append(records, symbol.section);
+                AppendString(records, symbol.name);
+                endRecord(offset);
+
+                publicEntries.push_back({ symbol.name, static_cast<uint32_t>(offset), 0 });
+                addressMap.push_back({ { symbol.section, symbol.offset }, static_cast<uint32_t>(offset) });
+            }
+
+            for (const auto& symbol : globals) {
+                size_t offset = beginRecord(symbol.kind);
+                Append(records, renumber(symbol.type));
+                Append(records, symbol.offset);
+                Append(records, symbol.section);
+                AppendString(records, symbol.name);
+                endRecord(offset);
+
+                globalEntries.push_back({ symbol.name, static_cast<uint32_t>(offset), 0 });
+            }
+
+            writer.WriteStream(symbolRecordStream, records);
+            writer.WriteStream(globalsStream, BuildGsiHash(globalEntries));
+
+            std::vector<uint8_t> publicsHash = BuildGsiHash(publicEntries);
+            std::sort(addressMap.begin(), addressMap.end());
+
+            PublicsHeader publicsHeader{};
+            publicsHeader.symbolHashBytes = static_cast<uint32_t>(publicsHash.size());
+            publicsHeader.addressMapBytes = static_cast<uint32_t>(addressMap.size() * sizeof(uint32_t));
+
+            writer.BeginStream(publicsStream);
+            writer.WriteValue(publicsHeader);
+            writer.Write(publicsHash.data(), publicsHash.size());
+            for (const auto& entry : addressMap) {
+                writer.WriteValue(entry.second);
+            }
+            writer.EndStream();
+
+            // Section headers and, for a post-link-optimized image, both OMAPs and the original section
+            // headers the symbol records' section:offset pairs refer to; without them every address
+            // would land in the wrong place.
+            std::array<uint16_t, static_cast<size_t>(DebugStream::Count)> debugStreams;
+            debugStreams.fill(MsfReader::InvalidStream);
+            std::vector<uint8_t> sections, originalSections;
+            for (DebugStream slot : { DebugStream::OmapToSource, DebugStream::OmapFromSource,
+                DebugStream::SectionHeaders, DebugStream::OriginalSectionHeaders }) {
+                std::vector<uint8_t> data;
+                uint16_t source = symbols.GetDebugStream(slot);
+                if (source == MsfReader::InvalidStream || !msf->ReadStream(source, data)) continue;
+
+                uint16_t copy = static_cast<uint16_t>(writer.ReserveStream());
+                writer.WriteStream(copy, data);
+                debugStreams[static_cast<size_t>(slot)] = copy;
+                if (slot == DebugStream::SectionHeaders) sections = std::move(data);
+                if (slot == DebugStream::OriginalSectionHeaders) originalSections = std::move(data);
+            }
+
+            // The section map describes the sections symbol records are numbered against.
+            const std::vector<uint8_t>& mapSections =
+                debugStreams[static_cast<size_t>(DebugStream::OmapFromSource)] != MsfReader::InvalidStream &&
+                !originalSections.empty() ? originalSections : sections;
+
+            std::vector<uint8_t> stringTable = BuildEmptyStringTable();
+            writer.WriteStream(namesStream, stringTable);
+
+            // DBI: a single "* Linker *" module with no symbols, no section contributions, a section map
+            // built from the section headers and a debug header pointing at the copied streams.
+            std::vector<uint8_t> moduleInfo;
+            ModuleInfoHeader module{};
+            module.section = 0xFFFF;
+            module.moduleIndex = 0xFFFF;
+            module.moduleSymbolStream = MsfReader::InvalidStream;
+            Append(moduleInfo, module);
+            AppendString(moduleInfo, "* Linker *");
+            AppendString(moduleInfo, "");
+            AlignTo4(moduleInfo);
+
+            std::vector<uint8_t> sectionContributions;
+            Append(sectionContributions, SectionContributionVersion);
+
+            uint16_t sectionCount = static_cast<uint16_t>(mapSections.size() / SectionHeaderSize);
+            std::vector<uint8_t> sectionMap;
+            Append(sectionMap, static_cast<uint16_t>(sectionCount + 1));
+            Append(sectionMap, static_cast<uint16_t>(sectionCount + 1));
+            for (uint16_t i = 0; i < sectionCount; ++i) {
+                uint32_t virtualSize = 0, characteristics = 0;
+                memcpy(&virtualSize, mapSections.data() + i * SectionHeaderSize + SectionVirtualSizeOffset, sizeof(virtualSize));
+                memcpy(&characteristics, mapSections.data() + i * SectionHeaderSize + SectionCharacteristicsOffset, sizeof(characteristics));
+
+                SectionMapEntry entry{};
+                entry.flags = 0x0108;
+                if (characteristics & IMAGE_SCN_MEM_READ) entry.flags |= 0x0001;
+                if (characteristics & IMAGE_SCN_MEM_WRITE) entry.flags |= 0x0002;
+                if (characteristics & IMAGE_SCN_MEM_EXECUTE) entry.flags |= 0x0004;
+                entry.frame = static_cast<uint16_t>(i + 1);
+                entry.sectionName = 0xFFFF;
+                entry.className = 0xFFFF;
+                entry.sectionLength = virtualSize;
+                Append(sectionMap, entry);
+            }
+            SectionMapEntry absolute{};
+            absolute.flags = 0x0208;
+            absolute.frame = static_cast<uint16_t>(sectionCount + 1);
+            absolute.sectionName = 0xFFFF;
+            absolute.className = 0xFFFF;
+            absolute.sectionLength = UINT32_MAX;
+            Append(sectionMap, absolute);
+
+            std::vector<uint8_t> fileInfo;
+            Append(fileInfo, uint16_t{ 1 });
+            Append(fileInfo, uint16_t{ 0 });
+            Append(fileInfo, uint16_t{ 0 });
+            Append(fileInfo, uint16_t{ 0 });
+
+            std::vector<uint8_t> debugHeader;
+            for (uint16_t stream : debugStreams) {
+                Append(debugHeader, stream);
+            }
+
+            DbiHeader dbi{};
+            dbi.versionSignature = -1;
+            dbi.versionHeader = DbiVersion;
+            dbi.age = age;
+            dbi.globalStreamIndex = static_cast<uint16_t>(globalsStream);
+            dbi.buildNumber = DbiBuildNumber;
+            dbi.publicStreamIndex = static_cast<uint16_t>(publicsStream);
+            dbi.symbolRecordStream = static_cast<uint16_t>(symbolRecordStream);
+            dbi.moduleInfoSize = static_cast<int32_t>(moduleInfo.size());
+            dbi.sectionContributionSize = static_cast<int32_t>(sectionContributions.size());
+            dbi.sectionMapSize = static_cast<int32_t>(sectionMap.size());
+            dbi.sourceInfoSize = static_cast<int32_t>(fileInfo.size());
+            dbi.optionalDbgHeaderSize = static_cast<int32_t>(debugHeader.size());
+            dbi.ecSubstreamSize = static_cast<int32_t>(stringTable.size());
+            dbi.machine = symbols.GetMachine();
+
+            writer.BeginStream(dbiStream);
+            writer.WriteValue(dbi);
+            for (const auto* substream : { &moduleInfo, &sectionContributions, &sectionMap, &fileInfo, &stringTable, &debugHeader }) {
+                writer.Write(substream->data(), substream->size());
+            }
+            writer.EndStream();
+
+            // PDB info: the source header (version, timestamp, age, GUID), a named stream map holding
+            // only /names, and the VC140 feature code announcing the IPI stream.
+            const char namesKey[] = "/names";
+            uint32_t bucket = static_cast<uint16_t>(GsiHashTable::HashName(namesKey)) % NamedStreamMapCapacity;
+
+            writer.BeginStream(infoStream);
+            writer.Write(info.data(), PdbInfoHeaderSize);
+            writer.WriteValue(static_cast<uint32_t>(sizeof(namesKey)));
+            writer.Write(namesKey, sizeof(namesKey));
+            writer.WriteValue(uint32_t{ 1 });
+            writer.WriteValue(NamedStreamMapCapacity);
+            writer.WriteValue(uint32_t{ 1 });
+            writer.WriteValue(1u << bucket);
+            writer.WriteValue(uint32_t{ 0 });
+            writer.WriteValue(uint32_t{ 0 });
+            writer.WriteValue(namesStream);
+            writer.WriteValue(uint32_t{ 0 });
+            writer.WriteValue(PdbImplVC140);
+            writer.EndStream();
+
+            if (!writer.Close()) {
+                DeleteFileW(tempPath.c_str());
+                return false;
+            }
+        }
+
+        if (!MoveFileExW(tempPath.c_str(), outputPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+            return false;
+        }
+
+        stats.publics = publics.size();
+        stats.globals = globals.size();
+        stats.sourceTypes = types.GetTypeCount();
+        stats.types = ordered.size();
+        stats.sourceBytes = std::filesystem::file_size(sourcePath);
+        stats.outputBytes = std::filesystem::file_size(outputPath);
+        stats.wallUs = ElapsedUs(start);
+        return true;
+    }
+    catch (...) {
+        DeleteFileW(tempPath.c_str());
+        return false;
+    }
+}
+
+void ReducedPdbWriter::PrintStats(const ReducedPdbStats& stats) {
+    std::cout << "Publics: " << stats.publics << ", globals: " << stats.globals << ", UDTs: " << stats.udts << "\n";
+    std::cout << "Types kept: " << stats.types << " of " << stats.sourceTypes;
+    if (stats.unknownTypes) {
+        std::cout << " (" << stats.unknownTypes << " of unknown layout written as T_NOTYPE)";
+    }
+    std::cout << "\n";
+
+    if (!stats.missing.empty()) {
+        std::cout << "Not found (" << stats.missing.size() << "):";
+        for (const auto& name : stats.missing) {
+            std::cout << " " << name;
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "Size: " << stats.sourceBytes / 1024 << "KB -> " << stats.outputBytes / 1024 << "KB\n";
+    std::cout << "Wall time: " << stats.wallUs / 1000 << "ms\n";
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ReducedPdbStats {
+    size_t publics = 0;
+    size_t globals = 0;
+    size_t udts = 0;
+    size_t sourceTypes = 0;
+    size_t types = 0;
+    size_t unknownTypes = 0;
+    std::vector<std::string> missing;
+    uint64_t sourceBytes = 0;
+    uint64_t outputBytes = 0;
+    uint64_t wallUs = 0;
+};
+
+// Writes a PDB holding only the named publics, globals and UDTs of a source PDB. Each name is looked
+// up as an exact public, a global and a UDT; every type they reach is copied with its type indices
+// renumbered into a dense TPI stream. Forward references reached by value (members, bases, array
+// elements) bring their definitions along, those reached through pointers stay forward references.
+// The output keeps the source GUID and age, so it still matches the image it describes.
+class ReducedPdbWriter {
+public:
+    static bool Write(const std::wstring& sourcePath, const std::wstring& outputPath,
+        const std::vector<std::string>& names, ReducedPdbStats& stats);
+    static void PrintStats(const ReducedPdbStats& stats);
+};
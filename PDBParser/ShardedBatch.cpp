@@ -0,0 +1,373 @@
+#include "ShardedBatch.h"
+#include "BatchUtil.h"
+#include "MsfReader.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    const char ManifestHeader[] = "# PDBParser shard manifest 1";
+    const wchar_t ManifestName[] = L"shard.manifest";
+    const wchar_t ShardIndexName[] = L"shard.pdbx";
+
+    struct ShardPdb {
+        std::string path;
+        std::string signature;
+        std::string status;
+        size_t symbols = 0;
+        size_t structures = 0;
+        std::string output;
+    };
+
+    struct LoadedShard {
+        std::wstring directory;
+        ShardSpec spec;
+        std::string input;
+        std::vector<ShardPdb> pdbs;
+    };
+
+    // Tab-separated, one record per line: "shard", "input" and "index" describe the partition, each
+    // "pdb" line is signature (- if unreadable), status, symbol and structure counts, output file
+    // (- if none) and the PDB's path.
+    bool WriteManifest(const std::wstring& manifestPath, const ShardSpec& spec, const std::string& input,
+        const std::vector<ShardPdb>& pdbs) {
+        std::wstring tempPath = manifestPath + L".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::trunc);
+            if (!file.is_open()) return false;
+
+            file << ManifestHeader << "\n";
+            file << "shard\t" << spec.index << '\t' << spec.count << "\n";
+            file << "input\t" << input << "\n";
+            file << "partition\tfnv1a64(guid+age) mod count\n";
+            file << "index\t" << WStringToString(ShardIndexName) << "\n";
+            for (const auto& pdb : pdbs) {
+                file << "pdb\t" << (pdb.signature.empty() ? "-" : pdb.signature) << '\t' << pdb.status << '\t'
+                    << pdb.symbols << '\t' << pdb.structures << '\t' << (pdb.output.empty() ? "-" : pdb.output) << '\t'
+                    << pdb.path << "\n";
+            }
+            if (file.fail()) return false;
+        }
+
+        if (!MoveFileExW(tempPath.c_str(), manifestPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool ReadManifest(const std::wstring& directory, LoadedShard& shard) {
+        std::ifstream file(std::filesystem::path(directory) / ManifestName);
+        std::string line;
+        if (!file.is_open() || !std::getline(file, line) || line != ManifestHeader) return false;
+
+        bool haveSpec = false;
+        while (std::getline(file, line)) {
+            std::vector<std::string> fields;
+            std::istringstream stream(line);
+            for (std::string field; std::getline(stream, field, '\t');) {
+                fields.push_back(std::move(field));
+            }
+            if (fields.empty()) continue;
+
+            if (fields[0] == "shard" && fields.size() == 3) {
+                shard.spec.index = static_cast<uint32_t>(std::strtoul(fields[1].c_str(), nullptr, 10));
+                shard.spec.count = static_cast<uint32_t>(std::strtoul(fields[2].c_str(), nullptr, 10));
+                haveSpec = shard.spec.count != 0 && shard.spec.index < shard.spec.count;
+            }
+            else if (fields[0] == "input" && fields.size() == 2) {
+                shard.input = fields[1];
+            }
+            else if (fields[0] == "pdb" && fields.size() == 7) {
+                ShardPdb pdb;
+                pdb.signature = fields[1] == "-" ? std::string() : fields[1];
+                pdb.status = fields[2];
+                pdb.symbols = std::strtoull(fields[3].c_str(), nullptr, 10);
+                pdb.structures = std::strtoull(fields[4].c_str(), nullptr, 10);
+                pdb.output = fields[5] == "-" ? std::string() : fields[5];
+                pdb.path = fields[6];
+                shard.pdbs.push_back(std::move(pdb));
+            }
+        }
+
+        shard.directory = directory;
+        return haveSpec;
+    }
+}
+
+std::optional<ShardSpec> ShardSpec::Parse(const std::wstring& text) {
+    size_t slash = text.find(L'/');
+    if (slash == std::wstring::npos || slash == 0 || slash + 1 == text.size()) return std::nullopt;
+
+    wchar_t* end = nullptr;
+    unsigned long index = std::wcstoul(text.c_str(), &end, 10);
+    if (end != text.c_str() + slash) return std::nullopt;
+
+    unsigned long count = std::wcstoul(text.c_str() + slash + 1, &end, 10);
+    if (*end != L'\0' || count == 0 || index >= count) return std::nullopt;
+
+    return ShardSpec{ static_cast<uint32_t>(index), static_cast<uint32_t>(count) };
+}
+
+std::wstring ShardSpec::GetDirectoryName() const {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "shard-%03u-of-%03u", index, count);
+    return std::wstring(buffer, buffer + strlen(buffer));
+}
+
+uint32_t ShardedBatch::AssignShard(const std::string& partitionKey, uint32_t shardCount) noexcept {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : partitionKey) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return shardCount ? static_cast<uint32_t>(hash % shardCount) : 0;
+}
+
+ShardStats ShardedBatch::RunShard(const std::wstring& directory, const std::wstring& outputDir, const ShardSpec& shard,
+    size_t threads) {
+    auto start = std::chrono::steady_clock::now();
+    ShardStats stats;
+
+    std::vector<std::wstring> files;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_regular_file(error) && IsPdbFile(it->path())) {
+            files.push_back(it->path().wstring());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    stats.pdbsFound = files.size();
+
+    // Partitioning reads only the MSF directory and PDB info stream of each file.
+    std::vector<std::optional<PdbSignature>> signatures(files.size());
+    RunParallel(files.size(), threads, [&](size_t i) {
+        try {
+            MsfReader msf(files[i]);
+            signatures[i] = PdbSignature::Read(msf);
+        }
+        catch (...) {
+        }
+        });
+
+    std::vector<StoreIndexEntry> entries;
+    std::vector<ShardPdb> pdbs;
+    for (size_t i = 0; i < files.size(); ++i) {
+        // Files without a readable signature still need exactly one owner; their name decides it.
+        std::string signature = signatures[i] ? signatures[i]->ToString() : std::string();
+        std::string key = signature.empty()
+            ? "unreadable:" + WStringToString(std::filesystem::path(files[i]).filename().wstring())
+            : signature;
+        if (AssignShard(key, shard.count) != shard.index) continue;
+
+        ShardPdb pdb;
+        pdb.path = WStringToString(files[i]);
+        pdb.signature = signature;
+        pdb.status = signature.empty() ? "unreadable" : "failed";
+        pdbs.push_back(std::move(pdb));
+
+        StoreIndexEntry entry;
+        entry.path = files[i];
+        if (signatures[i]) entry.signature = *signatures[i];
+        entries.push_back(std::move(entry));
+    }
+    stats.pdbsInShard = pdbs.size();
+
+    std::filesystem::path shardDir = std::filesystem::path(outputDir) / shard.GetDirectoryName();
+    std::filesystem::create_directories(shardDir);
+
+    // A rerun first withdraws the old manifest, so a run stopped halfway never looks finished.
+    std::wstring manifestPath = (shardDir / ManifestName).wstring();
+    std::filesystem::remove(manifestPath, error);
+
+    RunParallel(pdbs.size(), threads, [&](size_t i) {
+        ShardPdb& pdb = pdbs[i];
+        if (pdb.signature.empty()) return;
+
+        try {
+            // One parse per PDB: the index terms come from the parser that just wrote the JSON.
+            PdbParser parser(entries[i].path);
+            if (!parser.IsInitialized()) return;
+
+            std::wstring output = std::filesystem::path(entries[i].path).stem().wstring() + L"_analysis.json";
+            if (!parser.DumpToJson((shardDir / output).wstring())) return;
+
+            StoreIndexer::Collect(parser, entries[i]);
+            pdb.symbols = entries[i].symbols.size();
+            pdb.structures = entries[i].types.size();
+            pdb.output = WStringToString(output);
+            pdb.status = "ok";
+        }
+        catch (...) {
+        }
+        });
+
+    std::vector<StoreIndexEntry> indexed;
+    for (size_t i = 0; i < pdbs.size(); ++i) {
+        if (pdbs[i].status == "ok") {
+            indexed.push_back(std::move(entries[i]));
+            stats.processed++;
+        }
+        else {
+            stats.failed++;
+        }
+    }
+
+    stats.index = StoreIndexer::Write(std::move(indexed), (shardDir / ShardIndexName).wstring());
+
+    std::string input = WStringToString(std::filesystem::absolute(directory, error).wstring());
+    if (!WriteManifest(manifestPath, shard, input, pdbs)) {
+        throw std::runtime_error("Failed to write shard manifest");
+    }
+
+    stats.wallUs = ElapsedUs(start);
+    return stats;
+}
+
+MergeStats ShardedBatch::Merge(const std::vector<std::wstring>& shardDirs, const std::wstring& outputDir) {
+    auto start = std::chrono::steady_clock::now();
+    MergeStats stats;
+
+    std::vector<LoadedShard> shards;
+    std::vector<bool> seen;
+    for (const auto& directory : shardDirs) {
+        LoadedShard shard;
+        if (!ReadManifest(directory, shard)) {
+            stats.rejectedDirectories.push_back(directory);
+            continue;
+        }
+
+        if (shards.empty()) {
+            stats.shardCount = shard.spec.count;
+            seen.assign(shard.spec.count, false);
+        }
+        if (shard.spec.count != stats.shardCount || seen[shard.spec.index]) {
+            stats.rejectedDirectories.push_back(directory);
+            continue;
+        }
+
+        seen[shard.spec.index] = true;
+        shards.push_back(std::move(shard));
+    }
+
+    for (uint32_t i = 0; i < stats.shardCount; ++i) {
+        if (!seen[i]) stats.missingShards.push_back(i);
+    }
+    std::sort(shards.begin(), shards.end(),
+        [](const LoadedShard& a, const LoadedShard& b) { return a.spec.index < b.spec.index; });
+    stats.shardsMerged = shards.size();
+
+    std::filesystem::create_directories(outputDir);
+
+    std::vector<std::wstring> indexPaths;
+    for (const auto& shard : shards) {
+        std::filesystem::path indexPath = std::filesystem::path(shard.directory) / ShardIndexName;
+        std::error_code error;
+        if (std::filesystem::exists(indexPath, error)) indexPaths.push_back(indexPath.wstring());
+    }
+    stats.index = StoreIndexer::Merge(indexPaths, (std::filesystem::path(outputDir) / L"store.pdbx").wstring());
+
+    // The same build under several names is legal (each copy is processed) but usually worth knowing.
+    std::map<std::string, std::vector<std::string>> pathsBySignature;
+    for (const auto& shard : shards) {
+        for (const auto& pdb : shard.pdbs) {
+            stats.pdbs++;
+            if (pdb.status != "ok") stats.failed++;
+            if (!pdb.signature.empty()) pathsBySignature[pdb.signature].push_back(pdb.path);
+        }
+    }
+
+    {
+        std::ofstream summary(std::filesystem::path(outputDir) / L"summary.json", std::ios::trunc);
+        if (!summary.is_open()) throw std::runtime_error("Failed to create merged summary");
+
+        summary << "{\n  \"summary\": {\n";
+        summary << "    \"total_files\": " << stats.pdbs << ",\n";
+        summary << "    \"shard_count\": " << stats.shardCount << ",\n";
+        summary << "    \"shards_merged\": " << stats.shardsMerged << ",\n";
+        summary << "    \"processed\": [";
+
+        bool first = true;
+        for (const auto& shard : shards) {
+            std::string shardDir = WStringToString(shard.directory);
+            for (const auto& pdb : shard.pdbs) {
+                summary << (first ? "\n" : ",\n") << "      { \"file\": ";
+                WriteJsonString(summary, pdb.path);
+                summary << ", \"signature\": ";
+                WriteJsonString(summary, pdb.signature);
+                summary << ", \"shard\": " << shard.spec.index << ", \"status\": ";
+                WriteJsonString(summary, pdb.status);
+                summary << ", \"output\": ";
+                WriteJsonString(summary, pdb.output.empty() ? std::string() : shardDir + "\\" + pdb.output);
+                summary << ", \"symbols\": " << pdb.symbols << ", \"structures\": " << pdb.structures << " }";
+                first = false;
+            }
+        }
+        summary << "\n    ]\n  }\n}\n";
+    }
+
+    std::ofstream report(std::filesystem::path(outputDir) / L"merge_report.txt", std::ios::trunc);
+    report << "Shards merged: " << stats.shardsMerged << " of " << stats.shardCount << "\n";
+    for (uint32_t missing : stats.missingShards) {
+        report << "Missing shard: " << missing << "/" << stats.shardCount << "\n";
+    }
+    for (const auto& rejected : stats.rejectedDirectories) {
+        report << "Rejected (no manifest, other shard count or repeated shard): " << WStringToString(rejected) << "\n";
+    }
+    for (size_t i = 1; i < shards.size(); ++i) {
+        if (shards[i].input != shards[0].input) {
+            report << "Shard " << shards[i].spec.index << " read " << shards[i].input << " (shard "
+                << shards[0].spec.index << " read " << shards[0].input << ")\n";
+        }
+    }
+    for (const auto& shard : shards) {
+        for (const auto& pdb : shard.pdbs) {
+            if (pdb.status != "ok") report << "Not processed (" << pdb.status << "): " << pdb.path << "\n";
+        }
+    }
+    for (const auto& [signature, paths] : pathsBySignature) {
+        if (paths.size() < 2) continue;
+
+        stats.duplicates += paths.size() - 1;
+        report << "Same build " << signature << ":";
+        for (const auto& path : paths) report << " " << path;
+        report << "\n";
+    }
+
+    stats.wallUs = ElapsedUs(start);
+    return stats;
+}
+
+void ShardedBatch::PrintStats(const ShardStats& stats) {
+    std::cout << "PDBs in input:   " << stats.pdbsFound << "\n";
+    std::cout << "In this shard:   " << stats.pdbsInShard << "\n";
+    std::cout << "Processed:       " << stats.processed << " (" << stats.failed << " failed)\n";
+    std::cout << "Shard index:     " << stats.index.pdbsIndexed << " PDBs, " << stats.index.termCount << " terms, "
+        << stats.index.postingCount << " postings\n";
+    std::cout << "Wall time:       " << stats.wallUs / 1000 << "ms\n";
+}
+
+void ShardedBatch::PrintStats(const MergeStats& stats) {
+    std::cout << "Shards merged:   " << stats.shardsMerged << " of " << stats.shardCount << "\n";
+    if (!stats.missingShards.empty()) {
+        std::cout << "Missing shards: ";
+        for (uint32_t missing : stats.missingShards) std::cout << " " << missing;
+        std::cout << "\n";
+    }
+    if (!stats.rejectedDirectories.empty()) {
+        std::cout << "Rejected:        " << stats.rejectedDirectories.size() << " directories\n";
+    }
+    std::cout << "PDBs:            " << stats.pdbs << " (" << stats.failed << " failed, "
+        << stats.duplicates << " duplicate builds)\n";
+    std::cout << "Merged index:    " << stats.index.pdbsReused << " PDBs, " << stats.index.termCount << " terms, "
+        << stats.index.postingCount << " postings, " << stats.index.indexBytes / 1024 << "KB\n";
+    std::cout << "Wall time:       " << stats.wallUs / 1000 << "ms\n";
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "StoreIndex.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Shard index of count, written "index/count" on the command line and zero-based.
+struct ShardSpec {
+    uint32_t index = 0;
+    uint32_t count = 1;
+
+    static std::optional<ShardSpec> Parse(const std::wstring& text);
+    // "shard-003-of-016", the directory a shard writes under its output directory.
+    std::wstring GetDirectoryName() const;
+};
+
+struct ShardStats {
+    size_t pdbsFound = 0;
+    size_t pdbsInShard = 0;
+    size_t processed = 0;
+    size_t failed = 0;
+    StoreIndexStats index;
+    uint64_t wallUs = 0;
+};
+
+struct MergeStats {
+    uint32_t shardCount = 0;
+    size_t shardsMerged = 0;
+    std::vector<uint32_t> missingShards;
+    std::vector<std::wstring> rejectedDirectories;
+    size_t pdbs = 0;
+    size_t failed = 0;
+    size_t duplicates = 0;
+    StoreIndexStats index;
+    uint64_t wallUs = 0;
+};
+
+// -batch split across processes or machines. Every PDB in the input directory is assigned to a shard
+// by a hash of its GUID+age, so the split does not depend on enumeration order, file names or which
+// node lists the directory, and copies of one build always land in the same shard. A shard writes
+// the usual per-PDB JSON, a store index over its PDBs and, last, shard.manifest describing the
+// partition and every PDB it handled; a directory without the manifest is an unfinished shard.
+class ShardedBatch {
+public:
+    static uint32_t AssignShard(const std::string& partitionKey, uint32_t shardCount) noexcept;
+
+    static ShardStats RunShard(const std::wstring& directory, const std::wstring& outputDir, const ShardSpec& shard,
+        size_t threads = 0);
+    // Checks that the shard directories form one complete partition, then writes summary.json,
+    // store.pdbx and merge_report.txt to the output directory. Directories without a manifest, with
+    // a shard count other than the first shard's, or repeating a shard already merged are rejected.
+    // Missing and rejected shards are reported, not fatal.
+    static MergeStats Merge(const std::vector<std::wstring>& shardDirs, const std::wstring& outputDir);
+
+    static void PrintStats(const ShardStats& stats);
+    static void PrintStats(const MergeStats& stats);
+};
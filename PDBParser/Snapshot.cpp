@@ -0,0 +1,257 @@
+#include "Snapshot.h"
+#include "TableWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    const char SnapshotMagic[4] = { 'P', 'D', 'B', 'S' };
+    constexpr uint16_t SnapshotVersion = 3;
+
+    constexpr uint32_t PdbInfoStream = 1;
+    constexpr size_t PdbInfoAgeOffset = 8;
+    constexpr size_t PdbInfoGuidOffset = 12;
+
+    constexpr size_t TableEntrySizes[] = {
+        sizeof(SnapshotSymbol),
+        sizeof(SnapshotStruct),
+        sizeof(SnapshotMember),
+        sizeof(SnapshotEnum),
+        sizeof(SnapshotEnumValue),
+        sizeof(SnapshotLayoutHash),
+        sizeof(char)
+    };
+
+    static_assert(std::size(TableEntrySizes) == static_cast<size_t>(SnapshotTable::Count), "table sizes out of sync");
+}
+
+bool PdbSignature::operator==(const PdbSignature& other) const noexcept {
+    return age == other.age && memcmp(guid, other.guid, sizeof(guid)) == 0;
+}
+
+std::string PdbSignature::ToString() const {
+    uint32_t data1 = 0;
+    uint16_t data2 = 0, data3 = 0;
+    memcpy(&data1, guid, sizeof(data1));
+    memcpy(&data2, guid + 4, sizeof(data2));
+    memcpy(&data3, guid + 6, sizeof(data3));
+
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%08X%04X%04X%02X%02X%02X%02X%02X%02X%02X%02X%X",
+        data1, data2, data3, guid[8], guid[9], guid[10], guid[11], guid[12], guid[13], guid[14], guid[15], age);
+    return buffer;
+}
+
+std::optional<PdbSignature> PdbSignature::Read(const MsfReader& msf) {
+    std::vector<uint8_t> info;
+    if (!msf.ReadStream(PdbInfoStream, info) || info.size() < PdbInfoGuidOffset + sizeof(PdbSignature::guid)) {
+        return std::nullopt;
+    }
+
+    PdbSignature signature{};
+    memcpy(&signature.age, info.data() + PdbInfoAgeOffset, sizeof(signature.age));
+    memcpy(signature.guid, info.data() + PdbInfoGuidOffset, sizeof(signature.guid));
+    return signature;
+}
+
+SnapshotString SnapshotBuilder::Intern(std::string_view value) {
+    auto it = m_interned.find(std::string(value));
+    if (it != m_interned.end()) {
+        return it->second;
+    }
+
+    SnapshotString result{ static_cast<uint32_t>(m_strings.size()), static_cast<uint32_t>(value.size()) };
+    m_strings.insert(m_strings.end(), value.begin(), value.end());
+    m_interned.emplace(std::string(value), result);
+    return result;
+}
+
+std::string_view SnapshotBuilder::GetString(const SnapshotString& value) const noexcept {
+    return std::string_view(m_strings.data() + value.offset, value.length);
+}
+
+template<typename T>
+void SnapshotBuilder::SortByName(std::vector<T>& entries) const {
+    std::stable_sort(entries.begin(), entries.end(),
+        [&](const T& a, const T& b) { return GetString(a.name) < GetString(b.name); });
+
+    // Lookups return the first match, so later duplicates are dead weight.
+    entries.erase(std::unique(entries.begin(), entries.end(),
+        [&](const T& a, const T& b) { return GetString(a.name) == GetString(b.name); }), entries.end());
+}
+
+void SnapshotBuilder::AddSymbol(std::string_view name, uint64_t rva) {
+    m_symbols.push_back(SnapshotSymbol{ Intern(name), rva });
+}
+
+void SnapshotBuilder::AddStruct(std::string_view name, uint64_t size, bool isUnion) {
+    SnapshotStruct entry{};
+    entry.name = Intern(name);
+    entry.size = size;
+    entry.firstMember = static_cast<uint32_t>(m_members.size());
+    entry.flags = isUnion ? SnapshotStructUnion : 0;
+    m_structs.push_back(entry);
+}
+
+void SnapshotBuilder::AddMember(std::string_view name, uint64_t offset, uint64_t size, uint32_t typeId, std::string_view typeName,
+    uint64_t elementSize, uint32_t elementCount, uint32_t bitPosition, uint32_t bitLength, bool isPointer) {
+    if (m_structs.empty()) return;
+
+    SnapshotMember member{};
+    member.name = Intern(name);
+    member.offset = offset;
+    member.size = size;
+    member.typeId = typeId;
+    member.elementCount = elementCount;
+    member.typeName = Intern(typeName);
+    member.elementSize = elementSize;
+    member.bitPosition = static_cast<uint8_t>(bitPosition);
+    member.bitLength = static_cast<uint8_t>(bitLength);
+    member.flags = isPointer ? SnapshotMemberPointer : 0;
+    m_members.push_back(member);
+    m_structs.back().memberCount++;
+}
+
+void SnapshotBuilder::AddEnum(std::string_view name, uint64_t size) {
+    m_enums.push_back(SnapshotEnum{ Intern(name), size, static_cast<uint32_t>(m_enumValues.size()), 0 });
+}
+
+void SnapshotBuilder::AddEnumValue(std::string_view name, int64_t value) {
+    if (m_enums.empty()) return;
+    m_enumValues.push_back(SnapshotEnumValue{ Intern(name), value });
+    m_enums.back().valueCount++;
+}
+
+void SnapshotBuilder::AddLayoutHash(std::string_view name, uint64_t high, uint64_t low) {
+    m_layoutHashes.push_back(SnapshotLayoutHash{ Intern(name), high, low });
+}
+
+bool SnapshotBuilder::Write(const std::wstring& outputPath, const PdbSignature& signature) {
+    try {
+        // Struct and enum rows keep their member ranges, so only the rows themselves are reordered.
+        SortByName(m_symbols);
+        SortByName(m_structs);
+        SortByName(m_enums);
+        SortByName(m_layoutHashes);
+
+        const size_t counts[] = {
+            m_symbols.size(), m_structs.size(), m_members.size(), m_enums.size(),
+            m_enumValues.size(), m_layoutHashes.size(), m_strings.size()
+        };
+
+        SnapshotFileHeader header{};
+        memcpy(header.magic, SnapshotMagic, sizeof(header.magic));
+        header.version = SnapshotVersion;
+        header.tableCount = static_cast<uint16_t>(SnapshotTable::Count);
+        header.signature = signature;
+
+        SnapshotTableHeader tables[static_cast<size_t>(SnapshotTable::Count)] = {};
+        uint64_t position = sizeof(header) + sizeof(tables);
+        for (size_t i = 0; i < std::size(tables); ++i) {
+            position = AlignUp(position);
+            tables[i].offset = position;
+            tables[i].count = counts[i];
+            position += counts[i] * TableEntrySizes[i];
+        }
+        header.fileSize = position;
+
+        // Written under a temporary name and renamed, so readers never map a half-written snapshot.
+        std::wstring tempPath = outputPath + L".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(tables), sizeof(tables));
+
+            position = sizeof(header) + sizeof(tables);
+            WriteTable(file, position, m_symbols);
+            WriteTable(file, position, m_structs);
+            WriteTable(file, position, m_members);
+            WriteTable(file, position, m_enums);
+            WriteTable(file, position, m_enumValues);
+            WriteTable(file, position, m_layoutHashes);
+            WriteTable(file, position, m_strings);
+
+            if (!file.good()) return false;
+        }
+
+        if (!MoveFileExW(tempPath.c_str(), outputPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+Snapshot::Snapshot(const std::wstring& snapshotPath)
+    : m_file(snapshotPath), m_pBase(m_file.GetData()), m_fileSize(m_file.GetSize()) {
+    if (m_fileSize < sizeof(SnapshotFileHeader) + sizeof(SnapshotTableHeader) * static_cast<size_t>(SnapshotTable::Count)) {
+        throw std::runtime_error("Snapshot file is too small");
+    }
+
+    m_header = reinterpret_cast<const SnapshotFileHeader*>(m_pBase);
+    m_tables = reinterpret_cast<const SnapshotTableHeader*>(m_pBase + sizeof(SnapshotFileHeader));
+
+    if (!Validate()) {
+        throw std::runtime_error("Not a compatible snapshot file");
+    }
+}
+
+bool Snapshot::Validate() const noexcept {
+    if (memcmp(m_header->magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0 ||
+        m_header->version != SnapshotVersion ||
+        m_header->tableCount != static_cast<uint16_t>(SnapshotTable::Count) ||
+        m_header->fileSize != m_fileSize) {
+        return false;
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(SnapshotTable::Count); ++i) {
+        const auto& table = m_tables[i];
+        if (table.offset % 8 != 0 || table.offset > m_fileSize ||
+            table.count > (m_fileSize - table.offset) / TableEntrySizes[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string_view Snapshot::GetString(const SnapshotString& value) const noexcept {
+    size_t poolSize = 0;
+    const char* pool = GetTable<char>(SnapshotTable::Strings, poolSize);
+    if (value.offset > poolSize || value.length > poolSize - value.offset) return {};
+    return std::string_view(pool + value.offset, value.length);
+}
+
+template<typename T>
+const T* Snapshot::Find(SnapshotTable table, std::string_view name) const noexcept {
+    size_t count = 0;
+    const T* entries = GetTable<T>(table, count);
+
+    const T* it = std::lower_bound(entries, entries + count, name,
+        [&](const T& entry, std::string_view key) { return GetString(entry.name) < key; });
+
+    return (it != entries + count && GetString(it->name) == name) ? it : nullptr;
+}
+
+const SnapshotSymbol* Snapshot::FindSymbol(std::string_view name) const noexcept {
+    return Find<SnapshotSymbol>(SnapshotTable::Symbols, name);
+}
+
+const SnapshotStruct* Snapshot::FindStruct(std::string_view name) const noexcept {
+    return Find<SnapshotStruct>(SnapshotTable::Structs, name);
+}
+
+const SnapshotEnum* Snapshot::FindEnum(std::string_view name) const noexcept {
+    return Find<SnapshotEnum>(SnapshotTable::Enums, name);
+}
+
+const SnapshotLayoutHash* Snapshot::FindLayoutHash(std::string_view name) const noexcept {
+    return Find<SnapshotLayoutHash>(SnapshotTable::LayoutHashes, name);
+}
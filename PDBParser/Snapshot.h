@@ -0,0 +1,181 @@
+#pragma once
+#include "MsfReader.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// PDBS snapshot layout (all integers little-endian, every table 8-byte aligned, no pointers):
+//
+//   SnapshotFileHeader
+//   SnapshotTableHeader[SnapshotTable::Count]
+//   symbol, struct, member, enum, enum value and layout hash tables, each sorted by name
+//   string pool: UTF-8 bytes referenced by (offset, length) pairs
+//
+// The file is mapped read-only and queried in place, so loading is a header check independent of
+// PDB size and every process mapping the same snapshot shares its pages.
+
+enum class SnapshotTable : uint16_t {
+    Symbols,
+    Structs,
+    Members,
+    Enums,
+    EnumValues,
+    LayoutHashes,
+    Strings,
+    Count
+};
+
+#pragma pack(push, 1)
+struct PdbSignature {
+    uint8_t guid[16];
+    uint32_t age;
+
+    bool operator==(const PdbSignature& other) const noexcept;
+    bool operator!=(const PdbSignature& other) const noexcept { return !(*this == other); }
+
+    // GUID and age in the form symbol stores file the PDB under.
+    std::string ToString() const;
+
+    static std::optional<PdbSignature> Read(const MsfReader& msf);
+};
+
+struct SnapshotFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t tableCount;
+    PdbSignature signature;
+    uint32_t reserved;
+    uint64_t fileSize;
+};
+
+struct SnapshotTableHeader {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotSymbol {
+    SnapshotString name;
+    uint64_t rva;
+};
+
+constexpr uint8_t SnapshotStructUnion = 0x01;
+
+struct SnapshotStruct {
+    SnapshotString name;
+    uint64_t size;
+    uint32_t firstMember;
+    uint32_t memberCount;
+    uint8_t flags;
+    uint8_t reserved[7];
+};
+
+constexpr uint8_t SnapshotMemberPointer = 0x01;
+
+struct SnapshotMember {
+    SnapshotString name;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t typeId;
+    uint32_t elementCount;
+    SnapshotString typeName;
+    uint64_t elementSize;
+    uint8_t bitPosition;
+    uint8_t bitLength;
+    uint8_t flags;
+    uint8_t reserved[5];
+};
+
+struct SnapshotEnum {
+    SnapshotString name;
+    uint64_t size;
+    uint32_t firstValue;
+    uint32_t valueCount;
+};
+
+struct SnapshotEnumValue {
+    SnapshotString name;
+    int64_t value;
+};
+
+struct SnapshotLayoutHash {
+    SnapshotString name;
+    uint64_t high;
+    uint64_t low;
+};
+#pragma pack(pop)
+
+// Collects parsed state and writes it as a snapshot. Members and enum values are appended to the
+// struct or enum added last.
+class SnapshotBuilder {
+private:
+    std::vector<char> m_strings;
+    std::unordered_map<std::string, SnapshotString> m_interned;
+    std::vector<SnapshotSymbol> m_symbols;
+    std::vector<SnapshotStruct> m_structs;
+    std::vector<SnapshotMember> m_members;
+    std::vector<SnapshotEnum> m_enums;
+    std::vector<SnapshotEnumValue> m_enumValues;
+    std::vector<SnapshotLayoutHash> m_layoutHashes;
+
+    SnapshotString Intern(std::string_view value);
+    std::string_view GetString(const SnapshotString& value) const noexcept;
+
+    template<typename T>
+    void SortByName(std::vector<T>& entries) const;
+
+public:
+    void AddSymbol(std::string_view name, uint64_t rva);
+    void AddStruct(std::string_view name, uint64_t size, bool isUnion);
+    void AddMember(std::string_view name, uint64_t offset, uint64_t size, uint32_t typeId, std::string_view typeName,
+        uint64_t elementSize, uint32_t elementCount, uint32_t bitPosition, uint32_t bitLength, bool isPointer);
+    void AddEnum(std::string_view name, uint64_t size);
+    void AddEnumValue(std::string_view name, int64_t value);
+    void AddLayoutHash(std::string_view name, uint64_t high, uint64_t low);
+
+    bool Write(const std::wstring& outputPath, const PdbSignature& signature);
+};
+
+// A snapshot file mapped read-only. Lookups binary-search the name-sorted tables in place.
+class Snapshot {
+private:
+    MappedFile m_file;
+    const uint8_t* m_pBase = nullptr;
+    size_t m_fileSize = 0;
+    const SnapshotFileHeader* m_header = nullptr;
+    const SnapshotTableHeader* m_tables = nullptr;
+
+    bool Validate() const noexcept;
+
+    template<typename T>
+    const T* Find(SnapshotTable table, std::string_view name) const noexcept;
+
+public:
+    explicit Snapshot(const std::wstring& snapshotPath);
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    const PdbSignature& GetSignature() const noexcept { return m_header->signature; }
+
+    template<typename T>
+    const T* GetTable(SnapshotTable table, size_t& count) const noexcept {
+        count = static_cast<size_t>(m_tables[static_cast<size_t>(table)].count);
+        return reinterpret_cast<const T*>(m_pBase + m_tables[static_cast<size_t>(table)].offset);
+    }
+
+    std::string_view GetString(const SnapshotString& value) const noexcept;
+
+    const SnapshotSymbol* FindSymbol(std::string_view name) const noexcept;
+    const SnapshotStruct* FindStruct(std::string_view name) const noexcept;
+    const SnapshotEnum* FindEnum(std::string_view name) const noexcept;
+    const SnapshotLayoutHash* FindLayoutHash(std::string_view name) const noexcept;
+};
@@ -0,0 +1,568 @@
+#include "StoreIndex.h"
+#include "BatchUtil.h"
+#include "TableWriter.h"
+#include "Parallel.h"
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+    const char StoreIndexMagic[4] = { 'P', 'D', 'B', 'X' };
+    constexpr uint16_t StoreIndexVersion = 1;
+    constexpr uint32_t NoPdbId = UINT32_MAX;
+    constexpr size_t TermKindCount = 2;
+
+    constexpr size_t TableEntrySizes[] = {
+        sizeof(StoreIndexPdb),
+        sizeof(StoreIndexTerm),
+        sizeof(uint8_t),
+        sizeof(char)
+    };
+
+    static_assert(std::size(TableEntrySizes) == static_cast<size_t>(StoreIndexTable::Count), "table sizes out of sync");
+
+    struct ScannedPdb {
+        std::wstring path;
+        std::string utf8Path;
+        uint64_t fileSize;
+        uint64_t lastWriteTime;
+    };
+
+    struct PdbRow {
+        std::string path;
+        PdbSignature signature{};
+        uint64_t fileSize = 0;
+        uint64_t lastWriteTime = 0;
+        bool indexed = false;
+    };
+
+    struct Posting {
+        uint32_t pdbId;
+        DWORD64 rva;
+        LayoutHash layoutHash;
+    };
+
+    using TermMap = std::unordered_map<std::string, std::vector<Posting>>;
+
+    void AppendVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool ReadVarint(const uint8_t*& position, const uint8_t* end, uint64_t& value) noexcept {
+        value = 0;
+        for (unsigned shift = 0; shift < 64 && position < end; shift += 7) {
+            uint8_t byte = *position++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    SnapshotString AppendString(std::vector<char>& pool, std::string_view value) {
+        SnapshotString result{ static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(value.size()) };
+        pool.insert(pool.end(), value.begin(), value.end());
+        return result;
+    }
+
+    uint64_t WriteIndex(const std::wstring& indexPath, const std::vector<PdbRow>& rows, TermMap (&terms)[TermKindCount],
+        size_t& termCount, size_t& postingCount) {
+        // Failed parses leave gaps in the id space; close them so ids stay dense and deltas small.
+        std::vector<uint32_t> remap(rows.size(), NoPdbId);
+        std::vector<StoreIndexPdb> pdbTable;
+        std::vector<char> strings;
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (!rows[i].indexed) continue;
+            remap[i] = static_cast<uint32_t>(pdbTable.size());
+
+            StoreIndexPdb pdb{};
+            pdb.path = AppendString(strings, rows[i].path);
+            pdb.signature = rows[i].signature;
+            pdb.fileSize = rows[i].fileSize;
+            pdb.lastWriteTime = rows[i].lastWriteTime;
+            pdbTable.push_back(pdb);
+        }
+
+        struct TermRef {
+            const std::string* name;
+            StoreIndexTermKind kind;
+            std::vector<Posting>* postings;
+        };
+
+        std::vector<TermRef> order;
+        for (size_t kind = 0; kind < TermKindCount; ++kind) {
+            for (auto& [name, postings] : terms[kind]) {
+                order.push_back({ &name, static_cast<StoreIndexTermKind>(kind), &postings });
+            }
+        }
+
+        std::sort(order.begin(), order.end(), [](const TermRef& a, const TermRef& b) {
+            int compare = a.name->compare(*b.name);
+            return compare != 0 ? compare < 0 : a.kind < b.kind;
+            });
+
+        std::vector<StoreIndexTerm> termTable;
+        std::vector<uint8_t> postingBytes;
+        termTable.reserve(order.size());
+        postingCount = 0;
+
+        for (const auto& ref : order) {
+            auto& postings = *ref.postings;
+            for (auto& posting : postings) {
+                posting.pdbId = remap[posting.pdbId];
+            }
+            std::stable_sort(postings.begin(), postings.end(),
+                [](const Posting& a, const Posting& b) { return a.pdbId < b.pdbId; });
+
+            StoreIndexTerm term{};
+            term.name = AppendString(strings, *ref.name);
+            term.kind = ref.kind;
+            term.postingCount = static_cast<uint32_t>(postings.size());
+            term.postingsOffset = postingBytes.size();
+
+            uint32_t previousId = 0;
+            for (const auto& posting : postings) {
+                AppendVarint(postingBytes, posting.pdbId - previousId);
+                previousId = posting.pdbId;
+
+                if (ref.kind == StoreIndexTermKind::Symbol) {
+                    AppendVarint(postingBytes, posting.rva);
+                }
+                else {
+                    const uint8_t* hash = reinterpret_cast<const uint8_t*>(&posting.layoutHash);
+                    postingBytes.insert(postingBytes.end(), hash, hash + sizeof(LayoutHash));
+                }
+            }
+
+            postingCount += postings.size();
+            termTable.push_back(term);
+        }
+        termCount = termTable.size();
+
+        const size_t counts[] = { pdbTable.size(), termTable.size(), postingBytes.size(), strings.size() };
+
+        StoreIndexFileHeader header{};
+        memcpy(header.magic, StoreIndexMagic, sizeof(header.magic));
+        header.version = StoreIndexVersion;
+        header.tableCount = static_cast<uint16_t>(StoreIndexTable::Count);
+        header.pdbCount = static_cast<uint32_t>(pdbTable.size());
+
+        SnapshotTableHeader tables[static_cast<size_t>(StoreIndexTable::Count)] = {};
+        uint64_t position = sizeof(header) + sizeof(tables);
+        for (size_t i = 0; i < std::size(tables); ++i) {
+            position = AlignUp(position);
+            tables[i].offset = position;
+            tables[i].count = counts[i];
+            position += counts[i] * TableEntrySizes[i];
+        }
+        header.fileSize = position;
+
+        // Same temporary-name-and-rename as snapshots, so a query never maps a half-written index.
+        std::wstring tempPath = indexPath + L".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) throw std::runtime_error("Failed to create store index");
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(tables), sizeof(tables));
+
+            position = sizeof(header) + sizeof(tables);
+            WriteTable(file, position, pdbTable);
+            WriteTable(file, position, termTable);
+            WriteTable(file, position, postingBytes);
+            WriteTable(file, position, strings);
+
+            if (!file.good()) throw std::runtime_error("Failed to write store index");
+        }
+
+        if (!MoveFileExW(tempPath.c_str(), indexPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+            throw std::runtime_error("Failed to replace store index");
+        }
+
+        return header.fileSize;
+    }
+
+    void AddTerms(TermMap (&terms)[TermKindCount], uint32_t pdbId, StoreIndexEntry& entry) {
+        for (auto& [name, rva] : entry.symbols) {
+            terms[static_cast<size_t>(StoreIndexTermKind::Symbol)][std::move(name)].push_back({ pdbId, rva, {} });
+        }
+        for (auto& [name, layoutHash] : entry.types) {
+            terms[static_cast<size_t>(StoreIndexTermKind::Type)][std::move(name)].push_back({ pdbId, 0, layoutHash });
+        }
+    }
+
+    StoreIndexStats UpdateFromScan(std::vector<ScannedPdb> found, const std::wstring& indexPath,
+        const StoreIndexOptions& options, std::chrono::steady_clock::time_point start) {
+        StoreIndexStats stats;
+        std::error_code error;
+
+        // Sorted so a fresh build assigns the same ids regardless of directory enumeration order.
+        std::sort(found.begin(), found.end(), [](const ScannedPdb& a, const ScannedPdb& b) { return a.path < b.path; });
+        stats.pdbsFound = found.size();
+
+        std::unordered_map<std::string_view, size_t> foundByPath;
+        for (size_t i = 0; i < found.size(); ++i) {
+            foundByPath.emplace(found[i].utf8Path, i);
+        }
+
+        std::vector<PdbRow> rows;
+        TermMap terms[TermKindCount];
+        std::vector<bool> reused(found.size(), false);
+
+        if (std::filesystem::exists(indexPath, error)) {
+            try {
+                StoreIndex existing(indexPath);
+
+                size_t oldCount = 0;
+                const StoreIndexPdb* oldPdbs = existing.GetTable<StoreIndexPdb>(StoreIndexTable::Pdbs, oldCount);
+                std::vector<uint32_t> remap(oldCount, NoPdbId);
+
+                for (size_t i = 0; i < oldCount; ++i) {
+                    auto match = foundByPath.find(existing.GetString(oldPdbs[i].path));
+                    if (match == foundByPath.end() || reused[match->second] ||
+                        found[match->second].fileSize != oldPdbs[i].fileSize ||
+                        found[match->second].lastWriteTime != oldPdbs[i].lastWriteTime) {
+                        stats.pdbsRemoved++;
+                        continue;
+                    }
+
+                    remap[i] = static_cast<uint32_t>(rows.size());
+                    reused[match->second] = true;
+                    rows.push_back({ found[match->second].utf8Path, oldPdbs[i].signature,
+                        oldPdbs[i].fileSize, oldPdbs[i].lastWriteTime, true });
+                }
+                stats.pdbsReused = rows.size();
+
+                size_t termCount = 0;
+                const StoreIndexTerm* oldTerms = existing.GetTable<StoreIndexTerm>(StoreIndexTable::Terms, termCount);
+                for (size_t i = 0; i < termCount; ++i) {
+                    std::vector<Posting> kept;
+                    bool valid = existing.DecodePostings(oldTerms[i], [&](uint32_t pdbId, DWORD64 rva, const LayoutHash& layoutHash) {
+                        if (remap[pdbId] != NoPdbId) {
+                            kept.push_back({ remap[pdbId], rva, layoutHash });
+                        }
+                        });
+
+                    if (!valid) throw std::runtime_error("Corrupt postings in store index");
+
+                    size_t kind = static_cast<size_t>(oldTerms[i].kind);
+                    if (!kept.empty() && kind < TermKindCount) {
+                        terms[kind].emplace(std::string(existing.GetString(oldTerms[i].name)), std::move(kept));
+                    }
+                }
+            }
+            catch (...) {
+                // An unreadable index is rebuilt from scratch rather than trusted in part.
+                rows.clear();
+                for (auto& map : terms) map.clear();
+                std::fill(reused.begin(), reused.end(), false);
+                stats.pdbsReused = 0;
+                stats.pdbsRemoved = 0;
+            }
+        }
+
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < found.size(); ++i) {
+            if (!reused[i]) pending.push_back(i);
+        }
+
+        size_t firstNewId = rows.size();
+        rows.resize(firstNewId + pending.size());
+        for (size_t i = 0; i < pending.size(); ++i) {
+            const auto& file = found[pending[i]];
+            rows[firstNewId + i] = { file.utf8Path, {}, file.fileSize, file.lastWriteTime, false };
+        }
+
+        std::mutex termLock;
+        std::atomic<size_t> indexed{ 0 }, failed{ 0 };
+
+        // Parsing dominates; each worker fills local lists and takes the lock once per PDB to merge them.
+        RunParallel(pending.size(), options.threads, [&](size_t i) {
+            TraceScope trace(TracePhase::IndexPdb);
+            const auto& file = found[pending[i]];
+            uint32_t pdbId = static_cast<uint32_t>(firstNewId + i);
+
+            try {
+                std::optional<PdbSignature> signature;
+                {
+                    MsfReader msf(file.path);
+                    signature = PdbSignature::Read(msf);
+                }
+
+                PdbParser parser(file.path);
+                if (!signature || !parser.IsInitialized()) {
+                    failed++;
+                    return;
+                }
+
+                StoreIndexEntry entry;
+                StoreIndexer::Collect(parser, entry);
+
+                std::lock_guard<std::mutex> guard(termLock);
+                AddTerms(terms, pdbId, entry);
+                rows[pdbId].signature = *signature;
+                rows[pdbId].indexed = true;
+                indexed++;
+            }
+            catch (...) {
+                failed++;
+            }
+            });
+
+        stats.pdbsIndexed = indexed;
+        stats.parseFailed = failed;
+        stats.indexBytes = WriteIndex(indexPath, rows, terms, stats.termCount, stats.postingCount);
+        stats.wallUs = ElapsedUs(start);
+        return stats;
+    }
+}
+
+StoreIndex::StoreIndex(const std::wstring& indexPath)
+    : m_file(indexPath), m_pBase(m_file.GetData()), m_fileSize(m_file.GetSize()) {
+    if (m_fileSize < sizeof(StoreIndexFileHeader) + sizeof(SnapshotTableHeader) * static_cast<size_t>(StoreIndexTable::Count)) {
+        throw std::runtime_error("Store index file is too small");
+    }
+
+    m_header = reinterpret_cast<const StoreIndexFileHeader*>(m_pBase);
+    m_tables = reinterpret_cast<const SnapshotTableHeader*>(m_pBase + sizeof(StoreIndexFileHeader));
+
+    if (!Validate()) {
+        throw std::runtime_error("Not a compatible store index file");
+    }
+}
+
+bool StoreIndex::Validate() const noexcept {
+    if (memcmp(m_header->magic, StoreIndexMagic, sizeof(StoreIndexMagic)) != 0 ||
+        m_header->version != StoreIndexVersion ||
+        m_header->tableCount != static_cast<uint16_t>(StoreIndexTable::Count) ||
+        m_header->fileSize != m_fileSize) {
+        return false;
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(StoreIndexTable::Count); ++i) {
+        const auto& table = m_tables[i];
+        if (table.offset % 8 != 0 || table.offset > m_fileSize ||
+            table.count > (m_fileSize - table.offset) / TableEntrySizes[i]) {
+            return false;
+        }
+    }
+
+    return m_tables[static_cast<size_t>(StoreIndexTable::Pdbs)].count == m_header->pdbCount;
+}
+
+std::string_view StoreIndex::GetString(const SnapshotString& value) const noexcept {
+    size_t poolSize = 0;
+    const char* pool = GetTable<char>(StoreIndexTable::Strings, poolSize);
+    if (value.offset > poolSize || value.length > poolSize - value.offset) return {};
+    return std::string_view(pool + value.offset, value.length);
+}
+
+bool StoreIndex::DecodePostings(const StoreIndexTerm& term,
+    const std::function<void(uint32_t pdbId, DWORD64 rva, const LayoutHash& layoutHash)>& callback) const {
+    size_t postingBytes = 0;
+    const uint8_t* postings = GetTable<uint8_t>(StoreIndexTable::Postings, postingBytes);
+    if (term.postingsOffset > postingBytes) return false;
+
+    const uint8_t* position = postings + term.postingsOffset;
+    const uint8_t* end = postings + postingBytes;
+    uint64_t pdbId = 0;
+
+    for (uint32_t i = 0; i < term.postingCount; ++i) {
+        uint64_t delta = 0;
+        if (!ReadVarint(position, end, delta)) return false;
+        pdbId += delta;
+        if (pdbId >= m_header->pdbCount) return false;
+
+        DWORD64 rva = 0;
+        LayoutHash layoutHash;
+        if (term.kind == StoreIndexTermKind::Symbol) {
+            if (!ReadVarint(position, end, rva)) return false;
+        }
+        else {
+            if (static_cast<size_t>(end - position) < sizeof(LayoutHash)) return false;
+            memcpy(&layoutHash, position, sizeof(LayoutHash));
+            position += sizeof(LayoutHash);
+        }
+
+        callback(static_cast<uint32_t>(pdbId), rva, layoutHash);
+    }
+
+    return true;
+}
+
+std::vector<StoreIndexHit> StoreIndex::Query(std::string_view name) const {
+    TraceScope trace(TracePhase::QueryIndex);
+
+    size_t termCount = 0, pdbCount = 0;
+    const StoreIndexTerm* terms = GetTable<StoreIndexTerm>(StoreIndexTable::Terms, termCount);
+    const StoreIndexPdb* pdbs = GetTable<StoreIndexPdb>(StoreIndexTable::Pdbs, pdbCount);
+
+    const StoreIndexTerm* it = std::lower_bound(terms, terms + termCount, name,
+        [&](const StoreIndexTerm& term, std::string_view key) { return GetString(term.name) < key; });
+
+    // A name can be both a public symbol and a type; the two terms sit next to each other.
+    std::vector<StoreIndexHit> hits;
+    for (; it != terms + termCount && GetString(it->name) == name; ++it) {
+        StoreIndexTermKind kind = it->kind;
+        DecodePostings(*it, [&](uint32_t pdbId, DWORD64 rva, const LayoutHash& layoutHash) {
+            StoreIndexHit hit;
+            hit.pdbPath = std::string(GetString(pdbs[pdbId].path));
+            hit.signature = pdbs[pdbId].signature;
+            hit.kind = kind;
+            hit.rva = rva;
+            hit.layoutHash = layoutHash;
+            hits.push_back(std::move(hit));
+            });
+    }
+
+    return hits;
+}
+
+StoreIndexStats StoreIndexer::Update(const std::wstring& storeDirectory, const std::wstring& indexPath,
+    const StoreIndexOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+
+    // A scan that stops early would drop every PDB it did not reach from the index, so anything short
+    // of a complete walk leaves the existing index alone.
+    std::error_code error;
+    if (!std::filesystem::is_directory(storeDirectory, error)) {
+        throw std::runtime_error("Store directory not found: " + WStringToString(storeDirectory));
+    }
+
+    std::vector<ScannedPdb> found;
+    std::filesystem::recursive_directory_iterator it(storeDirectory,
+        std::filesystem::directory_options::skip_permission_denied, error);
+    for (std::filesystem::recursive_directory_iterator end; !error && it != end; it.increment(error)) {
+        if (!IsPdbFile(it->path())) continue;
+
+        bool regularFile = it->is_regular_file(error);
+        if (error) break;
+        if (!regularFile) continue;
+
+        std::error_code statError;
+        uint64_t fileSize = it->file_size(statError);
+        uint64_t lastWriteTime = static_cast<uint64_t>(it->last_write_time(statError).time_since_epoch().count());
+        if (statError) continue;
+
+        std::wstring path = it->path().wstring();
+        found.push_back({ path, WStringToString(path), fileSize, lastWriteTime });
+    }
+
+    if (error) {
+        throw std::runtime_error("Failed to scan store directory: " + error.message());
+    }
+
+    return UpdateFromScan(std::move(found), indexPath, options, start);
+}
+
+void StoreIndexer::Collect(const PdbParser& parser, StoreIndexEntry& entry) {
+    parser.ForEachPublicSymbol([&](const SymbolInfo& symbol) -> bool {
+        entry.symbols.emplace_back(symbol.name, symbol.rva);
+        return true;
+        });
+
+    const auto& layoutHashes = parser.ComputeLayoutHashes();
+    entry.types.assign(layoutHashes.begin(), layoutHashes.end());
+}
+
+StoreIndexStats StoreIndexer::Write(std::vector<StoreIndexEntry> entries, const std::wstring& indexPath) {
+    auto start = std::chrono::steady_clock::now();
+    StoreIndexStats stats;
+    stats.pdbsFound = entries.size();
+
+    // Sorted by path so the same entries always get the same ids, as a fresh Update would assign.
+    std::vector<size_t> order(entries.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return entries[a].path < entries[b].path; });
+
+    std::vector<PdbRow> rows;
+    TermMap terms[TermKindCount];
+    for (size_t index : order) {
+        auto& entry = entries[index];
+        std::error_code error;
+        uint64_t fileSize = std::filesystem::file_size(entry.path, error);
+        uint64_t lastWriteTime = static_cast<uint64_t>(std::filesystem::last_write_time(entry.path, error).time_since_epoch().count());
+
+        AddTerms(terms, static_cast<uint32_t>(rows.size()), entry);
+        rows.push_back({ WStringToString(entry.path), entry.signature, fileSize, lastWriteTime, true });
+    }
+
+    stats.pdbsIndexed = rows.size();
+    stats.indexBytes = WriteIndex(indexPath, rows, terms, stats.termCount, stats.postingCount);
+    stats.wallUs = ElapsedUs(start);
+    return stats;
+}
+
+StoreIndexStats StoreIndexer::Merge(const std::vector<std::wstring>& indexPaths, const std::wstring& outputPath) {
+    auto start = std::chrono::steady_clock::now();
+    StoreIndexStats stats;
+
+    std::vector<PdbRow> rows;
+    TermMap terms[TermKindCount];
+    std::unordered_map<std::string, uint32_t> rowByPath;
+
+    for (const auto& indexPath : indexPaths) {
+        StoreIndex index(indexPath);
+
+        size_t pdbCount = 0;
+        const StoreIndexPdb* pdbs = index.GetTable<StoreIndexPdb>(StoreIndexTable::Pdbs, pdbCount);
+        std::vector<uint32_t> remap(pdbCount, NoPdbId);
+        stats.pdbsFound += pdbCount;
+
+        // A PDB indexed by more than one input keeps the postings of the first.
+        for (size_t i = 0; i < pdbCount; ++i) {
+            std::string path(index.GetString(pdbs[i].path));
+            if (!rowByPath.emplace(path, static_cast<uint32_t>(rows.size())).second) {
+                stats.pdbsRemoved++;
+                continue;
+            }
+
+            remap[i] = static_cast<uint32_t>(rows.size());
+            rows.push_back({ std::move(path), pdbs[i].signature, pdbs[i].fileSize, pdbs[i].lastWriteTime, true });
+        }
+
+        size_t termCount = 0;
+        const StoreIndexTerm* indexTerms = index.GetTable<StoreIndexTerm>(StoreIndexTable::Terms, termCount);
+        for (size_t i = 0; i < termCount; ++i) {
+            size_t kind = static_cast<size_t>(indexTerms[i].kind);
+            if (kind >= TermKindCount) continue;
+
+            std::vector<Posting>* postings = nullptr;
+            bool valid = index.DecodePostings(indexTerms[i], [&](uint32_t pdbId, DWORD64 rva, const LayoutHash& layoutHash) {
+                if (pdbId >= remap.size() || remap[pdbId] == NoPdbId) return;
+                if (!postings) postings = &terms[kind][std::string(index.GetString(indexTerms[i].name))];
+                postings->push_back({ remap[pdbId], rva, layoutHash });
+                });
+
+            if (!valid) throw std::runtime_error("Corrupt postings in store index");
+        }
+    }
+
+    stats.pdbsReused = rows.size();
+    stats.indexBytes = WriteIndex(outputPath, rows, terms, stats.termCount, stats.postingCount);
+    stats.wallUs = ElapsedUs(start);
+    return stats;
+}
+
+void StoreIndexer::PrintStats(const StoreIndexStats& stats) {
+    std::cout << "PDBs in store:    " << stats.pdbsFound << "\n";
+    std::cout << "Reused from index: " << stats.pdbsReused << "\n";
+    std::cout << "Newly indexed:    " << stats.pdbsIndexed << "\n";
+    std::cout << "Dropped (changed or deleted): " << stats.pdbsRemoved << "\n";
+    std::cout << "Parse failures:   " << stats.parseFailed << "\n";
+    std::cout << "Terms: " << stats.termCount << ", postings: " << stats.postingCount
+        << ", index size: " << stats.indexBytes / 1024 << "KB\n";
+    std::cout << "Wall time: " << stats.wallUs / 1000 << "ms\n";
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include "PdbParser.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// PDBX store index layout (all integers little-endian, every table 8-byte aligned, no pointers):
+//
+//   StoreIndexFileHeader
+//   SnapshotTableHeader[StoreIndexTable::Count]
+//   PDB table: one row per indexed PDB, its path and the size/mtime it was indexed at
+//   term table: one row per (name, kind), sorted by name then kind
+//   postings: per term, entries ordered by PDB id; each is a varint PDB id delta followed by a
+//             varint RVA (symbols) or the raw 16-byte layout hash (types)
+//   string pool: UTF-8 names and paths referenced by (offset, length) pairs
+//
+// A query is a binary search of the term table plus a decode of one postings run, so its cost does
+// not depend on how many PDBs the store holds.
+
+enum class StoreIndexTable : uint16_t {
+    Pdbs,
+    Terms,
+    Postings,
+    Strings,
+    Count
+};
+
+enum class StoreIndexTermKind : uint8_t {
+    Symbol,
+    Type
+};
+
+#pragma pack(push, 1)
+struct StoreIndexFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t tableCount;
+    uint32_t reserved;
+    uint32_t pdbCount;
+    uint64_t fileSize;
+};
+
+struct StoreIndexPdb {
+    SnapshotString path;
+    PdbSignature signature;
+    uint32_t reserved;
+    uint64_t fileSize;
+    uint64_t lastWriteTime;
+};
+
+struct StoreIndexTerm {
+    SnapshotString name;
+    StoreIndexTermKind kind;
+    uint8_t reserved[3];
+    uint32_t postingCount;
+    uint64_t postingsOffset;
+};
+#pragma pack(pop)
+
+struct StoreIndexHit {
+    std::string pdbPath;
+    PdbSignature signature;
+    StoreIndexTermKind kind;
+    DWORD64 rva = 0;
+    LayoutHash layoutHash;
+};
+
+// What one PDB contributes to an index: its public symbols and the layout hash of every UDT.
+struct StoreIndexEntry {
+    std::wstring path;
+    PdbSignature signature{};
+    std::vector<std::pair<std::string, DWORD64>> symbols;
+    std::vector<std::pair<std::string, LayoutHash>> types;
+};
+
+struct StoreIndexOptions {
+    size_t threads = 0;
+};
+
+struct StoreIndexStats {
+    size_t pdbsFound = 0;
+    size_t pdbsReused = 0;
+    size_t pdbsIndexed = 0;
+    size_t pdbsRemoved = 0;
+    size_t parseFailed = 0;
+    size_t termCount = 0;
+    size_t postingCount = 0;
+    uint64_t indexBytes = 0;
+    uint64_t wallUs = 0;
+};
+
+// An index file mapped read-only. The constructor throws if the file is missing or malformed.
+class StoreIndex {
+private:
+    MappedFile m_file;
+    const uint8_t* m_pBase = nullptr;
+    size_t m_fileSize = 0;
+    const StoreIndexFileHeader* m_header = nullptr;
+    const SnapshotTableHeader* m_tables = nullptr;
+
+    bool Validate() const noexcept;
+
+public:
+    explicit StoreIndex(const std::wstring& indexPath);
+
+    StoreIndex(const StoreIndex&) = delete;
+    StoreIndex& operator=(const StoreIndex&) = delete;
+
+    template<typename T>
+    const T* GetTable(StoreIndexTable table, size_t& count) const noexcept {
+        count = static_cast<size_t>(m_tables[static_cast<size_t>(table)].count);
+        return reinterpret_cast<const T*>(m_pBase + m_tables[static_cast<size_t>(table)].offset);
+    }
+
+    std::string_view GetString(const SnapshotString& value) const noexcept;
+
+    // Calls back with (pdbId, rva, layoutHash) for every posting of the term; false if it is corrupt.
+    bool DecodePostings(const StoreIndexTerm& term,
+        const std::function<void(uint32_t pdbId, DWORD64 rva, const LayoutHash& layoutHash)>& callback) const;
+
+    std::vector<StoreIndexHit> Query(std::string_view name) const;
+};
+
+// Builds or refreshes an index over every *.pdb under a store directory. PDBs whose path, size and
+// write time match the existing index keep their postings; only new or changed files are parsed,
+// several at a time.
+class StoreIndexer {
+public:
+    static StoreIndexStats Update(const std::wstring& storeDirectory, const std::wstring& indexPath,
+        const StoreIndexOptions& options = {});
+    // Fills entry's terms from a PDB the caller already has open.
+    static void Collect(const PdbParser& parser, StoreIndexEntry& entry);
+    // Writes a fresh index over entries the caller collected, without opening the PDBs again.
+    static StoreIndexStats Write(std::vector<StoreIndexEntry> entries, const std::wstring& indexPath);
+    // Combines indexes built over disjoint sets of PDBs into one; pdbsReused counts the PDBs kept and
+    // pdbsRemoved those dropped because an earlier input already indexed the same path.
+    static StoreIndexStats Merge(const std::vector<std::wstring>& indexPaths, const std::wstring& outputPath);
+    static void PrintStats(const StoreIndexStats& stats);
+};
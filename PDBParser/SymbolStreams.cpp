@@ -0,0 +1,347 @@
+#include "SymbolStreams.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+    constexpr uint32_t DbiStream = 3;
+    constexpr size_t DbiHeaderSize = 64;
+    constexpr size_t DbiMachineOffset = 58;
+
+    constexpr uint32_t GsiSignature = 0xFFFFFFFF;
+    constexpr uint32_t GsiVersion = 0xEFFE0000 + 19990810;
+    constexpr size_t GsiHeaderSize = 16;
+    constexpr size_t GsiHashRecordSize = 8;
+    constexpr size_t PublicsHeaderSize = 28;
+    constexpr uint32_t GsiBucketOffsetUnit = 12;
+
+    constexpr size_t SectionHeaderSize = 40;
+    constexpr size_t SectionVirtualSizeOffset = 8;
+    constexpr size_t SectionVirtualAddressOffset = 12;
+
+    template<typename T>
+    bool ReadValue(const std::vector<uint8_t>& data, size_t offset, T& value) noexcept {
+        if (offset + sizeof(T) > data.size()) return false;
+        memcpy(&value, data.data() + offset, sizeof(T));
+        return true;
+    }
+}
+
+bool GsiHashTable::Load(const std::vector<uint8_t>& stream, size_t headerOffset) {
+    uint32_t signature = 0, version = 0, hashRecordBytes = 0, bucketBytes = 0;
+    if (!ReadValue(stream, headerOffset, signature) ||
+        !ReadValue(stream, headerOffset + 4, version) ||
+        !ReadValue(stream, headerOffset + 8, hashRecordBytes) ||
+        !ReadValue(stream, headerOffset + 12, bucketBytes)) {
+        return false;
+    }
+
+    if (signature != GsiSignature || version != GsiVersion) return false;
+
+    size_t recordsOffset = headerOffset + GsiHeaderSize;
+    size_t bitmapOffset = recordsOffset + hashRecordBytes;
+    size_t bitmapWords = (BucketCount + 1 + 31) / 32;
+    size_t bucketsOffset = bitmapOffset + bitmapWords * sizeof(uint32_t);
+
+    if (bitmapOffset + bucketBytes > stream.size() || bucketBytes < bitmapWords * sizeof(uint32_t)) return false;
+
+    size_t recordCount = hashRecordBytes / GsiHashRecordSize;
+    m_recordOffsets.resize(recordCount);
+    for (size_t i = 0; i < recordCount; ++i) {
+        int32_t offset = 0;
+        ReadValue(stream, recordsOffset + i * GsiHashRecordSize, offset);
+        m_recordOffsets[i] = offset > 0 ? static_cast<uint32_t>(offset - 1) : 0;
+    }
+
+    m_bucketStarts.fill(static_cast<uint32_t>(recordCount));
+
+    size_t nextBucket = bucketsOffset;
+    for (uint32_t bucket = 0; bucket < BucketCount; ++bucket) {
+        uint32_t word = 0;
+        ReadValue(stream, bitmapOffset + (bucket / 32) * sizeof(uint32_t), word);
+        if ((word & (1u << (bucket % 32))) == 0) continue;
+
+        uint32_t start = 0;
+        if (!ReadValue(stream, nextBucket, start)) return false;
+        nextBucket += sizeof(uint32_t);
+
+        m_bucketStarts[bucket] = (std::min)(start / GsiBucketOffsetUnit, static_cast<uint32_t>(recordCount));
+    }
+
+    // Empty buckets take the start of the next occupied one, so every bucket is [start, next start).
+    for (uint32_t bucket = BucketCount; bucket-- > 0;) {
+        uint32_t word = 0;
+        ReadValue(stream, bitmapOffset + (bucket / 32) * sizeof(uint32_t), word);
+        if ((word & (1u << (bucket % 32))) == 0) {
+            m_bucketStarts[bucket] = m_bucketStarts[bucket + 1];
+        }
+    }
+
+    return true;
+}
+
+uint32_t GsiHashTable::HashName(std::string_view name) noexcept {
+    uint32_t result = 0;
+    size_t position = 0;
+
+    for (; position + 4 <= name.size(); position += 4) {
+        uint32_t value = 0;
+        memcpy(&value, name.data() + position, sizeof(value));
+        result ^= value;
+    }
+
+    if (name.size() - position >= 2) {
+        uint16_t value = 0;
+        memcpy(&value, name.data() + position, sizeof(value));
+        result ^= value;
+        position += 2;
+    }
+
+    if (position < name.size()) {
+        result ^= static_cast<uint8_t>(name[position]);
+    }
+
+    result |= 0x20202020;
+    result ^= (result >> 11);
+    return result ^ (result >> 16);
+}
+
+std::optional<uint16_t> SymbolStreams::ReadMachine(const MsfReader& msf) {
+    std::vector<uint8_t> header(DbiHeaderSize);
+    if (!msf.ReadStreamRange(DbiStream, 0, DbiHeaderSize, header.data())) return std::nullopt;
+
+    uint16_t machine = 0;
+    ReadValue(header, DbiMachineOffset, machine);
+    return machine;
+}
+
+SymbolStreams::SymbolStreams(std::shared_ptr<const MsfReader> msf)
+    : m_msf(std::move(msf)) {
+    std::vector<uint8_t> dbi(DbiHeaderSize);
+    if (!m_msf->ReadStreamRange(DbiStream, 0, DbiHeaderSize, dbi.data())) {
+        throw std::runtime_error("PDB has no DBI stream");
+    }
+
+    uint16_t publicsStream = 0;
+    int32_t substreamSizes[8] = {};
+    ReadValue(dbi, 12, m_globalsStream);
+    ReadValue(dbi, 16, publicsStream);
+    ReadValue(dbi, 20, m_symbolRecordStream);
+    ReadValue(dbi, DbiMachineOffset, m_machine);
+    for (size_t i = 0; i < 8; ++i) {
+        ReadValue(dbi, 24 + i * sizeof(int32_t), substreamSizes[i]);
+    }
+
+    m_symbolRecordSize = m_msf->GetStreamSize(m_symbolRecordStream);
+    if (m_symbolRecordSize == 0) {
+        throw std::runtime_error("PDB has no symbol record stream");
+    }
+    m_symbolRecords.reset(new uint8_t[m_symbolRecordSize]);
+    m_loadedPages.assign((m_symbolRecordSize + RecordPageSize - 1) / RecordPageSize, false);
+
+    // Publics are optional here; without them lookups simply fall back to DIA. Only the header and
+    // the hash are read; the address and thunk maps behind them are not used.
+    uint32_t publicsHashBytes = 0;
+    std::vector<uint8_t> publics(PublicsHeaderSize);
+    if (m_msf->ReadStreamRange(publicsStream, 0, PublicsHeaderSize, publics.data()) &&
+        ReadValue(publics, 0, publicsHashBytes)) {
+        publics.resize(PublicsHeaderSize + static_cast<size_t>(publicsHashBytes));
+        if (!m_msf->ReadStreamRange(publicsStream, PublicsHeaderSize, publicsHashBytes, publics.data() + PublicsHeaderSize) ||
+            !m_publics.Load(publics, PublicsHeaderSize)) {
+            m_publics = GsiHashTable();
+        }
+    }
+
+    // Module info, section contributions, section map, file info, type server map and EC substreams
+    // precede the optional debug header; slot 5 of the sizes is the MFC type server index, not a size.
+    int64_t dbgHeaderOffset = static_cast<int64_t>(DbiHeaderSize) + substreamSizes[0] + substreamSizes[1] +
+        substreamSizes[2] + substreamSizes[3] + substreamSizes[4] + substreamSizes[7];
+
+    // Older PDBs may end the debug header before the later slots; those read as absent.
+    m_debugStreams.fill(MsfReader::InvalidStream);
+    if (dbgHeaderOffset >= 0 && dbgHeaderOffset <= UINT32_MAX && substreamSizes[6] > 0) {
+        uint32_t slots = (std::min)(static_cast<uint32_t>(substreamSizes[6]) / static_cast<uint32_t>(sizeof(uint16_t)),
+            static_cast<uint32_t>(m_debugStreams.size()));
+        m_msf->ReadStreamRange(DbiStream, static_cast<uint32_t>(dbgHeaderOffset), slots * sizeof(uint16_t),
+            reinterpret_cast<uint8_t*>(m_debugStreams.data()));
+    }
+
+    auto readSections = [&](uint16_t stream, const auto& callback) {
+        std::vector<uint8_t> sections;
+        if (stream == MsfReader::InvalidStream || !m_msf->ReadStream(stream, sections)) return;
+        for (size_t offset = 0; offset + SectionHeaderSize <= sections.size(); offset += SectionHeaderSize) {
+            uint32_t virtualSize = 0, virtualAddress = 0;
+            ReadValue(sections, offset + SectionVirtualSizeOffset, virtualSize);
+            ReadValue(sections, offset + SectionVirtualAddressOffset, virtualAddress);
+            callback(virtualAddress, virtualSize);
+        }
+    };
+
+    readSections(GetSectionHeaderStream(), [&](uint32_t virtualAddress, uint32_t virtualSize) {
+        m_imageSize = (std::max)(m_imageSize, static_cast<DWORD64>(virtualAddress) + virtualSize);
+        });
+
+    // A post-link optimizer rewrites the image but not the symbol records, whose section:offset pairs
+    // still refer to the original sections; OMAP-from-source maps those RVAs into the final image.
+    std::vector<uint8_t> omap;
+    uint16_t omapStream = GetDebugStream(DebugStream::OmapFromSource);
+    if (omapStream != MsfReader::InvalidStream && m_msf->ReadStream(omapStream, omap) && !omap.empty()) {
+        m_omapFromSource.resize(omap.size() / sizeof(OmapEntry));
+        memcpy(m_omapFromSource.data(), omap.data(), m_omapFromSource.size() * sizeof(OmapEntry));
+    }
+
+    uint16_t originalSections = GetDebugStream(DebugStream::OriginalSectionHeaders);
+    uint16_t symbolSections = !m_omapFromSource.empty() && originalSections != MsfReader::InvalidStream
+        ? originalSections : GetSectionHeaderStream();
+    readSections(symbolSections, [&](uint32_t virtualAddress, uint32_t) {
+        m_sectionRvas.push_back(virtualAddress);
+        });
+}
+
+const GsiHashTable& SymbolStreams::GetGlobals() const {
+    if (!m_globalsLoaded) {
+        m_globalsLoaded = true;
+
+        std::vector<uint8_t> globals;
+        if (!m_msf->ReadStream(m_globalsStream, globals) || !m_globals.Load(globals, 0)) {
+            m_globals = GsiHashTable();
+        }
+    }
+    return m_globals;
+}
+
+bool SymbolStreams::LoadRecords(uint32_t offset, uint32_t length) const noexcept {
+    if (offset > m_symbolRecordSize || length > m_symbolRecordSize - offset || length == 0) return false;
+
+    for (uint32_t page = offset / RecordPageSize; page <= (offset + length - 1) / RecordPageSize; ++page) {
+        if (m_loadedPages[page]) continue;
+
+        uint32_t pageOffset = page * RecordPageSize;
+        uint32_t pageLength = (std::min)(RecordPageSize, m_symbolRecordSize - pageOffset);
+        if (!m_msf->ReadStreamRange(m_symbolRecordStream, pageOffset, pageLength, m_symbolRecords.get() + pageOffset)) {
+            return false;
+        }
+        m_loadedPages[page] = true;
+    }
+
+    return true;
+}
+
+bool SymbolStreams::ReadRecord(uint32_t offset, uint16_t& kind, const uint8_t*& body, uint16_t& bodyLength) const noexcept {
+    uint16_t length = 0;
+    if (!LoadRecords(offset, sizeof(length))) return false;
+    memcpy(&length, m_symbolRecords.get() + offset, sizeof(length));
+
+    if (length < sizeof(uint16_t) || !LoadRecords(offset, sizeof(uint16_t) + length)) return false;
+
+    memcpy(&kind, m_symbolRecords.get() + offset + 2, sizeof(kind));
+    body = m_symbolRecords.get() + offset + 4;
+    bodyLength = static_cast<uint16_t>(length - sizeof(uint16_t));
+    return true;
+}
+
+bool SymbolStreams::DecodeDataSymbol(uint32_t offset, NativeDataSymbol& symbol) const noexcept {
+    uint16_t kind = 0;
+    const uint8_t* body = nullptr;
+    uint16_t bodyLength = 0;
+
+    if (!ReadRecord(offset, kind, body, bodyLength)) return false;
+
+    bool decoded = false;
+    auto visitor = [&](const auto& record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (std::is_base_of_v<CodeViewRecord::GlobalData, Record>) {
+            symbol = NativeDataSymbol{ record.name, Record::Kind, record.type, record.section, record.offset };
+            decoded = true;
+        }
+    };
+
+    size_t consumed = 0;
+    return CodeViewSymbolDispatcher::Dispatch(kind, body, bodyLength, visitor, consumed) && decoded;
+}
+
+bool SymbolStreams::DecodePublicSymbol(uint32_t offset, NativePublicSymbol& symbol) const noexcept {
+    uint16_t kind = 0;
+    const uint8_t* body = nullptr;
+    uint16_t bodyLength = 0;
+
+    if (!ReadRecord(offset, kind, body, bodyLength)) return false;
+
+    bool decoded = false;
+    auto visitor = [&](const auto& record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (std::is_same_v<CodeViewRecord::Public, Record>) {
+            symbol = NativePublicSymbol{ record.name, record.flags, record.section, record.offset };
+            decoded = true;
+        }
+    };
+
+    size_t consumed = 0;
+    return CodeViewSymbolDispatcher::Dispatch(kind, body, bodyLength, visitor, consumed) && decoded;
+}
+
+std::optional<NativeDataSymbol> SymbolStreams::FindGlobalData(std::string_view name) const {
+    std::optional<NativeDataSymbol> result;
+
+    GetGlobals().ForEachInBucket(name, [&](uint32_t offset) -> bool {
+        NativeDataSymbol symbol{};
+        if (DecodeDataSymbol(offset, symbol) && symbol.name == name) {
+            result = symbol;
+            return false;
+        }
+        return true;
+        });
+
+    return result;
+}
+
+void SymbolStreams::ForEachGlobalData(const std::function<bool(const NativeDataSymbol&)>& callback) const {
+    const GsiHashTable& globals = GetGlobals();
+    for (size_t i = 0; i < globals.GetRecordCount(); ++i) {
+        NativeDataSymbol symbol{};
+        if (DecodeDataSymbol(globals.GetRecordOffset(i), symbol) && !callback(symbol)) {
+            break;
+        }
+    }
+}
+
+std::optional<NativePublicSymbol> SymbolStreams::FindPublic(std::string_view name) const {
+    std::optional<NativePublicSymbol> result;
+
+    m_publics.ForEachInBucket(name, [&](uint32_t offset) -> bool {
+        NativePublicSymbol symbol{};
+        if (DecodePublicSymbol(offset, symbol) && symbol.name == name) {
+            result = symbol;
+            return false;
+        }
+        return true;
+        });
+
+    return result;
+}
+
+void SymbolStreams::ForEachPublic(const std::function<bool(const NativePublicSymbol&)>& callback) const {
+    for (size_t i = 0; i < m_publics.GetRecordCount(); ++i) {
+        NativePublicSymbol symbol{};
+        if (DecodePublicSymbol(m_publics.GetRecordOffset(i), symbol) && !callback(symbol)) {
+            break;
+        }
+    }
+}
+
+std::optional<DWORD64> SymbolStreams::SectionOffsetToRva(uint16_t section, uint32_t offset) const noexcept {
+    if (section == 0 || section > m_sectionRvas.size()) return std::nullopt;
+
+    uint32_t rva = m_sectionRvas[section - 1] + offset;
+    if (m_omapFromSource.empty()) return static_cast<DWORD64>(rva);
+
+    // The entry at or below the RVA decides; a target of 0 means the code was dropped from the image.
+    auto it = std::upper_bound(m_omapFromSource.begin(), m_omapFromSource.end(), rva,
+        [](uint32_t value, const OmapEntry& entry) { return value < entry.rva; });
+    if (it == m_omapFromSource.begin()) return std::nullopt;
+
+    --it;
+    if (it->rvaTo == 0) return std::nullopt;
+    return static_cast<DWORD64>(it->rvaTo) + (rva - it->rva);
+}
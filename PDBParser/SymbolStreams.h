@@ -0,0 +1,112 @@
+#pragma once
+#include "MsfReader.h"
+#include "CodeView.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+struct NativeDataSymbol {
+    std::string_view name;
+    CodeViewSymbolKind kind;
+    uint32_t typeIndex;
+    uint16_t section;
+    uint32_t offset;
+};
+
+struct NativePublicSymbol {
+    std::string_view name;
+    uint32_t flags;
+    uint16_t section;
+    uint32_t offset;
+};
+
+// Slots of the DBI optional debug header that name the streams behind them.
+enum class DebugStream : size_t {
+    OmapToSource = 3,
+    OmapFromSource = 4,
+    SectionHeaders = 5,
+    OriginalSectionHeaders = 10,
+    Count = 11
+};
+
+struct OmapEntry {
+    uint32_t rva;
+    uint32_t rvaTo;
+};
+
+// Globals Symbol Index: the on-disk hash over the symbol record stream. Lookups hash the name with
+// the PDB's string hash and only walk the records chained in that bucket.
+class GsiHashTable {
+private:
+    static constexpr uint32_t BucketCount = 4096;
+
+    std::vector<uint32_t> m_recordOffsets;
+    std::array<uint32_t, BucketCount + 1> m_bucketStarts{};
+
+public:
+    bool Load(const std::vector<uint8_t>& stream, size_t headerOffset);
+
+    static uint32_t HashName(std::string_view name) noexcept;
+
+    size_t GetRecordCount() const noexcept { return m_recordOffsets.size(); }
+    uint32_t GetRecordOffset(size_t index) const noexcept { return m_recordOffsets[index]; }
+
+    template<typename Func>
+    void ForEachInBucket(std::string_view name, const Func& callback) const {
+        uint32_t bucket = HashName(name) % BucketCount;
+        for (uint32_t i = m_bucketStarts[bucket]; i < m_bucketStarts[bucket + 1]; ++i) {
+            if (!callback(m_recordOffsets[i])) break;
+        }
+    }
+};
+
+// DBI-level symbol data read straight from the MSF streams: the symbol record stream, its globals and
+// publics hashes, and the section headers (plus OMAP for post-link-optimized images) needed to turn
+// section:offset pairs into RVAs. Only the DBI header and debug header are read from the DBI stream,
+// the globals hash is read on the first global lookup and symbol records are paged in from the MSF on
+// first access, so a few public name lookups touch a few pages of the file. Paging mutates state, so a
+// SymbolStreams must not be shared between threads.
+class SymbolStreams {
+private:
+    static constexpr uint32_t RecordPageSize = 0x4000;
+
+    std::shared_ptr<const MsfReader> m_msf;
+    uint16_t m_symbolRecordStream = MsfReader::InvalidStream;
+    uint32_t m_symbolRecordSize = 0;
+    mutable std::unique_ptr<uint8_t[]> m_symbolRecords;
+    mutable std::vector<bool> m_loadedPages;
+    uint16_t m_machine = 0;
+    uint16_t m_globalsStream = MsfReader::InvalidStream;
+    std::array<uint16_t, static_cast<size_t>(DebugStream::Count)> m_debugStreams;
+    std::vector<uint32_t> m_sectionRvas;
+    DWORD64 m_imageSize = 0;
+    std::vector<OmapEntry> m_omapFromSource;
+    mutable GsiHashTable m_globals;
+    mutable bool m_globalsLoaded = false;
+    GsiHashTable m_publics;
+
+    const GsiHashTable& GetGlobals() const;
+    bool LoadRecords(uint32_t offset, uint32_t length) const noexcept;
+    bool ReadRecord(uint32_t offset, uint16_t& kind, const uint8_t*& body, uint16_t& bodyLength) const noexcept;
+    bool DecodeDataSymbol(uint32_t offset, NativeDataSymbol& symbol) const noexcept;
+    bool DecodePublicSymbol(uint32_t offset, NativePublicSymbol& symbol) const noexcept;
+
+public:
+    explicit SymbolStreams(std::shared_ptr<const MsfReader> msf);
+
+    static std::optional<uint16_t> ReadMachine(const MsfReader& msf);
+
+    uint16_t GetMachine() const noexcept { return m_machine; }
+    uint16_t GetDebugStream(DebugStream slot) const noexcept { return m_debugStreams[static_cast<size_t>(slot)]; }
+    uint16_t GetSectionHeaderStream() const noexcept { return GetDebugStream(DebugStream::SectionHeaders); }
+    // End of the highest section, or 0 without section headers.
+    DWORD64 GetImageSize() const noexcept { return m_imageSize; }
+
+    std::optional<NativeDataSymbol> FindGlobalData(std::string_view name) const;
+    void ForEachGlobalData(const std::function<bool(const NativeDataSymbol&)>& callback) const;
+    std::optional<NativePublicSymbol> FindPublic(std::string_view name) const;
+    void ForEachPublic(const std::function<bool(const NativePublicSymbol&)>& callback) const;
+    std::optional<DWORD64> SectionOffsetToRva(uint16_t section, uint32_t offset) const noexcept;
+};
@@ -0,0 +1,264 @@
+#include "Symbolizer.h"
+#include "BatchUtil.h"
+#include "Minidump.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    bool IsDumpFile(const std::filesystem::path& path) {
+        std::wstring extension = GetLowerExtension(path);
+        return extension == L".dmp" || extension == L".mdmp";
+    }
+
+    std::string FormatOffset(const std::string& prefix, DWORD64 offset) {
+        if (offset == 0) return prefix;
+
+        char buffer[32];
+        sprintf_s(buffer, "+0x%llx", static_cast<unsigned long long>(offset));
+        return prefix + buffer;
+    }
+}
+
+SymbolizerCache::SymbolizerCache(const std::wstring& storeDirectory, size_t budget)
+    : m_storeDirectory(storeDirectory), m_budget(budget) {
+}
+
+void SymbolizerCache::Evict(const std::string& keep, SymbolizerStats& stats) {
+    while (m_bytes > m_budget && !m_recency.empty() && m_recency.back() != keep) {
+        auto it = m_entries.find(m_recency.back());
+        m_bytes -= it->second.bytes;
+        if (it->second.found) stats.evictions++;
+
+        m_entries.erase(it);
+        m_recency.pop_back();
+    }
+}
+
+const std::vector<SymbolInfo>* SymbolizerCache::GetAddressTable(const PdbIdentity& identity, SymbolizerStats& stats) {
+    std::string key = identity.pdbName + "/" + identity.guidAge;
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        stats.cacheHits++;
+        m_recency.splice(m_recency.begin(), m_recency, it->second.recency);
+        return it->second.found ? &it->second.table : nullptr;
+    }
+
+    Entry entry;
+    SymbolServerConfig config;
+    config.storeDirectory = m_storeDirectory;
+    std::wstring pdbPath = PdbDownloader::GetStorePath(identity, config);
+
+    try {
+        std::error_code error;
+        if (std::filesystem::exists(pdbPath, error)) {
+            PdbParser parser(pdbPath);
+            entry.table = parser.GetAddressTable();
+            entry.found = true;
+
+            entry.bytes = entry.table.capacity() * sizeof(SymbolInfo);
+            for (const auto& symbol : entry.table) {
+                entry.bytes += symbol.name.capacity();
+            }
+        }
+    }
+    catch (...) {
+        entry.found = false;
+        entry.table.clear();
+        entry.bytes = 0;
+    }
+
+    if (entry.found) stats.pdbsLoaded++;
+    else stats.pdbsMissing++;
+
+    m_recency.push_front(key);
+    entry.recency = m_recency.begin();
+    m_bytes += entry.bytes;
+
+    Entry& inserted = m_entries.emplace(key, std::move(entry)).first->second;
+    Evict(key, stats);
+
+    return inserted.found ? &inserted.table : nullptr;
+}
+
+Symbolizer::Symbolizer(const SymbolizerOptions& options)
+    : m_options(options), m_cache(options.storeDirectory, options.cacheBytes) {
+}
+
+std::vector<SymbolizedDump> Symbolizer::Symbolize(const std::vector<std::wstring>& dumpPaths) {
+    TraceScope trace(TracePhase::Symbolize);
+    auto start = std::chrono::steady_clock::now();
+
+    struct PendingFrame {
+        uint32_t pdb;
+        DWORD64 rva;
+        size_t dump;
+        size_t thread;
+        size_t frame;
+        std::string moduleName;
+    };
+
+    std::vector<SymbolizedDump> dumps(dumpPaths.size());
+    std::vector<PendingFrame> pending;
+    std::vector<PdbIdentity> pdbs;
+    std::unordered_map<std::string, uint32_t> pdbIds;
+
+    // Every frame gets its module+offset form up front; frames in a module with a PDB identity are
+    // queued to be replaced by module!symbol+offset in the sweep below.
+    for (size_t d = 0; d < dumpPaths.size(); ++d) {
+        SymbolizedDump& result = dumps[d];
+        result.path = dumpPaths[d];
+        m_stats.dumps++;
+
+        try {
+            Minidump dump(dumpPaths[d], m_options.maxFrames);
+            result.loaded = true;
+
+            for (const auto& thread : dump.GetThreads()) {
+                SymbolizedThread symbolized;
+                symbolized.threadId = thread.threadId;
+                symbolized.crashed = thread.crashed;
+
+                for (size_t f = 0; f < thread.frames.size(); ++f) {
+                    SymbolizedFrame frame;
+                    frame.address = thread.frames[f];
+                    frame.scanned = f >= thread.contextFrames;
+
+                    auto moduleIndex = dump.FindModuleIndex(frame.address);
+                    if (!moduleIndex) {
+                        char buffer[32];
+                        sprintf_s(buffer, "0x%llx", static_cast<unsigned long long>(frame.address));
+                        frame.location = buffer;
+                    }
+                    else {
+                        const MinidumpModule& module = dump.GetModules()[*moduleIndex];
+                        DWORD64 rva = frame.address - module.base;
+                        frame.location = FormatOffset(module.name, rva);
+
+                        if (module.identity) {
+                            std::string key = module.identity->pdbName + "/" + module.identity->guidAge;
+                            auto [it, added] = pdbIds.emplace(key, static_cast<uint32_t>(pdbs.size()));
+                            if (added) pdbs.push_back(*module.identity);
+
+                            pending.push_back({ it->second, rva, d, result.threads.size(), symbolized.frames.size(), module.name });
+                        }
+                    }
+
+                    symbolized.frames.push_back(std::move(frame));
+                    m_stats.frames++;
+                }
+
+                result.threads.push_back(std::move(symbolized));
+            }
+        }
+        catch (...) {
+            m_stats.failedDumps++;
+        }
+    }
+
+    std::sort(pending.begin(), pending.end(), [](const PendingFrame& a, const PendingFrame& b) {
+        return a.pdb != b.pdb ? a.pdb < b.pdb : a.rva < b.rva;
+        });
+
+    // One PDB at a time, frames and symbols both ascending: the cursor only moves forward.
+    for (size_t first = 0; first < pending.size();) {
+        size_t last = first;
+        while (last < pending.size() && pending[last].pdb == pending[first].pdb) {
+            ++last;
+        }
+
+        const std::vector<SymbolInfo>* table = m_cache.GetAddressTable(pdbs[pending[first].pdb], m_stats);
+        if (table && !table->empty()) {
+            size_t cursor = 0;
+            for (size_t i = first; i < last; ++i) {
+                const PendingFrame& frame = pending[i];
+                while (cursor + 1 < table->size() && (*table)[cursor + 1].rva <= frame.rva) {
+                    ++cursor;
+                }
+
+                // Past the end of a sized symbol is padding or code without a symbol: keep module+offset.
+                const SymbolInfo& symbol = (*table)[cursor];
+                if (symbol.rva > frame.rva || (symbol.size != 0 && frame.rva - symbol.rva >= symbol.size)) continue;
+
+                dumps[frame.dump].threads[frame.thread].frames[frame.frame].location =
+                    FormatOffset(frame.moduleName + "!" + symbol.name, frame.rva - symbol.rva);
+                m_stats.resolvedFrames++;
+            }
+        }
+
+        first = last;
+    }
+
+    m_stats.wallUs += ElapsedUs(start);
+    return dumps;
+}
+
+void Symbolizer::PrintDump(std::ostream& out, const SymbolizedDump& dump) {
+    out << "Dump: " << WStringToString(dump.path) << "\n";
+    if (!dump.loaded) {
+        out << "  (not a readable minidump)\n";
+        return;
+    }
+
+    for (const auto& thread : dump.threads) {
+        out << "\nThread " << thread.threadId << (thread.crashed ? " (crashed)" : "") << "\n";
+
+        for (size_t i = 0; i < thread.frames.size(); ++i) {
+            const auto& frame = thread.frames[i];
+            char prefix[48];
+            sprintf_s(prefix, "  %02zu  %016llx  ", i, static_cast<unsigned long long>(frame.address));
+            out << prefix << frame.location << (frame.scanned ? "  [scan]" : "") << "\n";
+        }
+    }
+}
+
+void Symbolizer::PrintStats(const SymbolizerStats& stats) {
+    std::cout << "Dumps:          " << stats.dumps << " (" << stats.failedDumps << " unreadable)\n";
+    std::cout << "Frames:         " << stats.frames << " (" << stats.resolvedFrames << " resolved to a symbol)\n";
+    std::cout << "PDBs loaded:    " << stats.pdbsLoaded << " (" << stats.pdbsMissing << " not in store, "
+        << stats.cacheHits << " cache hits, " << stats.evictions << " evicted)\n";
+    std::cout << "Wall time:      " << stats.wallUs / 1000 << "ms\n";
+}
+
+SymbolizerStats Symbolizer::ProcessDirectory(const std::wstring& directory, const std::wstring& outputDirectory,
+    const SymbolizerOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::wstring> found;
+    std::error_code error;
+    for (std::filesystem::recursive_directory_iterator it(directory,
+        std::filesystem::directory_options::skip_permission_denied, error), end;
+        !error && it != end; it.increment(error)) {
+        if (it->is_regular_file(error) && IsDumpFile(it->path())) {
+            found.push_back(it->path().wstring());
+        }
+    }
+    std::sort(found.begin(), found.end());
+
+    std::filesystem::create_directories(outputDirectory);
+
+    Symbolizer symbolizer(options);
+    size_t sweepSize = (std::max<size_t>)(1, options.dumpsPerSweep);
+
+    for (size_t first = 0; first < found.size(); first += sweepSize) {
+        std::vector<std::wstring> sweep(found.begin() + first, found.begin() + (std::min)(first + sweepSize, found.size()));
+
+        for (const auto& dump : symbolizer.Symbolize(sweep)) {
+            std::wstring reportPath = (std::filesystem::path(outputDirectory) /
+                std::filesystem::path(dump.path).filename()).wstring() + L".txt";
+            std::ofstream report(reportPath, std::ios::trunc);
+            if (report.is_open()) {
+                PrintDump(report, dump);
+            }
+        }
+    }
+
+    SymbolizerStats stats = symbolizer.GetStats();
+    stats.wallUs = ElapsedUs(start);
+    return stats;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "PdbParser.h"
+#include <list>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct SymbolizerOptions {
+    std::wstring storeDirectory = L"C:\\Symbols";
+    size_t cacheBytes = 512ull * 1024 * 1024;
+    size_t maxFrames = 64;
+    size_t dumpsPerSweep = 64;
+};
+
+struct SymbolizerStats {
+    size_t dumps = 0;
+    size_t failedDumps = 0;
+    size_t frames = 0;
+    size_t resolvedFrames = 0;
+    size_t pdbsLoaded = 0;
+    size_t pdbsMissing = 0;
+    size_t cacheHits = 0;
+    size_t evictions = 0;
+    uint64_t wallUs = 0;
+};
+
+struct SymbolizedFrame {
+    DWORD64 address = 0;
+    bool scanned = false;
+    std::string location;
+};
+
+struct SymbolizedThread {
+    DWORD threadId = 0;
+    bool crashed = false;
+    std::vector<SymbolizedFrame> frames;
+};
+
+struct SymbolizedDump {
+    std::wstring path;
+    bool loaded = false;
+    std::vector<SymbolizedThread> threads;
+};
+
+// PDBs opened for symbolization, keyed by PDB name and GUID+age and found in a local store laid out
+// as <store>\<pdb>\<GUID+age>\<pdb>. Each PDB is opened once, its address table kept and the PDB
+// closed again, so the byte budget covers everything the cache holds; the table is reused by every
+// dump that loaded the module, and once the tables exceed the budget the least recently used are
+// dropped. PDBs missing from the store are remembered so later dumps do not probe for them again.
+class SymbolizerCache {
+private:
+    struct Entry {
+        bool found = false;
+        std::vector<SymbolInfo> table;
+        size_t bytes = 0;
+        std::list<std::string>::iterator recency;
+    };
+
+    std::wstring m_storeDirectory;
+    size_t m_budget;
+    size_t m_bytes = 0;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_recency;
+
+    void Evict(const std::string& keep, SymbolizerStats& stats);
+
+public:
+    SymbolizerCache(const std::wstring& storeDirectory, size_t budget);
+
+    // The module's address table, or nullptr if its PDB is not in the store. The table stays valid
+    // until the next call, which may evict it.
+    const std::vector<SymbolInfo>* GetAddressTable(const PdbIdentity& identity, SymbolizerStats& stats);
+};
+
+// Resolves every thread's frames of a set of minidumps to module!symbol+offset. Frames from all dumps
+// in a sweep are sorted by PDB and RVA and resolved in one forward pass over each PDB's sorted address
+// table, so each PDB is touched once per sweep however many dumps or frames land in it.
+class Symbolizer {
+private:
+    SymbolizerOptions m_options;
+    SymbolizerCache m_cache;
+    SymbolizerStats m_stats;
+
+public:
+    explicit Symbolizer(const SymbolizerOptions& options);
+
+    std::vector<SymbolizedDump> Symbolize(const std::vector<std::wstring>& dumpPaths);
+    const SymbolizerStats& GetStats() const noexcept { return m_stats; }
+
+    static void PrintDump(std::ostream& out, const SymbolizedDump& dump);
+    static void PrintStats(const SymbolizerStats& stats);
+
+    // Symbolizes every *.dmp under a directory in sweeps of options.dumpsPerSweep, writing one
+    // <dump>.txt report per dump to the output directory.
+    static SymbolizerStats ProcessDirectory(const std::wstring& directory, const std::wstring& outputDirectory,
+        const SymbolizerOptions& options);
+};
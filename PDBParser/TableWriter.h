@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+// Helpers for the mappable file formats (snapshots, store indexes, PDBC), whose tables start on
+// 8-byte boundaries so they can be read in place from the mapping.
+inline uint64_t AlignUp(uint64_t value) {
+    return (value + 7) & ~7ull;
+}
+
+inline void WritePadding(std::ofstream& file, uint64_t& position) {
+    static const char zeros[8] = {};
+    uint64_t aligned = AlignUp(position);
+    file.write(zeros, static_cast<std::streamsize>(aligned - position));
+    position = aligned;
+}
+
+template<typename T>
+void WriteTable(std::ofstream& file, uint64_t& position, const std::vector<T>& entries) {
+    WritePadding(file, position);
+    file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(T)));
+    position += entries.size() * sizeof(T);
+}
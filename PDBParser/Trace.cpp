@@ -0,0 +1,209 @@
+#include "Trace.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    const char* const CounterNames[] = {
+        "enumerations",
+        "symbols_visited",
+        "undecorations",
+        "symbol_cache_hits",
+        "symbol_cache_misses",
+        "struct_cache_hits",
+        "struct_cache_misses",
+        "structs_decoded",
+        "records_exported",
+        "arena_bytes_reserved"
+    };
+
+    const char* const PhaseNames[] = {
+        "OpenPdb",
+        "Enumerate",
+        "Undecorate",
+        "DecodeSymbol",
+        "DecodeStruct",
+        "DecodeFunction",
+        "SymbolLookup",
+        "StructLookup",
+        "PatternSearch",
+        "PreloadSymbols",
+        "PreloadStructures",
+        "ScanImage",
+        "FetchPdb",
+        "LayoutHashes",
+        "ExportJson",
+        "ExportNdjson",
+        "ExportColumnar",
+        "SaveSnapshot",
+        "LoadSnapshot",
+        "IndexPdb",
+        "QueryIndex",
+        "LayoutReport",
+        "ClassHierarchy",
+        "ReducePdb",
+        "ExportSymbolFile",
+        "Symbolize",
+        "WalkMemory"
+    };
+
+    static_assert(std::size(CounterNames) == static_cast<size_t>(TraceCounter::Count), "counter names out of sync");
+    static_assert(std::size(PhaseNames) == static_cast<size_t>(TracePhase::Count), "phase names out of sync");
+
+    size_t BucketFor(uint64_t durationUs) noexcept {
+        size_t bucket = 0;
+        while (durationUs != 0 && bucket + 1 < 32) {
+            durationUs >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    double Ratio(uint64_t hits, uint64_t misses) noexcept {
+        uint64_t total = hits + misses;
+        return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+}
+
+Tracer& Tracer::Instance() {
+    static Tracer instance;
+    return instance;
+}
+
+const char* Tracer::GetCounterName(TraceCounter counter) noexcept {
+    return CounterNames[static_cast<size_t>(counter)];
+}
+
+const char* Tracer::GetPhaseName(TracePhase phase) noexcept {
+    return PhaseNames[static_cast<size_t>(phase)];
+}
+
+uint32_t Tracer::CurrentThreadId() noexcept {
+    static std::atomic<uint32_t> nextId{ 1 };
+    thread_local uint32_t threadId = nextId++;
+    return threadId;
+}
+
+// Per-item phases run once per symbol or member and would flood the timeline, so they only feed
+// the histograms.
+bool Tracer::IsTimelinePhase(TracePhase phase) noexcept {
+    return phase != TracePhase::Undecorate &&
+        phase != TracePhase::DecodeSymbol &&
+        phase != TracePhase::DecodeStruct &&
+        phase != TracePhase::DecodeFunction;
+}
+
+uint64_t Tracer::NowUs() const noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_epoch).count());
+}
+
+void Tracer::Record(TracePhase phase, uint64_t startUs, uint64_t durationUs) {
+    auto& stats = m_phases[static_cast<size_t>(phase)];
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.totalUs.fetch_add(durationUs, std::memory_order_relaxed);
+    stats.buckets[BucketFor(durationUs)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t currentMax = stats.maxUs.load(std::memory_order_relaxed);
+    while (durationUs > currentMax &&
+        !stats.maxUs.compare_exchange_weak(currentMax, durationUs, std::memory_order_relaxed)) {
+    }
+
+    if (!IsTimelinePhase(phase)) return;
+
+    try {
+        std::lock_guard<std::mutex> guard(m_eventLock);
+        if (m_events.size() < MaxEvents) {
+            m_events.push_back(TraceEvent{ phase, CurrentThreadId(), startUs, durationUs });
+        }
+        else {
+            ++m_droppedEvents;
+        }
+    }
+    catch (...) {
+    }
+}
+
+bool Tracer::WriteChromeTrace(const std::wstring& outputPath) {
+    try {
+        std::ofstream file(outputPath);
+        if (!file.is_open()) return false;
+
+        std::lock_guard<std::mutex> guard(m_eventLock);
+
+        std::vector<TraceEvent> events = m_events;
+        std::sort(events.begin(), events.end(),
+            [](const TraceEvent& a, const TraceEvent& b) { return a.startUs < b.startUs; });
+
+        uint64_t endUs = NowUs();
+
+        file << "{\n";
+        file << "  \"displayTimeUnit\": \"ms\",\n";
+        file << "  \"traceEvents\": [\n";
+
+        bool first = true;
+        for (const auto& event : events) {
+            file << (first ? "" : ",\n");
+            file << "    {\"name\": \"" << PhaseNames[static_cast<size_t>(event.phase)]
+                << "\", \"cat\": \"pdbparser\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.threadId
+                << ", \"ts\": " << event.startUs << ", \"dur\": " << event.durationUs << "}";
+            first = false;
+        }
+
+        for (size_t i = 0; i < static_cast<size_t>(TraceCounter::Count); ++i) {
+            file << (first ? "" : ",\n");
+            file << "    {\"name\": \"" << CounterNames[i] << "\", \"cat\": \"pdbparser\", \"ph\": \"C\", \"pid\": 1, \"ts\": "
+                << endUs << ", \"args\": {\"value\": " << m_counters[i].load(std::memory_order_relaxed) << "}}";
+            first = false;
+        }
+
+        file << "\n  ],\n";
+
+        file << "  \"counters\": {\n";
+        for (size_t i = 0; i < static_cast<size_t>(TraceCounter::Count); ++i) {
+            file << "    \"" << CounterNames[i] << "\": " << m_counters[i].load(std::memory_order_relaxed)
+                << (i + 1 < static_cast<size_t>(TraceCounter::Count) ? ",\n" : "\n");
+        }
+        file << "  },\n";
+
+        file << "  \"cache_hit_rate\": {\n";
+        file << "    \"symbols\": " << Ratio(GetCounter(TraceCounter::SymbolCacheHits), GetCounter(TraceCounter::SymbolCacheMisses)) << ",\n";
+        file << "    \"structs\": " << Ratio(GetCounter(TraceCounter::StructCacheHits), GetCounter(TraceCounter::StructCacheMisses)) << "\n";
+        file << "  },\n";
+
+        file << "  \"phases\": {";
+        first = true;
+        for (size_t i = 0; i < static_cast<size_t>(TracePhase::Count); ++i) {
+            const auto& stats = m_phases[i];
+            uint64_t count = stats.count.load(std::memory_order_relaxed);
+            if (count == 0) continue;
+
+            file << (first ? "\n" : ",\n");
+            file << "    \"" << PhaseNames[i] << "\": {\"count\": " << count
+                << ", \"total_us\": " << stats.totalUs.load(std::memory_order_relaxed)
+                << ", \"max_us\": " << stats.maxUs.load(std::memory_order_relaxed)
+                << ", \"histogram_us\": [";
+
+            bool firstBucket = true;
+            for (size_t bucket = 0; bucket < HistogramBuckets; ++bucket) {
+                uint64_t bucketCount = stats.buckets[bucket].load(std::memory_order_relaxed);
+                if (bucketCount == 0) continue;
+
+                file << (firstBucket ? "" : ", ") << "[" << (1ULL << bucket) << ", " << bucketCount << "]";
+                firstBucket = false;
+            }
+
+            file << "]}";
+            first = false;
+        }
+        file << "\n  },\n";
+
+        file << "  \"dropped_events\": " << m_droppedEvents << "\n";
+        file << "}\n";
+
+        return file.good();
+    }
+    catch (...) {
+        return false;
+    }
+}
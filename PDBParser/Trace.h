@@ -0,0 +1,146 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class TraceCounter : size_t {
+    Enumerations,
+    SymbolsVisited,
+    Undecorations,
+    SymbolCacheHits,
+    SymbolCacheMisses,
+    StructCacheHits,
+    StructCacheMisses,
+    StructsDecoded,
+    RecordsExported,
+    ArenaBytesReserved,
+    Count
+};
+
+enum class TracePhase : size_t {
+    OpenPdb,
+    Enumerate,
+    Undecorate,
+    DecodeSymbol,
+    DecodeStruct,
+    DecodeFunction,
+    SymbolLookup,
+    StructLookup,
+    PatternSearch,
+    PreloadSymbols,
+    PreloadStructures,
+    ScanImage,
+    FetchPdb,
+    LayoutHashes,
+    ExportJson,
+    ExportNdjson,
+    ExportColumnar,
+    SaveSnapshot,
+    LoadSnapshot,
+    IndexPdb,
+    QueryIndex,
+    LayoutReport,
+    ClassHierarchy,
+    ReducePdb,
+    ExportSymbolFile,
+    Symbolize,
+    WalkMemory,
+    Count
+};
+
+struct TraceEvent {
+    TracePhase phase;
+    uint32_t threadId;
+    uint64_t startUs;
+    uint64_t durationUs;
+};
+
+// Process-wide instrumentation. Everything is a no-op until Enable() is called, so the cost on the
+// hot paths is a single relaxed load; defining PDBPARSER_DISABLE_TRACE compiles it out entirely.
+class Tracer {
+private:
+    static constexpr size_t HistogramBuckets = 32;
+    static constexpr size_t MaxEvents = 1000000;
+
+    struct PhaseStats {
+        std::atomic<uint64_t> count{ 0 };
+        std::atomic<uint64_t> totalUs{ 0 };
+        std::atomic<uint64_t> maxUs{ 0 };
+        std::array<std::atomic<uint64_t>, HistogramBuckets> buckets{};
+    };
+
+    static inline std::atomic<bool> s_enabled{ false };
+
+    std::chrono::steady_clock::time_point m_epoch;
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(TraceCounter::Count)> m_counters{};
+    std::array<PhaseStats, static_cast<size_t>(TracePhase::Count)> m_phases;
+
+    std::mutex m_eventLock;
+    std::vector<TraceEvent> m_events;
+    size_t m_droppedEvents = 0;
+
+    Tracer() : m_epoch(std::chrono::steady_clock::now()) {}
+
+    static uint32_t CurrentThreadId() noexcept;
+    static bool IsTimelinePhase(TracePhase phase) noexcept;
+
+public:
+    static Tracer& Instance();
+
+    static bool IsEnabled() noexcept {
+#ifdef PDBPARSER_DISABLE_TRACE
+        return false;
+#else
+        return s_enabled.load(std::memory_order_relaxed);
+#endif
+    }
+
+    static void Enable() noexcept { s_enabled.store(true, std::memory_order_relaxed); }
+
+    static void Count(TraceCounter counter, uint64_t value = 1) noexcept {
+        if (IsEnabled()) {
+            Instance().m_counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    static const char* GetCounterName(TraceCounter counter) noexcept;
+    static const char* GetPhaseName(TracePhase phase) noexcept;
+
+    uint64_t NowUs() const noexcept;
+    void Record(TracePhase phase, uint64_t startUs, uint64_t durationUs);
+
+    uint64_t GetCounter(TraceCounter counter) const noexcept {
+        return m_counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+
+    bool WriteChromeTrace(const std::wstring& outputPath);
+};
+
+class TraceScope {
+private:
+    TracePhase m_phase;
+    uint64_t m_startUs;
+    bool m_active;
+
+public:
+    explicit TraceScope(TracePhase phase) noexcept
+        : m_phase(phase), m_startUs(0), m_active(Tracer::IsEnabled()) {
+        if (m_active) {
+            m_startUs = Tracer::Instance().NowUs();
+        }
+    }
+
+    ~TraceScope() {
+        if (m_active) {
+            auto& tracer = Tracer::Instance();
+            tracer.Record(m_phase, m_startUs, tracer.NowUs() - m_startUs);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
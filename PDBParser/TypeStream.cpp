@@ -0,0 +1,432 @@
+#include "TypeStream.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+    constexpr uint32_t TpiStream = 2;
+    constexpr size_t TpiHeaderSize = 56;
+    constexpr size_t MaxTypeChain = 32;
+    constexpr size_t MaxFieldListContinuations = 4096;
+
+    template<typename T>
+    bool ReadValue(const std::vector<uint8_t>& data, size_t offset, T& value) noexcept {
+        if (offset + sizeof(T) > data.size()) return false;
+        memcpy(&value, data.data() + offset, sizeof(T));
+        return true;
+    }
+
+    // Records that may carry a UDT definition; used to build the name index without decoding
+    // every pointer, array and procedure in the stream.
+    using UdtDispatcher = CodeView::Dispatcher<
+        CodeViewRecord::Structure, CodeViewRecord::Class, CodeViewRecord::Interface, CodeViewRecord::Union>;
+
+    template<typename Record>
+    constexpr bool IsUdtRecord = std::is_base_of_v<CodeViewRecord::Structure, Record> ||
+        std::is_same_v<CodeViewRecord::Union, Record>;
+
+    // Sizes of the built-in types encoded directly in type indices below 0x1000.
+    uint64_t GetSimpleTypeSize(uint32_t typeIndex) noexcept {
+        switch ((typeIndex >> 8) & 0xF) {
+        case 0: break;
+        case 1: case 2: case 3: return 2;
+        case 4: case 5: return 4;
+        case 6: return 8;
+        case 7: return 16;
+        default: return 0;
+        }
+
+        switch (typeIndex & 0xFF) {
+        case 0x10: case 0x20: case 0x30: case 0x68: case 0x69: case 0x70: case 0x7C: return 1;
+        case 0x11: case 0x21: case 0x31: case 0x71: case 0x72: case 0x73: case 0x7A: return 2;
+        case 0x12: case 0x22: case 0x32: case 0x40: case 0x74: case 0x75: case 0x7B: return 4;
+        case 0x13: case 0x23: case 0x33: case 0x41: case 0x76: case 0x77: return 8;
+        case 0x42: return 10;
+        case 0x14: case 0x24: case 0x78: case 0x79: case 0x43: return 16;
+        default: return 0;
+        }
+    }
+}
+
+TypeStream::TypeStream(const MsfReader& msf) {
+    std::vector<uint8_t> stream;
+    if (!msf.ReadStream(TpiStream, stream) || stream.size() < TpiHeaderSize) {
+        throw std::runtime_error("PDB has no TPI stream");
+    }
+
+    uint32_t headerSize = 0, typeIndexBegin = 0, typeIndexEnd = 0, recordBytes = 0;
+    ReadValue(stream, 4, headerSize);
+    ReadValue(stream, 8, typeIndexBegin);
+    ReadValue(stream, 12, typeIndexEnd);
+    ReadValue(stream, 16, recordBytes);
+
+    if (headerSize < TpiHeaderSize || headerSize > stream.size() || recordBytes > stream.size() - headerSize ||
+        typeIndexEnd < typeIndexBegin) {
+        throw std::runtime_error("PDB has a malformed TPI header");
+    }
+
+    m_typeIndexBegin = typeIndexBegin;
+    m_records.assign(stream.begin() + headerSize, stream.begin() + headerSize + recordBytes);
+    m_recordOffsets.reserve(typeIndexEnd - typeIndexBegin);
+
+    for (size_t offset = 0; offset + 2 * sizeof(uint16_t) <= m_records.size();) {
+        uint16_t length = 0;
+        ReadValue(m_records, offset, length);
+        if (length < sizeof(uint16_t) || offset + sizeof(uint16_t) + length > m_records.size()) break;
+
+        m_recordOffsets.push_back(static_cast<uint32_t>(offset));
+        offset += sizeof(uint16_t) + length;
+    }
+
+    // First definition wins, matching the order DIA enumerates UDTs of the same name in.
+    for (uint32_t i = 0; i < m_recordOffsets.size(); ++i) {
+        uint32_t typeIndex = m_typeIndexBegin + i;
+        auto visitor = [&](const auto& record) {
+            if (!(record.property & CodeView::PropertyForwardRef)) {
+                m_udtsByName.emplace(record.name, typeIndex);
+            }
+        };
+
+        uint16_t kind = 0;
+        const uint8_t* body = nullptr;
+        uint16_t bodyLength = 0;
+        size_t consumed = 0;
+        if (ReadRecord(typeIndex, kind, body, bodyLength)) {
+            UdtDispatcher::Dispatch(kind, body, bodyLength, visitor, consumed);
+        }
+    }
+}
+
+bool TypeStream::ReadRecord(uint32_t typeIndex, uint16_t& kind, const uint8_t*& body, uint16_t& bodyLength) const noexcept {
+    if (typeIndex < m_typeIndexBegin || typeIndex - m_typeIndexBegin >= m_recordOffsets.size()) return false;
+
+    uint32_t offset = m_recordOffsets[typeIndex - m_typeIndexBegin];
+    uint16_t length = 0;
+    ReadValue(m_records, offset, length);
+    ReadValue(m_records, offset + sizeof(uint16_t), kind);
+
+    body = m_records.data() + offset + 2 * sizeof(uint16_t);
+    bodyLength = static_cast<uint16_t>(length - sizeof(uint16_t));
+    return true;
+}
+
+bool TypeStream::GetRecord(uint32_t typeIndex, const uint8_t*& record, size_t& size) const noexcept {
+    uint16_t kind = 0;
+    const uint8_t* body = nullptr;
+    uint16_t bodyLength = 0;
+    if (!ReadRecord(typeIndex, kind, body, bodyLength)) return false;
+
+    record = body - 2 * sizeof(uint16_t);
+    size = 2 * sizeof(uint16_t) + bodyLength;
+    return true;
+}
+
+template<typename Visitor>
+bool TypeStream::VisitType(uint32_t typeIndex, Visitor& visitor) const {
+    uint16_t kind = 0;
+    const uint8_t* body = nullptr;
+    uint16_t bodyLength = 0;
+    size_t consumed = 0;
+
+    return ReadRecord(typeIndex, kind, body, bodyLength) &&
+        CodeViewTypeDispatcher::Dispatch(kind, body, bodyLength, visitor, consumed);
+}
+
+template<typename Visitor>
+bool TypeStream::VisitFieldList(uint32_t fieldList, Visitor& visitor) const {
+    for (size_t continuations = 0; fieldList != 0 && continuations < MaxFieldListContinuations; ++continuations) {
+        uint16_t kind = 0;
+        const uint8_t* body = nullptr;
+        uint16_t bodyLength = 0;
+        if (!ReadRecord(fieldList, kind, body, bodyLength) ||
+            kind != static_cast<uint16_t>(CodeViewLeafKind::LF_FIELDLIST)) {
+            return false;
+        }
+
+        // Long field lists are split into several records chained through a trailing LF_INDEX.
+        uint32_t continuation = 0;
+        auto walker = [&](const auto& record) {
+            using Record = std::decay_t<decltype(record)>;
+            if constexpr (std::is_same_v<CodeViewRecord::Index, Record>) {
+                continuation = record.continuation;
+            }
+            else {
+                visitor(record);
+            }
+        };
+
+        size_t position = 0;
+        while (position + sizeof(uint16_t) <= bodyLength) {
+            uint16_t memberKind = 0;
+            memcpy(&memberKind, body + position, sizeof(memberKind));
+            position += sizeof(memberKind);
+
+            size_t consumed = 0;
+            if (!CodeViewFieldDispatcher::Dispatch(memberKind, body + position, bodyLength - position, walker, consumed)) {
+                return false;
+            }
+            position = CodeView::SkipPadding(body, bodyLength, position + consumed);
+        }
+
+        fieldList = continuation;
+    }
+
+    return true;
+}
+
+std::optional<uint32_t> TypeStream::FindUdt(std::string_view name) const {
+    auto it = m_udtsByName.find(name);
+    if (it == m_udtsByName.end()) return std::nullopt;
+    return it->second;
+}
+
+std::vector<uint32_t> TypeStream::GetUdtTypeIndices() const {
+    std::vector<uint32_t> typeIndices;
+    typeIndices.reserve(m_udtsByName.size());
+    for (const auto& entry : m_udtsByName) {
+        typeIndices.push_back(entry.second);
+    }
+
+    std::sort(typeIndices.begin(), typeIndices.end());
+    return typeIndices;
+}
+
+uint64_t TypeStream::GetTypeSize(uint32_t typeIndex) const {
+    for (size_t depth = 0; depth < MaxTypeChain; ++depth) {
+        if (typeIndex < CodeView::FirstNonSimpleType) return GetSimpleTypeSize(typeIndex);
+
+        uint64_t size = 0;
+        std::optional<uint32_t> next;
+        auto visitor = [&](const auto& record) {
+            using Record = std::decay_t<decltype(record)>;
+            if constexpr (IsUdtRecord<Record>) {
+                if (record.property & CodeView::PropertyForwardRef) {
+                    auto definition = FindUdt(record.name);
+                    if (definition && *definition != typeIndex) next = *definition;
+                }
+                else {
+                    size = record.size.value;
+                }
+            }
+            else if constexpr (std::is_same_v<CodeViewRecord::Pointer, Record>) {
+                size = record.GetSize();
+            }
+            else if constexpr (std::is_same_v<CodeViewRecord::Array, Record>) {
+                size = record.size.value;
+            }
+            else if constexpr (std::is_same_v<CodeViewRecord::Modifier, Record>) {
+                next = record.modifiedType;
+            }
+            else if constexpr (std::is_same_v<CodeViewRecord::Enum, Record>) {
+                next = record.underlyingType;
+            }
+            else if constexpr (std::is_same_v<CodeViewRecord::Bitfield, Record>) {
+                next = record.type;
+            }
+        };
+
+        if (!VisitType(typeIndex, visitor)) return 0;
+        if (!next) return size;
+        typeIndex = *next;
+    }
+
+    return 0;
+}
+
+uint32_t TypeStream::StripModifiers(uint32_t typeIndex) const {
+    for (size_t depth = 0; depth < MaxTypeChain && typeIndex >= CodeView::FirstNonSimpleType; ++depth) {
+        std::optional<uint32_t> next;
+        auto visitor = [&](const auto& record) {
+            using Record = std::decay_t<decltype(record)>;
+            if constexpr (std::is_same_v<CodeViewRecord::Modifier, Record>) {
+                next = record.modifiedType;
+            }
+        };
+
+        if (!VisitType(typeIndex, visitor) || !next) break;
+        typeIndex = *next;
+    }
+    return typeIndex;
+}
+
+// Fills in what a field path needs to step through the member: the UDT it is, holds or points to,
+// its array stride and its bit range. Bitfield members report their width in bits, as DIA's
+// get_length does for LocIsBitField.
+void TypeStream::DescribeMemberType(NativeUdtMember& member) const {
+    member.size = GetTypeSize(member.typeIndex);
+
+    uint32_t typeIndex = StripModifiers(member.typeIndex);
+    bool indexed = false;
+
+    for (size_t depth = 0; depth < MaxTypeChain && typeIndex >= CodeView::FirstNonSimpleType; ++depth) {
+        std::optional<uint32_t> next;
+        auto visitor = [&](const auto& record) {
+            using Record = std::decay_t<decltype(record)>;
+            if constexpr (IsUdtRecord<Record>) {
+                member.typeName = record.name;
+            }
+            else if constexpr (std::is_same_v<CodeViewRecord::Bitfield, Record>) {
+                member.bitPosition = record.position;
+                member.bitLength = record.length;
+                member.size = record.length;
+            }
+            else if constexpr (std::is_same_v<CodeViewRecord::Array, Record>) {
+                // Only the outermost dimension is indexable; inner dimensions stay opaque.
+                if (!indexed) {
+                    member.elementSize = GetTypeSize(record.elementType);
+                    member.elementCount = member.elementSize != 0 ?
+                        static_cast<uint32_t>(record.size.value / member.elementSize) : 0;
+                    indexed = true;
+                    next = record.elementType;
+                }
+            }
+            else if constexpr (std::is_same_v<CodeViewRecord::Pointer, Record>) {
+                if (!member.isPointer) {
+                    member.isPointer = true;
+                    next = record.referentType;
+                }
+            }
+        };
+
+        if (!VisitType(typeIndex, visitor) || !next) break;
+        typeIndex = StripModifiers(*next);
+    }
+}
+
+std::string_view TypeStream::GetUdtName(uint32_t typeIndex) const {
+    std::string_view name;
+    auto visitor = [&](const auto& record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (IsUdtRecord<Record>) {
+            name = record.name;
+        }
+    };
+
+    VisitType(StripModifiers(typeIndex), visitor);
+    return name;
+}
+
+uint32_t TypeStream::GetArgumentList(uint32_t functionType) const {
+    uint32_t argumentList = 0;
+    auto visitor = [&](const auto& record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (std::is_same_v<CodeViewRecord::MemberFunction, Record>) {
+            argumentList = record.argumentList;
+        }
+    };
+
+    VisitType(functionType, visitor);
+    return argumentList;
+}
+
+void TypeStream::AddVirtualMethod(std::string_view name, uint16_t attributes, uint32_t functionType, uint32_t vtableOffset,
+    NativeClass& cls) const {
+    using CodeView::MethodProperty;
+
+    MethodProperty property = CodeView::GetMethodProperty(attributes);
+    bool introducing = property == MethodProperty::IntroducingVirtual || property == MethodProperty::PureIntroducingVirtual;
+    bool isPure = property == MethodProperty::PureVirtual || property == MethodProperty::PureIntroducingVirtual;
+    if (!introducing && !isPure && property != MethodProperty::Virtual) return;
+
+    cls.virtualMethods.push_back({ name, GetArgumentList(functionType),
+        introducing ? std::optional<uint32_t>(vtableOffset) : std::nullopt, isPure });
+}
+
+bool TypeStream::DecodeUdt(uint32_t typeIndex, NativeUdt& udt) const {
+    bool found = false;
+    uint32_t fieldList = 0;
+    auto udtVisitor = [&](const auto& record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (IsUdtRecord<Record>) {
+            udt.name = record.name;
+            udt.size = record.size.value;
+            udt.isUnion = std::is_same_v<CodeViewRecord::Union, Record>;
+            fieldList = record.fieldList;
+            found = true;
+        }
+    };
+
+    if (!VisitType(typeIndex, udtVisitor) || !found) return false;
+
+    udt.members.clear();
+    auto memberVisitor = [&](const auto& record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (std::is_same_v<CodeViewRecord::Member, Record>) {
+            udt.members.push_back({ record.name, record.offset.value, 0, record.type, {}, 0, 0, 0, 0, false });
+        }
+    };
+
+    if (fieldList != 0 && !VisitFieldList(fieldList, memberVisitor)) return false;
+
+    for (auto& member : udt.members) {
+        DescribeMemberType(member);
+    }
+
+    std::stable_sort(udt.members.begin(), udt.members.end(),
+        [](const NativeUdtMember& a, const NativeUdtMember& b) { return a.offset < b.offset; });
+
+    return true;
+}
+
+bool TypeStream::DecodeClass(uint32_t typeIndex, NativeClass& cls) const {
+    bool found = false;
+    uint32_t fieldList = 0;
+    auto classVisitor = [&](const auto& record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (std::is_base_of_v<CodeViewRecord::Structure, Record>) {
+            cls.name = record.name;
+            cls.size = record.size.value;
+            fieldList = record.fieldList;
+            found = true;
+        }
+    };
+
+    if (!VisitType(typeIndex, classVisitor) || !found) return false;
+
+    cls.bases.clear();
+    cls.virtualMethods.clear();
+    std::vector<CodeViewRecord::Method> overloadSets;
+
+    auto fieldVisitor = [&](const auto& record) {
+        using Record = std::decay_t<decltype(record)>;
+        if constexpr (std::is_same_v<CodeViewRecord::BaseClass, Record>) {
+            cls.bases.push_back({ GetUdtName(record.type), record.offset.value, false, false, 0, 0 });
+        }
+        else if constexpr (std::is_base_of_v<CodeViewRecord::VirtualBaseClass, Record>) {
+            cls.bases.push_back({ GetUdtName(record.type), 0, true,
+                std::is_same_v<CodeViewRecord::IndirectVirtualBaseClass, Record>,
+                record.vbptrOffset.value, record.vbtableIndex.value });
+        }
+        else if constexpr (std::is_same_v<CodeViewRecord::OneMethod, Record>) {
+            AddVirtualMethod(record.name, record.attributes, record.type, record.vtableOffset.value, cls);
+        }
+        else if constexpr (std::is_same_v<CodeViewRecord::Method, Record>) {
+            overloadSets.push_back(record);
+        }
+    };
+
+    if (fieldList != 0 && !VisitFieldList(fieldList, fieldVisitor)) return false;
+
+    // Overloaded methods share one LF_METHOD entry pointing at a list with one entry per overload.
+    for (const auto& overloads : overloadSets) {
+        uint16_t kind = 0;
+        const uint8_t* body = nullptr;
+        uint16_t bodyLength = 0;
+        if (!ReadRecord(overloads.methodList, kind, body, bodyLength) ||
+            kind != static_cast<uint16_t>(CodeViewLeafKind::LF_METHODLIST)) {
+            continue;
+        }
+
+        for (size_t position = 0; position < bodyLength;) {
+            CodeViewRecord::MethodListEntry entry{};
+            size_t consumed = CodeView::Decode(body + position, bodyLength - position, entry);
+            if (consumed == 0) break;
+
+            AddVirtualMethod(overloads.name, entry.attributes, entry.type, entry.vtableOffset.value, cls);
+            position += consumed;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "MsfReader.h"
+#include "CodeView.h"
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct NativeUdtMember {
+    std::string_view name;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t typeIndex;
+    std::string_view typeName;
+    uint64_t elementSize;
+    uint32_t elementCount;
+    uint8_t bitPosition;
+    uint8_t bitLength;
+    bool isPointer;
+};
+
+struct NativeUdt {
+    std::string_view name;
+    uint64_t size = 0;
+    bool isUnion = false;
+    std::vector<NativeUdtMember> members;
+};
+
+struct NativeBaseClass {
+    std::string_view name;
+    uint64_t offset;
+    bool isVirtual;
+    bool isIndirect;
+    uint64_t vbptrOffset;
+    uint64_t vbtableIndex;
+};
+
+// A virtual method as declared in one class. vtableOffset is in bytes and only known for the method
+// that introduces a slot; overrides are matched to their slot by name and argument list.
+struct NativeVirtualMethod {
+    std::string_view name;
+    uint32_t argumentList;
+    std::optional<uint32_t> vtableOffset;
+    bool isPure;
+};
+
+struct NativeClass {
+    std::string_view name;
+    uint64_t size = 0;
+    std::vector<NativeBaseClass> bases;
+    std::vector<NativeVirtualMethod> virtualMethods;
+};
+
+// The TPI stream decoded straight from the MSF. Record offsets are indexed by type index on load and
+// complete (non forward reference) UDT definitions by name, so a struct lookup is one hash probe plus
+// a walk of its field list.
+class TypeStream {
+private:
+    std::vector<uint8_t> m_records;
+    std::vector<uint32_t> m_recordOffsets;
+    std::unordered_map<std::string_view, uint32_t> m_udtsByName;
+    uint32_t m_typeIndexBegin = 0;
+
+    bool ReadRecord(uint32_t typeIndex, uint16_t& kind, const uint8_t*& body, uint16_t& bodyLength) const noexcept;
+
+    template<typename Visitor>
+    bool VisitType(uint32_t typeIndex, Visitor& visitor) const;
+
+    template<typename Visitor>
+    bool VisitFieldList(uint32_t fieldList, Visitor& visitor) const;
+
+    uint32_t StripModifiers(uint32_t typeIndex) const;
+    std::string_view GetUdtName(uint32_t typeIndex) const;
+    uint32_t GetArgumentList(uint32_t functionType) const;
+    void AddVirtualMethod(std::string_view name, uint16_t attributes, uint32_t functionType, uint32_t vtableOffset,
+        NativeClass& cls) const;
+    void DescribeMemberType(NativeUdtMember& member) const;
+
+public:
+    explicit TypeStream(const MsfReader& msf);
+
+    size_t GetTypeCount() const noexcept { return m_recordOffsets.size(); }
+    uint32_t GetTypeIndexBegin() const noexcept { return m_typeIndexBegin; }
+
+    // The whole record of a type, length prefix and kind included, for copying it verbatim.
+    bool GetRecord(uint32_t typeIndex, const uint8_t*& record, size_t& size) const noexcept;
+
+    std::optional<uint32_t> FindUdt(std::string_view name) const;
+    std::vector<uint32_t> GetUdtTypeIndices() const;
+    uint64_t GetTypeSize(uint32_t typeIndex) const;
+    bool DecodeUdt(uint32_t typeIndex, NativeUdt& udt) const;
+    bool DecodeClass(uint32_t typeIndex, NativeClass& cls) const;
+};